@@ -13,10 +13,12 @@ uniform vec4 fogColor;
 in vec2 uv_tex;
 in vec2 uv_lightmap;
 in float vertexDistance;
+in vec3 dynamicLight;
 #else
 varying vec2 uv_tex;
 varying vec2 uv_lightmap;
 varying float vertexDistance;
+varying vec3 dynamicLight;
 #endif
 
 #if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
@@ -28,10 +30,13 @@ out vec4 FragColor;
 void main()
 {
 	#if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
-	vec4 fragColor = texture(tex, uv_tex) * texture(lightmap_tex, uv_lightmap);
+	vec4 fragColor = texture(tex, uv_tex);
+	vec4 light = texture(lightmap_tex, uv_lightmap);
 	#else
-	vec4 fragColor = texture2D(tex, uv_tex) * texture2D(lightmap_tex, uv_lightmap);
+	vec4 fragColor = texture2D(tex, uv_tex);
+	vec4 light = texture2D(lightmap_tex, uv_lightmap);
 	#endif
+	fragColor *= vec4(min(light.rgb + dynamicLight, 1.), light.a);
 	if (fogEnabled > 0)
 	{
 		// Calculate linear fog
@@ -7,6 +7,10 @@ uniform vec4 paramxlight;
 uniform vec4 paramylight;
 uniform mat4 lightTextureMatrix;
 
+#define MAX_DYNAMIC_LIGHTS 32 // Must match gfx_api::max_dynamic_lights
+uniform vec4 lightPositionRange[MAX_DYNAMIC_LIGHTS];
+uniform vec4 lightColour[MAX_DYNAMIC_LIGHTS];
+
 #if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
 in vec4 vertex;
 in vec2 vertexTexCoord;
@@ -19,10 +23,12 @@ attribute vec2 vertexTexCoord;
 out vec2 uv_tex;
 out vec2 uv_lightmap;
 out float vertexDistance;
+out vec3 dynamicLight;
 #else
 varying vec2 uv_tex;
 varying vec2 uv_lightmap;
 varying float vertexDistance;
+varying vec3 dynamicLight;
 #endif
 
 void main()
@@ -33,4 +39,16 @@ void main()
 	vec4 uv_lightmap_tmp = lightTextureMatrix * vec4(dot(paramxlight, vertex), dot(paramylight, vertex), 0.0, 1.0);
 	uv_lightmap = uv_lightmap_tmp.xy / uv_lightmap_tmp.w;
 	vertexDistance = position.z;
+
+	// Dynamic lights fade out linearly towards the end of their range, like the tile colours of the lightmap
+	dynamicLight = vec3(0.);
+	for (int i = 0; i < MAX_DYNAMIC_LIGHTS; ++i)
+	{
+		if (lightPositionRange[i].w <= 0.)
+		{
+			break;
+		}
+		float fraction = 1. - distance(vertex.xyz, lightPositionRange[i].xyz) / lightPositionRange[i].w;
+		dynamicLight += lightColour[i].rgb * max(fraction, 0.);
+	}
 }
@@ -14,11 +14,13 @@ in vec4 color;
 in vec2 uv1;
 in vec2 uv2;
 in float vertexDistance;
+in vec3 dynamicLight;
 #else
 varying vec4 color;
 varying vec2 uv1;
 varying vec2 uv2;
 varying float vertexDistance;
+varying vec3 dynamicLight;
 #endif
 
 #if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
@@ -30,10 +32,13 @@ out vec4 FragColor;
 void main()
 {
 	#if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
-	vec4 fragColor = color * texture(tex, uv1) * texture(lightmap_tex, uv2);
+	vec4 fragColor = color * texture(tex, uv1);
+	vec4 light = texture(lightmap_tex, uv2);
 	#else
-	vec4 fragColor = color * texture2D(tex, uv1) * texture2D(lightmap_tex, uv2);
+	vec4 fragColor = color * texture2D(tex, uv1);
+	vec4 light = texture2D(lightmap_tex, uv2);
 	#endif
+	fragColor *= vec4(min(light.rgb + dynamicLight, 1.), light.a);
 	if (fogEnabled > 0)
 	{
 		// Calculate linear fog
@@ -11,6 +11,10 @@ uniform vec4 paramy2;
 uniform mat4 textureMatrix1;
 uniform mat4 textureMatrix2;
 
+#define MAX_DYNAMIC_LIGHTS 32 // Must match gfx_api::max_dynamic_lights
+uniform vec4 lightPositionRange[MAX_DYNAMIC_LIGHTS];
+uniform vec4 lightColour[MAX_DYNAMIC_LIGHTS];
+
 #if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
 in vec4 vertex;
 in vec4 vertexColor;
@@ -24,11 +28,13 @@ out vec4 color;
 out vec2 uv1;
 out vec2 uv2;
 out float vertexDistance;
+out vec3 dynamicLight;
 #else
 varying vec4 color;
 varying vec2 uv1;
 varying vec2 uv2;
 varying float vertexDistance;
+varying vec3 dynamicLight;
 #endif
 
 void main()
@@ -41,4 +47,16 @@ void main()
 	vec4 uv2_tmp = textureMatrix2 * vec4(dot(paramx2, vertex), dot(paramy2, vertex), 0., 1.);
 	uv2 = uv2_tmp.xy / uv2_tmp.w;
 	vertexDistance = position.z;
+
+	// Dynamic lights fade out linearly towards the end of their range, like the tile colours of the lightmap
+	dynamicLight = vec3(0.);
+	for (int i = 0; i < MAX_DYNAMIC_LIGHTS; ++i)
+	{
+		if (lightPositionRange[i].w <= 0.)
+		{
+			break;
+		}
+		float fraction = 1. - distance(vertex.xyz, lightPositionRange[i].xyz) / lightPositionRange[i].w;
+		dynamicLight += lightColour[i].rgb * max(fraction, 0.);
+	}
 }
@@ -1,5 +1,7 @@
 #version 450
 
+#define MAX_DYNAMIC_LIGHTS 32 // Must match gfx_api::max_dynamic_lights
+
 layout(set = 1, binding = 0) uniform sampler2D tex;
 layout(set = 1, binding = 1) uniform sampler2D lightmap_tex;
 
@@ -8,6 +10,8 @@ layout(std140, set = 0, binding = 0) uniform cbuffer {
 	vec4 paramxlight;
 	vec4 paramylight;
 	mat4 lightTextureMatrix;
+	vec4 lightPositionRange[MAX_DYNAMIC_LIGHTS];
+	vec4 lightColour[MAX_DYNAMIC_LIGHTS];
 	vec4 fogColor;
 	int fogEnabled; // whether fog is enabled
 	float fogEnd;
@@ -17,12 +21,14 @@ layout(std140, set = 0, binding = 0) uniform cbuffer {
 layout(location = 0) in vec2 uv_tex;
 layout(location = 1) in vec2 uv_lightmap;
 layout(location = 2) in float vertexDistance;
+layout(location = 3) in vec3 dynamicLight;
 
 layout(location = 0) out vec4 FragColor;
 
 void main()
 {
-	vec4 fragColor = texture(tex, uv_tex) * texture(lightmap_tex, uv_lightmap);
+	vec4 light = texture(lightmap_tex, uv_lightmap);
+	vec4 fragColor = texture(tex, uv_tex) * vec4(min(light.rgb + dynamicLight, 1.), light.a);
 	if (fogEnabled > 0)
 	{
 		// Calculate linear fog
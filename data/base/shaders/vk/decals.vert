@@ -1,10 +1,14 @@
 #version 450
 
+#define MAX_DYNAMIC_LIGHTS 32 // Must match gfx_api::max_dynamic_lights
+
 layout(std140, set = 0, binding = 0) uniform cbuffer {
 	mat4 ModelViewProjectionMatrix;
 	vec4 paramxlight;
 	vec4 paramylight;
 	mat4 lightTextureMatrix;
+	vec4 lightPositionRange[MAX_DYNAMIC_LIGHTS];
+	vec4 lightColour[MAX_DYNAMIC_LIGHTS];
 	vec4 fogColor;
 	int fogEnabled; // whether fog is enabled
 	float fogEnd;
@@ -17,6 +21,7 @@ layout(location = 1) in vec2 vertexTexCoord;
 layout(location = 0) out vec2 uv_tex;
 layout(location = 1) out vec2 uv_lightmap;
 layout(location = 2) out float vertexDistance;
+layout(location = 3) out vec3 dynamicLight;
 
 void main()
 {
@@ -26,6 +31,18 @@ void main()
 	vec4 uv_lightmap_tmp = lightTextureMatrix * vec4(dot(paramxlight, vertex), dot(paramylight, vertex), 0.0, 1.0);
 	uv_lightmap = uv_lightmap_tmp.xy / uv_lightmap_tmp.w;
 	vertexDistance = position.z;
+
+	// Dynamic lights fade out linearly towards the end of their range, like the tile colours of the lightmap
+	dynamicLight = vec3(0.);
+	for (int i = 0; i < MAX_DYNAMIC_LIGHTS; ++i)
+	{
+		if (lightPositionRange[i].w <= 0.)
+		{
+			break;
+		}
+		float fraction = 1. - distance(vertex.xyz, lightPositionRange[i].xyz) / lightPositionRange[i].w;
+		dynamicLight += lightColour[i].rgb * max(fraction, 0.);
+	}
 	gl_Position.y *= -1.;
 	gl_Position.z = (gl_Position.z + gl_Position.w) / 2.0;
 }
@@ -1,5 +1,7 @@
 #version 450
 
+#define MAX_DYNAMIC_LIGHTS 32 // Must match gfx_api::max_dynamic_lights
+
 layout(set = 1, binding = 0) uniform sampler2D tex;
 layout(set = 1, binding = 1) uniform sampler2D lightmap_tex;
 
@@ -11,6 +13,8 @@ layout(std140, set = 0, binding = 0) uniform cbuffer {
 	vec4 paramy2;
 	mat4 textureMatrix1;
 	mat4 textureMatrix2;
+	vec4 lightPositionRange[MAX_DYNAMIC_LIGHTS];
+	vec4 lightColour[MAX_DYNAMIC_LIGHTS];
 	vec4 fogColor;
 	int fogEnabled; // whether fog is enabled
 	float fogEnd;
@@ -21,12 +25,14 @@ layout(location = 0) in vec4 color;
 layout(location = 1) in vec2 uv1;
 layout(location = 2) in vec2 uv2;
 layout(location = 3) in float vertexDistance;
+layout(location = 4) in vec3 dynamicLight;
 
 layout(location = 0) out vec4 FragColor;
 
 void main()
 {
-	vec4 fragColor = color * texture(tex, uv1) * texture(lightmap_tex, uv2);
+	vec4 light = texture(lightmap_tex, uv2);
+	vec4 fragColor = color * texture(tex, uv1) * vec4(min(light.rgb + dynamicLight, 1.), light.a);
 	if (fogEnabled > 0)
 	{
 		// Calculate linear fog
@@ -1,5 +1,7 @@
 #version 450
 
+#define MAX_DYNAMIC_LIGHTS 32 // Must match gfx_api::max_dynamic_lights
+
 layout(std140, set = 0, binding = 0) uniform cbuffer {
 	mat4 ModelViewProjectionMatrix;
 	vec4 paramx1;
@@ -8,6 +10,8 @@ layout(std140, set = 0, binding = 0) uniform cbuffer {
 	vec4 paramy2;
 	mat4 textureMatrix1;
 	mat4 textureMatrix2;
+	vec4 lightPositionRange[MAX_DYNAMIC_LIGHTS];
+	vec4 lightColour[MAX_DYNAMIC_LIGHTS];
 	vec4 fogColor;
 	int fogEnabled; // whether fog is enabled
 	float fogEnd;
@@ -21,6 +25,7 @@ layout(location = 0) out vec4 color;
 layout(location = 1) out vec2 uv1;
 layout(location = 2) out vec2 uv2;
 layout(location = 3) out float vertexDistance;
+layout(location = 4) out vec3 dynamicLight;
 
 void main()
 {
@@ -32,6 +37,18 @@ void main()
 	vec4 uv2_tmp = textureMatrix2 * vec4(dot(paramx2, vertex), dot(paramy2, vertex), 0., 1.);
 	uv2 = uv2_tmp.xy / uv2_tmp.w;
 	vertexDistance = position.z;
+
+	// Dynamic lights fade out linearly towards the end of their range, like the tile colours of the lightmap
+	dynamicLight = vec3(0.);
+	for (int i = 0; i < MAX_DYNAMIC_LIGHTS; ++i)
+	{
+		if (lightPositionRange[i].w <= 0.)
+		{
+			break;
+		}
+		float fraction = 1. - distance(vertex.xyz, lightPositionRange[i].xyz) / lightPositionRange[i].w;
+		dynamicLight += lightColour[i].rgb * max(fraction, 0.);
+	}
 	gl_Position.y *= -1.;
 	gl_Position.z = (gl_Position.z + gl_Position.w) / 2.0;
 }
@@ -159,6 +159,9 @@ void dbgDumpHeader(DumpFileHandle file)
 
 void dbgDumpLog(DumpFileHandle file)
 {
+	// Warnings may still be waiting for the debug writer thread
+	debugFlush();
+
 	// Write all messages to the given file
 	wzMutexLock(dbgMessagesMutex);
 	for (auto const &msg : dbgMessages)
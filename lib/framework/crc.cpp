@@ -113,6 +113,31 @@ Sha256 sha256Sum(void const *data, size_t dataLen)
 	return ret;
 }
 
+struct Sha256Stream::State
+{
+	crypto_hash_sha256_state state;
+};
+
+Sha256Stream::Sha256Stream() : state(new State)
+{
+	crypto_hash_sha256_init(&state->state);
+}
+
+Sha256Stream::~Sha256Stream()
+{}
+
+void Sha256Stream::update(void const *data, size_t dataLen)
+{
+	crypto_hash_sha256_update(&state->state, (const unsigned char *)data, dataLen);
+}
+
+Sha256 Sha256Stream::finalise()
+{
+	Sha256 ret;
+	crypto_hash_sha256_final(&state->state, ret.bytes);
+	return ret;
+}
+
 bool Sha256::operator ==(Sha256 const &b) const
 {
 	return memcmp(bytes, b.bytes, Bytes) == 0;
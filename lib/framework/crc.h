@@ -24,6 +24,7 @@
 #include "vector.h"
 #include <vector>
 #include <string>
+#include <memory>
 
 uint32_t crcSum(uint32_t crc, const void *data, size_t dataLen);
 uint32_t crcSumU16(uint32_t crc, const uint16_t *data, size_t dataLen);
@@ -45,6 +46,21 @@ struct Sha256
 };
 Sha256 sha256Sum(void const *data, size_t dataLen);
 
+/// Calculates the same hash as sha256Sum, over data that is given in pieces, such as a file read in chunks.
+class Sha256Stream
+{
+public:
+	Sha256Stream();
+	~Sha256Stream();
+
+	void update(void const *data, size_t dataLen);
+	Sha256 finalise();
+
+private:
+	struct State;
+	std::unique_ptr<State> state;
+};
+
 class EcKey
 {
 public:
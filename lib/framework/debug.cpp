@@ -32,8 +32,10 @@
 #include <time.h>
 #include "string_ext.h"
 #include "wzapp.h"
-#include <map>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 
 #if defined(WZ_OS_LINUX) && defined(__GLIBC__)
 #include <execinfo.h>  // Nonfatal runtime backtraces.
@@ -54,6 +56,7 @@
 #endif
 
 #define MAX_LEN_LOG_LINE 512
+#define MAX_QUEUED_LOG_LINES 4096  ///< When the writer thread falls this far behind, the logging thread writes the lines itself
 
 char last_called_script_event[MAX_EVENT_NAME_LEN];
 UDWORD traceID = -1;
@@ -110,11 +113,58 @@ static const char *code_part_names[] =
 	"last"
 };
 
-static char inputBuffer[2][MAX_LEN_LOG_LINE];
-static bool useInputBuffer1 = false;
 static bool debug_flush_stderr = false;
 
-static std::map<std::string, int> warning_list;	// only used for LOG_WARNING
+/// Lines are formatted by the thread logging them, and handed to the debug callbacks by a writer thread.
+struct DebugState
+{
+	wz::mutex mutex;                          ///< Guards everything below.
+	bool writing = false;                     ///< Set while a thread is calling the callbacks or changing callbackRegistry, see lockCallbacks().
+	std::deque<std::string> queue;            ///< Lines waiting for the writer thread.
+	WZ_THREAD *writerThread = nullptr;
+	WZ_SEMAPHORE *writerSemaphore = nullptr;  ///< Posted when lines are added to an empty queue.
+	bool writerEnabled = false;               ///< Set between debug_init() and debug_exit().
+	bool writerQuit = false;
+	std::unordered_set<uint64_t> warnings;    ///< Hashes of the warnings already printed, see hashWarning().
+	std::string lastLine;                     ///< For detecting repeated lines.
+	unsigned repeated = 0;                    ///< Times the last line was repeated
+	unsigned next = 2;                        ///< Next total to print update
+	unsigned prev = 0;                        ///< Total on last update
+	std::string lastError;                    ///< See debugLastError().
+	bool errorWaiting = false;
+};
+
+/// Created on first use and never destroyed, since anything may log during static initialisation or shutdown.
+static DebugState &debugState()
+{
+	static DebugState *state = new DebugState;
+	return *state;
+}
+
+/// Waits until no other thread is using the callbacks, and keeps them from doing so until unlockCallbacks().
+/// The callbacks are called without holding any mutex, so that they may log themselves. Such lines are queued.
+static void lockCallbacks()
+{
+	DebugState &state = debugState();
+	while (true)
+	{
+		{
+			std::lock_guard<wz::mutex> lock(state.mutex);
+			if (!state.writing)
+			{
+				state.writing = true;
+				return;
+			}
+		}
+		wzYieldCurrentThread();
+	}
+}
+
+static void unlockCallbacks()
+{
+	std::lock_guard<wz::mutex> lock(debugState().mutex);
+	debugState().writing = false;
+}
 
 /**
  * Convert code_part names to enum. Case insensitive.
@@ -325,16 +375,41 @@ void debug_init()
 	enabled_debug[LOG_INFO] = true;
 	enabled_debug[LOG_FATAL] = true;
 	enabled_debug[LOG_POPUP] = true;
-	inputBuffer[0][0] = '\0';
-	inputBuffer[1][0] = '\0';
+	{
+		DebugState &state = debugState();
+		std::lock_guard<wz::mutex> lock(state.mutex);
+		state.writerEnabled = true;
+		state.writerQuit = false;
+	}
 #ifdef DEBUG
 	enabled_debug[LOG_WARNING] = true;
 #endif
 }
 
 
+static void debugFlushQueue(bool wait = false);
+
 void debug_exit()
 {
+	DebugState &state = debugState();
+	WZ_THREAD *writerThread;
+	{
+		std::lock_guard<wz::mutex> lock(state.mutex);
+		state.writerEnabled = false;
+		state.writerQuit = true;
+		writerThread = state.writerThread;
+		state.writerThread = nullptr;
+	}
+	if (writerThread != nullptr)
+	{
+		wzSemaphorePost(state.writerSemaphore);
+		wzThreadJoin(writerThread);
+		wzSemaphoreDestroy(state.writerSemaphore);
+		state.writerSemaphore = nullptr;
+	}
+	debugFlushQueue(true);
+
+	lockCallbacks();
 	debug_callback *curCallback = callbackRegistry, * tmpCallback = nullptr;
 
 	while (curCallback)
@@ -347,16 +422,18 @@ void debug_exit()
 		free(curCallback);
 		curCallback = tmpCallback;
 	}
-	warning_list.clear();
 	callbackRegistry = nullptr;
+
+	std::lock_guard<wz::mutex> lock(state.mutex);
+	state.writing = false;
+	state.queue.clear();  // Nothing left to write these to.
+	state.warnings.clear();
 }
 
 
 void debug_register_callback(debug_callback_fn callback, debug_callback_init init, debug_callback_exit exit, void *data)
 {
-	debug_callback *curCallback = callbackRegistry, * tmpCallback = nullptr;
-
-	tmpCallback = (debug_callback *)malloc(sizeof(*tmpCallback));
+	debug_callback *tmpCallback = (debug_callback *)malloc(sizeof(*tmpCallback));
 
 	tmpCallback->next = nullptr;
 	tmpCallback->callback = callback;
@@ -364,6 +441,7 @@ void debug_register_callback(debug_callback_fn callback, debug_callback_init ini
 	tmpCallback->exit = exit;
 	tmpCallback->data = data;
 
+	// Not registered yet, so this may log.
 	if (tmpCallback->init
 	    && !tmpCallback->init(&tmpCallback->data))
 	{
@@ -372,18 +450,23 @@ void debug_register_callback(debug_callback_fn callback, debug_callback_init ini
 		return;
 	}
 
+	lockCallbacks();
+	debug_callback *curCallback = callbackRegistry;
 	if (!curCallback)
 	{
 		callbackRegistry = tmpCallback;
-		return;
 	}
-
-	while (curCallback->next)
+	else
 	{
-		curCallback = curCallback->next;
-	}
+		while (curCallback->next)
+		{
+			curCallback = curCallback->next;
+		}
 
-	curCallback->next = tmpCallback;
+		curCallback->next = tmpCallback;
+	}
+	unlockCallbacks();
+	debugFlushQueue();  // Anything logged meanwhile
 }
 
 
@@ -417,6 +500,120 @@ static void printToDebugCallbacks(const char *const str)
 	}
 }
 
+/// Set while this thread is calling the debug callbacks, so that lines they log are left to the loop calling them.
+static WZ_DECL_THREAD bool callingDebugCallbacks = false;
+
+/// Hands all queued lines to the debug callbacks, on the calling thread. If another thread is already
+/// writing them, that thread writes the new lines instead, unless wait is set. Then this waits for it,
+/// and returns once all lines queued so far were written. Lines logged by a callback are always
+/// written by the loop calling it.
+static void debugFlushQueue(bool wait)
+{
+	DebugState &state = debugState();
+	std::deque<std::string> lines;
+	while (true)
+	{
+		{
+			std::lock_guard<wz::mutex> lock(state.mutex);
+			if (lines.empty() && state.writing)
+			{
+				if (!wait || callingDebugCallbacks)
+				{
+					return;
+				}
+			}
+			else if (state.queue.empty())
+			{
+				state.writing = false;
+				return;
+			}
+			else
+			{
+				state.writing = true;
+				lines.swap(state.queue);
+			}
+		}
+		if (lines.empty())
+		{
+			wzYieldCurrentThread();  // Another thread is writing, and will be done soon.
+			continue;
+		}
+		callingDebugCallbacks = true;
+		for (std::string const &line : lines)
+		{
+			printToDebugCallbacks(line.c_str());
+		}
+		callingDebugCallbacks = false;
+		lines.clear();
+	}
+}
+
+void debugFlush()
+{
+	debugFlushQueue(true);
+}
+
+static int debugWriterThreadFunc(void *)
+{
+	DebugState &state = debugState();
+	while (true)
+	{
+		wzSemaphoreWait(state.writerSemaphore);
+		debugFlushQueue();
+		std::lock_guard<wz::mutex> lock(state.mutex);
+		if (state.writerQuit)
+		{
+			return 0;
+		}
+	}
+}
+
+/// Adds a line for the debug callbacks. Must be called with debugState().mutex locked.
+/// Returns true if the caller should write the queued lines itself, by calling debugFlushQueue() after unlocking.
+static bool debugQueueLine(std::string line)
+{
+	DebugState &state = debugState();
+	bool wasEmpty = state.queue.empty();
+	state.queue.push_back(std::move(line));
+	if (!state.writerEnabled || state.queue.size() >= MAX_QUEUED_LOG_LINES)
+	{
+		return true;
+	}
+	if (state.writerThread == nullptr)
+	{
+		state.writerSemaphore = wzSemaphoreCreate(0);
+		state.writerThread = wzThreadCreate(debugWriterThreadFunc, nullptr);
+		if (state.writerThread == nullptr)
+		{
+			wzSemaphoreDestroy(state.writerSemaphore);
+			state.writerSemaphore = nullptr;
+			state.writerEnabled = false;  // Can't write in the background, so don't try again.
+			return true;
+		}
+		wzThreadStart(state.writerThread);
+	}
+	else if (!wasEmpty)
+	{
+		return false;  // The writer thread has already been woken up.
+	}
+	wzSemaphorePost(state.writerSemaphore);
+	return false;
+}
+
+/// FNV-1a hash of the function name and message, for suppressing repeated warnings without keeping their text.
+static uint64_t hashWarning(const char *function, const char *message)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char *str : {function, "-", message})
+	{
+		for (; *str != '\0'; ++str)
+		{
+			hash = (hash ^ (unsigned char)*str) * 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
 void _realObjTrace(int id, const char *function, const char *str, ...)
 {
 	char vaBuffer[MAX_LEN_LOG_LINE];
@@ -428,19 +625,26 @@ void _realObjTrace(int id, const char *function, const char *str, ...)
 	va_end(ap);
 
 	ssprintf(outputBuffer, "[%6d]: [%s] %s", id, function, vaBuffer);
-	printToDebugCallbacks(outputBuffer);
+	bool flush;
+	{
+		std::lock_guard<wz::mutex> lock(debugState().mutex);
+		flush = debugQueueLine(outputBuffer);
+	}
+	if (flush)
+	{
+		debugFlushQueue();
+	}
 }
 
-// Thread local to prevent a race condition on read and write to this buffer if multiple
-// threads log errors. This means we will not be reporting any errors to console from threads
-// other than main. If we want to fix this, make sure accesses are protected by a mutex.
-static WZ_DECL_THREAD char errorStore[512];
-static WZ_DECL_THREAD bool errorWaiting = false;
 const char *debugLastError()
 {
-	if (errorWaiting)
+	static char errorStore[512];  // Only the main thread shows errors.
+	DebugState &state = debugState();
+	std::lock_guard<wz::mutex> lock(state.mutex);
+	if (state.errorWaiting)
 	{
-		errorWaiting = false;
+		state.errorWaiting = false;
+		sstrcpy(errorStore, state.lastError.c_str());
 		return errorStore;
 	}
 	else
@@ -452,93 +656,110 @@ const char *debugLastError()
 void _debug(int line, code_part part, const char *function, const char *str, ...)
 {
 	va_list ap;
-	static char outputBuffer[MAX_LEN_LOG_LINE];
-	static unsigned int repeated = 0; /* times current message repeated */
-	static unsigned int next = 2;     /* next total to print update */
-	static unsigned int prev = 0;     /* total on last update */
+	char outputBuffer[MAX_LEN_LOG_LINE];
+	char inputBuffer[MAX_LEN_LOG_LINE];
 
 	va_start(ap, str);
 	vssprintf(outputBuffer, str, ap);
 	va_end(ap);
 
+	DebugState &state = debugState();
 	if (part == LOG_WARNING)
 	{
-		std::pair<std::map<std::string, int>::iterator, bool> ret;
-		ret = warning_list.insert(std::pair<std::string, int>(std::string(function) + "-" + std::string(outputBuffer), line));
-		if (ret.second)
 		{
-			ssprintf(inputBuffer[useInputBuffer1 ? 1 : 0], "[%s:%d] %s (**Further warnings of this type are suppressed.)", function, line, outputBuffer);
-		}
-		else
-		{
-			return;	// don't bother adding any more
+			std::lock_guard<wz::mutex> lock(state.mutex);
+			if (!state.warnings.insert(hashWarning(function, outputBuffer)).second)
+			{
+				return;	// don't bother adding any more
+			}
 		}
+		ssprintf(inputBuffer, "[%s:%d] %s (**Further warnings of this type are suppressed.)", function, line, outputBuffer);
 	}
 	else
 	{
-		ssprintf(inputBuffer[useInputBuffer1 ? 1 : 0], "[%s:%d] %s", function, line, outputBuffer);
+		ssprintf(inputBuffer, "[%s:%d] %s", function, line, outputBuffer);
 	}
 
-	if (sstrcmp(inputBuffer[0], inputBuffer[1]) == 0)
+	time_t rawtime;
+	struct tm timeinfo = {};
+	char ourtime[15];		//HH:MM:SS
+
+	time(&rawtime);
+	timeinfo = getLocalTime(rawtime);
+	strftime(ourtime, 15, "%H:%M:%S", &timeinfo);
+
+	bool repeated;
+	bool flush = false;
 	{
-		// Received again the same line
-		repeated++;
-		if (repeated == next)
+		std::lock_guard<wz::mutex> lock(state.mutex);
+		if (state.lastLine == inputBuffer)
 		{
-			if (repeated > 2)
-			{
-				ssprintf(outputBuffer, "last message repeated %u times (total %u repeats)", repeated - prev, repeated);
-			}
-			else
+			// Received again the same line
+			state.repeated++;
+			if (state.repeated == state.next)
 			{
-				ssprintf(outputBuffer, "last message repeated %u times", repeated - prev);
+				if (state.repeated > 2)
+				{
+					ssprintf(outputBuffer, "last message repeated %u times (total %u repeats)", state.repeated - state.prev, state.repeated);
+				}
+				else
+				{
+					ssprintf(outputBuffer, "last message repeated %u times", state.repeated - state.prev);
+				}
+				flush = debugQueueLine(outputBuffer) || flush;
+				state.prev = state.repeated;
+				state.next *= 2;
 			}
-			printToDebugCallbacks(outputBuffer);
-			prev = repeated;
-			next *= 2;
 		}
-	}
-	else
-	{
-		// Received another line, cleanup the old
-		if (repeated > 0 && repeated != prev && repeated != 1)
+		else
 		{
-			/* just repeat the previous message when only one repeat occurred */
-			if (repeated > 2)
-			{
-				ssprintf(outputBuffer, "last message repeated %u times (total %u repeats)", repeated - prev, repeated);
-			}
-			else
+			// Received another line, cleanup the old
+			if (state.repeated > 0 && state.repeated != state.prev && state.repeated != 1)
 			{
-				ssprintf(outputBuffer, "last message repeated %u times", repeated - prev);
+				/* just repeat the previous message when only one repeat occurred */
+				if (state.repeated > 2)
+				{
+					ssprintf(outputBuffer, "last message repeated %u times (total %u repeats)", state.repeated - state.prev, state.repeated);
+				}
+				else
+				{
+					ssprintf(outputBuffer, "last message repeated %u times", state.repeated - state.prev);
+				}
+				flush = debugQueueLine(outputBuffer) || flush;
 			}
-			printToDebugCallbacks(outputBuffer);
+			state.repeated = 0;
+			state.next = 2;
+			state.prev = 0;
+			state.lastLine = inputBuffer;
+		}
+		repeated = state.repeated != 0;
+
+		if (!repeated)
+		{
+			// Assemble the outputBuffer:
+			ssprintf(outputBuffer, "%-8s|%s: %s", code_part_names[part], ourtime, inputBuffer);
+			flush = debugQueueLine(outputBuffer) || flush;
 		}
-		repeated = 0;
-		next = 2;
-		prev = 0;
 	}
 
-	if (!repeated)
+	// Only the verbose parts are written in the background. Errors and such are written right away, so they are in the log before any crash.
+	if (!repeated && (part == LOG_INFO || part == LOG_ERROR || part == LOG_FATAL || part == LOG_POPUP))
 	{
-		time_t rawtime;
-		struct tm timeinfo = {};
-		char ourtime[15];		//HH:MM:SS
-
-		time(&rawtime);
-		timeinfo = getLocalTime(rawtime);
-		strftime(ourtime, 15, "%H:%M:%S", &timeinfo);
-
-		// Assemble the outputBuffer:
-		ssprintf(outputBuffer, "%-8s|%s: %s", code_part_names[part], ourtime, useInputBuffer1 ? inputBuffer[1] : inputBuffer[0]);
-
-		printToDebugCallbacks(outputBuffer);
+		debugFlushQueue(true);
+	}
+	else if (flush)
+	{
+		debugFlushQueue();
+	}
 
+	if (!repeated)
+	{
 		if (part == LOG_ERROR)
 		{
 			// used to signal user that there was a error condition, and to check the logs.
-			sstrcpy(errorStore, useInputBuffer1 ? inputBuffer[1] : inputBuffer[0]);
-			errorWaiting = true;
+			std::lock_guard<wz::mutex> lock(state.mutex);
+			state.lastError = inputBuffer;
+			state.errorWaiting = true;
 		}
 
 		// Throw up a dialog box for users since most don't have a clue to check the dump file for information. Use for (duh) Fatal errors, that force us to terminate the game.
@@ -551,11 +772,11 @@ void _debug(int line, code_part part, const char *function, const char *str, ...
 #if defined(WZ_OS_WIN)
 			char wbuf[1024];
 			ssprintf(wbuf, "%s\n\nPlease check the file (%s) in your configuration directory for more details. \
-				\nDo not forget to upload the %s file, WZdebuginfo.txt and the warzone2100.rpt files in your bug reports at https://github.com/Warzone2100/warzone2100/issues/new!", useInputBuffer1 ? inputBuffer[1] : inputBuffer[0], WZ_DBGFile, WZ_DBGFile);
+				\nDo not forget to upload the %s file, WZdebuginfo.txt and the warzone2100.rpt files in your bug reports at https://github.com/Warzone2100/warzone2100/issues/new!", inputBuffer, WZ_DBGFile, WZ_DBGFile);
 			wzDisplayDialog(Dialog_Error, "Warzone has terminated unexpectedly", wbuf);
 #elif defined(WZ_OS_MAC)
 			char wbuf[1024];
-			ssprintf(wbuf, "%s\n\nPlease check your logs and attach them along with a bug report. Thanks!", useInputBuffer1 ? inputBuffer[1] : inputBuffer[0]);
+			ssprintf(wbuf, "%s\n\nPlease check your logs and attach them along with a bug report. Thanks!", inputBuffer);
 			int clickedIndex = \
 			                   cocoaShowAlert("Warzone has quit unexpectedly.",
 			                                  wbuf,
@@ -586,7 +807,7 @@ void _debug(int line, code_part part, const char *function, const char *str, ...
 				cocoaOpenUserCrashReportFolder();
 			}
 #else
-			const char *popupBuf = useInputBuffer1 ? inputBuffer[1] : inputBuffer[0];
+			const char *popupBuf = inputBuffer;
 			wzDisplayDialog(Dialog_Error, "Warzone has terminated unexpectedly", popupBuf);
 #endif
 		}
@@ -595,11 +816,9 @@ void _debug(int line, code_part part, const char *function, const char *str, ...
 		// This is a popup dialog used for times when the error isn't fatal, but we still need to notify user what is going on.
 		if (part == LOG_POPUP)
 		{
-			wzDisplayDialog(Dialog_Information, "Warzone has detected a problem.", inputBuffer[useInputBuffer1 ? 1 : 0]);
+			wzDisplayDialog(Dialog_Information, "Warzone has detected a problem.", inputBuffer);
 		}
-
 	}
-	useInputBuffer1 = !useInputBuffer1; // Swap buffers
 }
 
 void _debugBacktrace(code_part part)
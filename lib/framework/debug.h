@@ -231,6 +231,10 @@ void debugFlushStderr();
 /// Return the last set error message, or NULL is none set since last time we were called.
 const char *debugLastError();
 
+/// Write any lines still queued for the background writer thread right away, e.g. before crashing.
+/// Returns once they were written, even if another thread was writing them.
+void debugFlush();
+
 /**
  * Register a callback to be called on every call to debug()
  *
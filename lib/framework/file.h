@@ -41,6 +41,13 @@ WZ_DECL_NONNULL(1, 2) bool loadFileToBuffer(const char *pFileName, char *pFileBu
 /** Load a file from disk, but returns quietly if no file found. */
 WZ_DECL_NONNULL(1, 2) bool loadFileToBufferNoError(const char *pFileName, char *pFileBuffer, UDWORD bufferSize, UDWORD *pSize);
 
+/** Hash of the file, from the file hash cache if the file is unchanged since it was last hashed. Thread-safe. */
 WZ_DECL_NONNULL(1) Sha256 findHashOfFile(char const *realFileName);
 
+/** Hashes of several files, which are read in parallel if not cached. */
+std::vector<Sha256> findHashOfFiles(std::vector<std::string> const &realFileNames);
+
+/** Writes the file hash cache. */
+void fileHashShutdown();
+
 #endif // _file_h
@@ -0,0 +1,294 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2020  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/**
+ * @file filehash.cpp
+ *
+ * Hashes of (possibly large) files in the search path, such as mods and map archives.
+ *
+ * Hashes are remembered in a cache in the write directory, keyed by the real path, size and
+ * modification time of the file, so a file is only read again once it has changed. Files that
+ * do need to be read are hashed when first needed, several files at a time on worker threads
+ * which are joined before returning, so the search path can't change while they read.
+ */
+
+#include "frame.h"
+#include "file.h"
+#include "physfs_ext.h"
+#include "wzapp.h"
+
+#include <3rdparty/json/json.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define FILE_HASH_CACHE_FILE "filehashes.json"
+#define FILE_HASH_CACHE_VERSION 1
+#define FILE_HASH_READ_CHUNK (1024 * 1024)
+#define FILE_HASH_THREADS 4  ///< Hashing is mostly limited by reading the files, so more threads wouldn't help much
+
+struct CachedFileHash
+{
+	int64_t size;
+	int64_t modTime;
+	Sha256 hash;
+	bool used;      ///< Looked up since the game was started, only these are written back to the cache
+};
+
+static wz::mutex fileHashMutex;
+static std::unordered_map<std::string, CachedFileHash> fileHashCache;
+static bool fileHashCacheLoaded = false;
+static bool fileHashCacheChanged = false;
+
+/// Must be called with fileHashMutex locked.
+static void loadFileHashCache()
+{
+	if (fileHashCacheLoaded)
+	{
+		return;
+	}
+	fileHashCacheLoaded = true;
+	if (!PHYSFS_isInit() || PHYSFS_getWriteDir() == nullptr || !PHYSFS_exists(FILE_HASH_CACHE_FILE))
+	{
+		return;
+	}
+	PHYSFS_file *file = PHYSFS_openRead(FILE_HASH_CACHE_FILE);
+	if (file == nullptr)
+	{
+		return;
+	}
+	std::vector<char> data(std::max<PHYSFS_sint64>(PHYSFS_fileLength(file), 0));
+	bool ok = data.empty() || WZ_PHYSFS_readBytes(file, &data[0], data.size()) == (PHYSFS_sint64)data.size();
+	PHYSFS_close(file);
+	if (!ok)
+	{
+		debug(LOG_WARNING, "Could not read %s: %s", FILE_HASH_CACHE_FILE, WZ_PHYSFS_getLastError());
+		return;
+	}
+
+	nlohmann::json document;
+	try
+	{
+		document = nlohmann::json::parse(data.begin(), data.end());
+	}
+	catch (const std::exception &e)
+	{
+		debug(LOG_WARNING, "Ignoring invalid %s: %s", FILE_HASH_CACHE_FILE, e.what());
+		return;
+	}
+	if (!document.is_object() || document.value("version", 0) != FILE_HASH_CACHE_VERSION || !document["files"].is_object())
+	{
+		return;
+	}
+	for (auto it = document["files"].begin(); it != document["files"].end(); ++it)
+	{
+		nlohmann::json const &entry = it.value();
+		if (!entry.is_object() || !entry["sha256"].is_string())
+		{
+			continue;
+		}
+		CachedFileHash cached;
+		cached.size = entry.value("size", (int64_t)-1);
+		cached.modTime = entry.value("modTime", (int64_t)-1);
+		cached.hash.fromString(entry["sha256"].get<std::string>());
+		cached.used = false;
+		fileHashCache[it.key()] = cached;
+	}
+	debug(LOG_WZ, "Loaded %zu cached file hashes", fileHashCache.size());
+}
+
+/// Must be called with fileHashMutex locked.
+static void saveFileHashCache()
+{
+	if (!fileHashCacheChanged && std::all_of(fileHashCache.begin(), fileHashCache.end(), [](std::pair<const std::string, CachedFileHash> const &i) { return i.second.used; }))
+	{
+		return;  // Nothing to add or forget.
+	}
+	nlohmann::json files = nlohmann::json::object();
+	for (auto const &i : fileHashCache)
+	{
+		if (i.second.used)
+		{
+			files[i.first] = {{"size", i.second.size}, {"modTime", i.second.modTime}, {"sha256", i.second.hash.toString()}};
+		}
+	}
+	nlohmann::json document = {{"version", FILE_HASH_CACHE_VERSION}, {"files", std::move(files)}};
+	std::string data = document.dump(1, '\t');
+	saveFile(FILE_HASH_CACHE_FILE, data.c_str(), data.size());
+	fileHashCacheChanged = false;
+}
+
+/// Identifies the file (the archive or directory it is in, and its name), and gets its size and modification time.
+static bool statFile(char const *fileName, std::string *key, int64_t *size, int64_t *modTime)
+{
+	char const *realDir = PHYSFS_getRealDir(fileName);
+	if (realDir == nullptr)
+	{
+		return false;
+	}
+	PHYSFS_file *file = PHYSFS_openRead(fileName);
+	if (file == nullptr)
+	{
+		return false;
+	}
+	*size = PHYSFS_fileLength(file);
+	PHYSFS_close(file);
+	*modTime = WZ_PHYSFS_getLastModTime(fileName);
+	*key = std::string(realDir) + "|" + fileName;
+	return *size >= 0;
+}
+
+/// Reads the file in chunks, instead of loading all of it into memory at once.
+static bool hashFileContents(char const *fileName, Sha256 *hash)
+{
+	PHYSFS_file *file = PHYSFS_openRead(fileName);
+	if (file == nullptr)
+	{
+		debug(LOG_ERROR, "file %s could not be opened: %s", fileName, WZ_PHYSFS_getLastError());
+		return false;
+	}
+	Sha256Stream stream;
+	std::vector<char> buffer(FILE_HASH_READ_CHUNK);
+	PHYSFS_sint64 length;
+	while ((length = WZ_PHYSFS_readBytes(file, &buffer[0], buffer.size())) > 0)
+	{
+		stream.update(&buffer[0], length);
+	}
+	bool ok = length == 0 && PHYSFS_eof(file);
+	if (!ok)
+	{
+		debug(LOG_ERROR, "Reading %s failed: %s", fileName, WZ_PHYSFS_getLastError());
+	}
+	PHYSFS_close(file);
+	*hash = stream.finalise();
+	return ok;
+}
+
+/// Thread-safe, returns a zero hash if the file can't be read.
+static Sha256 hashFile(char const *fileName)
+{
+	Sha256 hash;
+	hash.setZero();
+
+	std::string key;
+	int64_t size, modTime;
+	if (!statFile(fileName, &key, &size, &modTime))
+	{
+		debug(LOG_ERROR, "file %s could not be opened: %s", fileName, WZ_PHYSFS_getLastError());
+		return hash;
+	}
+
+	{
+		std::lock_guard<wz::mutex> lock(fileHashMutex);
+		loadFileHashCache();
+		auto it = fileHashCache.find(key);
+		if (it != fileHashCache.end() && it->second.size == size && it->second.modTime == modTime)
+		{
+			it->second.used = true;
+			return it->second.hash;
+		}
+	}
+
+	if (!hashFileContents(fileName, &hash))
+	{
+		hash.setZero();
+		return hash;
+	}
+
+	std::lock_guard<wz::mutex> lock(fileHashMutex);
+	fileHashCache[key] = CachedFileHash{size, modTime, hash, true};
+	fileHashCacheChanged = true;
+	return hash;
+}
+
+Sha256 findHashOfFile(char const *realFileName)
+{
+	return hashFile(realFileName);
+}
+
+std::vector<Sha256> findHashOfFiles(std::vector<std::string> const &realFileNames)
+{
+	std::vector<Sha256> hashes(realFileNames.size());
+	if (realFileNames.size() <= 1)
+	{
+		for (size_t i = 0; i < realFileNames.size(); ++i)
+		{
+			hashes[i] = hashFile(realFileNames[i].c_str());
+		}
+		return hashes;
+	}
+
+	struct Job
+	{
+		std::vector<std::string> const *fileNames;
+		std::vector<Sha256> *hashes;
+		wz::mutex mutex;
+		size_t next;
+	} job;
+	job.fileNames = &realFileNames;
+	job.hashes = &hashes;
+	job.next = 0;
+	auto worker = [](void *data) -> int {
+		Job &job = *static_cast<Job *>(data);
+		while (true)
+		{
+			size_t i;
+			{
+				std::lock_guard<wz::mutex> lock(job.mutex);
+				if (job.next >= job.fileNames->size())
+				{
+					return 0;
+				}
+				i = job.next++;
+			}
+			(*job.hashes)[i] = hashFile((*job.fileNames)[i].c_str());
+		}
+	};
+
+	// The calling thread hashes files too, so that the work always gets done.
+	std::vector<WZ_THREAD *> threads;
+	unsigned numThreads = std::min<size_t>((size_t)FILE_HASH_THREADS, realFileNames.size()) - 1;
+	for (unsigned n = 0; n < numThreads; ++n)
+	{
+		WZ_THREAD *thread = wzThreadCreate(worker, &job);
+		if (thread == nullptr)
+		{
+			break;
+		}
+		wzThreadStart(thread);
+		threads.push_back(thread);
+	}
+	worker(&job);
+	for (WZ_THREAD *thread : threads)
+	{
+		wzThreadJoin(thread);
+	}
+	return hashes;
+}
+
+void fileHashShutdown()
+{
+	std::lock_guard<wz::mutex> lock(fileHashMutex);
+	if (fileHashCacheLoaded)
+	{
+		saveFileHashCache();
+	}
+}
@@ -126,6 +126,7 @@ void frameShutDown()
 	// Shutdown the resource stuff
 	debug(LOG_NEVER, "No more resources!");
 	resShutDown();
+	fileHashShutdown();
 }
 
 void setMouseWarp(bool value)
@@ -167,10 +168,15 @@ PHYSFS_file *openLoadFile(const char *fileName, bool hard_fail)
 ***************************************************************************/
 static bool loadFile2(const char *pFileName, char **ppFileData, UDWORD *pFileSize, bool AllocateMem, bool hard_fail)
 {
-	if (WZ_PHYSFS_isDirectory(pFileName))
+	if (WZ_PHYSFS_cachedIsDirectory(pFileName))
 	{
 		return false;
 	}
+	if (!hard_fail && !WZ_PHYSFS_cachedExists(pFileName))
+	{
+		debug(LOG_WZ, "optional file %s does not exist", pFileName);
+		return false;
+	}
 
 	PHYSFS_file *pfile = openLoadFile(pFileName, hard_fail);
 	if (!pfile)
@@ -242,6 +248,7 @@ static bool loadFile2(const char *pFileName, char **ppFileData, UDWORD *pFileSiz
 
 PHYSFS_file *openSaveFile(const char *fileName)
 {
+	WZ_PHYSFS_invalidatePathIndex();
 	PHYSFS_file *fileHandle = PHYSFS_openWrite(fileName);
 	if (!fileHandle)
 	{
@@ -320,21 +327,6 @@ bool loadFileToBufferNoError(const char *pFileName, char *pFileBuffer, UDWORD bu
 	return loadFile2(pFileName, &pFileBuffer, pSize, false, false);
 }
 
-Sha256 findHashOfFile(char const *realFileName)
-{
-	char *realFileData = nullptr;
-	uint32_t realFileSize = 0;
-	if (loadFile(realFileName, &realFileData, &realFileSize))
-	{
-		Sha256 realFileHash = sha256Sum(realFileData, realFileSize);
-		free(realFileData);
-		return realFileHash;
-	}
-	Sha256 zero;
-	zero.setZero();
-	return zero;
-}
-
 bool PHYSFS_printf(PHYSFS_file *file, const char *format, ...)
 {
 	char vaBuffer[PATH_MAX];
@@ -19,6 +19,19 @@
 
 #include "physfs_ext.h"
 #include "frame.h"
+#include "wzapp.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(WZ_OS_WIN)
+# include <windows.h>
+#else
+# include <sys/stat.h>
+#endif
 
 bool WZ_PHYSFS_enumerateFiles(const char *dir, const std::function<bool (char* file)>& enumFunc)
 {
@@ -38,3 +51,176 @@ bool WZ_PHYSFS_enumerateFiles(const char *dir, const std::function<bool (char* f
 	PHYSFS_freeList(files);
 	return true;
 }
+
+static wz::mutex pathIndexMutex;
+/// Names in each directory of the search path that has been looked in, listed on first use. Files are
+/// never removed from the read-only mounts while they are mounted, so a name that isn't listed doesn't
+/// exist outside of the write directory.
+static std::unordered_map<std::string, std::unordered_set<std::string>> pathIndex;
+static bool pathIndexValid = false;
+static std::string pathIndexWriteDir;  ///< Empty if the write directory isn't part of the search path
+
+static void resetPathIndex()
+{
+	pathIndex.clear();
+	pathIndexWriteDir.clear();
+	const char *writeDir = PHYSFS_getWriteDir();
+	if (writeDir != nullptr)
+	{
+		char **searchPath = PHYSFS_getSearchPath();
+		for (char **i = searchPath; searchPath != nullptr && *i != nullptr; ++i)
+		{
+			if (strcmp(*i, writeDir) == 0)
+			{
+				pathIndexWriteDir = writeDir;
+				break;
+			}
+		}
+		PHYSFS_freeList(searchPath);
+	}
+	pathIndexValid = true;
+}
+
+/// Returns the names in dir, or nullptr if it can't be listed.
+static const std::unordered_set<std::string> *listDirectory(const std::string &dir)
+{
+	auto it = pathIndex.find(dir);
+	if (it != pathIndex.end())
+	{
+		return &it->second;
+	}
+	char **files = PHYSFS_enumerateFiles(dir.c_str());
+	if (!files)
+	{
+		return nullptr;
+	}
+	std::unordered_set<std::string> &names = pathIndex[dir];
+	for (char **i = files; *i != nullptr; ++i)
+	{
+		names.insert(*i);
+	}
+	PHYSFS_freeList(files);
+	return &names;
+}
+
+/// Checks the write directory itself, without going through the rest of the search path
+static bool writeDirLookup(const std::string &path, bool *pIsDirectory)
+{
+	if (pathIndexWriteDir.empty())
+	{
+		return false;
+	}
+	std::string realPath = pathIndexWriteDir;
+	const char *separator = PHYSFS_getDirSeparator();
+	if (realPath.empty() || realPath.compare(realPath.size() - strlen(separator), std::string::npos, separator) != 0)
+	{
+		realPath += separator;
+	}
+	for (char c : path)
+	{
+		if (c == '/')
+		{
+			realPath += separator;
+		}
+		else
+		{
+			realPath += c;
+		}
+	}
+#if defined(WZ_OS_WIN)
+	int wstr_len = MultiByteToWideChar(CP_UTF8, 0, realPath.c_str(), -1, NULL, 0);
+	if (wstr_len <= 0)
+	{
+		return false;
+	}
+	std::vector<wchar_t> wstr_realPath(wstr_len, 0);
+	if (MultiByteToWideChar(CP_UTF8, 0, realPath.c_str(), -1, &wstr_realPath[0], wstr_len) == 0)
+	{
+		return false;
+	}
+	DWORD attributes = GetFileAttributesW(&wstr_realPath[0]);
+	if (attributes == INVALID_FILE_ATTRIBUTES)
+	{
+		return false;
+	}
+	*pIsDirectory = (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+	struct stat buf;
+	if (stat(realPath.c_str(), &buf) != 0)
+	{
+		return false;
+	}
+	*pIsDirectory = S_ISDIR(buf.st_mode);
+#endif
+	return true;
+}
+
+/// Returns 0 if path doesn't exist, 1 for a file, 2 for a directory, or -1 if PhysFS has to be asked
+static int cachedLookup(const char *path)
+{
+	// Leave anything that PhysFS would have to sanitise to PhysFS
+	while (*path == '/')
+	{
+		++path;
+	}
+	if (strstr(path, "//") != nullptr || strstr(path, "..") != nullptr || strchr(path, '\\') != nullptr || strchr(path, ':') != nullptr)
+	{
+		return -1;
+	}
+	std::string key(path);
+	while (!key.empty() && key.back() == '/')
+	{
+		key.pop_back();
+	}
+
+	std::lock_guard<wz::mutex> lock(pathIndexMutex);
+	if (!PHYSFS_isInit())
+	{
+		pathIndexValid = false;
+		return -1;
+	}
+	if (!pathIndexValid)
+	{
+		resetPathIndex();
+	}
+	bool isDirectory = false;
+	if (writeDirLookup(key, &isDirectory))  // The write directory comes first in the search path
+	{
+		return isDirectory ? 2 : 1;
+	}
+	if (key.empty())
+	{
+		return 2;
+	}
+	size_t separator = key.rfind('/');
+	const std::unordered_set<std::string> *names = listDirectory(separator == std::string::npos ? std::string() : key.substr(0, separator));
+	if (names == nullptr)
+	{
+		return -1;
+	}
+	if (names->count(separator == std::string::npos ? key : key.substr(separator + 1)) == 0)
+	{
+		return 0;
+	}
+	// Listed, but possibly only because it was in the write directory when the directory was listed
+	return -1;
+}
+
+bool WZ_PHYSFS_cachedExists(const char *path)
+{
+	int result = cachedLookup(path);
+	return result < 0 ? PHYSFS_exists(path) != 0 : result > 0;
+}
+
+bool WZ_PHYSFS_cachedIsDirectory(const char *path)
+{
+	int result = cachedLookup(path);
+	return result < 0 ? WZ_PHYSFS_isDirectory(path) != 0 : result == 2;
+}
+
+void WZ_PHYSFS_invalidatePathIndex()
+{
+	std::lock_guard<wz::mutex> lock(pathIndexMutex);
+	pathIndexValid = false;
+	pathIndex.clear();
+}
@@ -64,8 +64,24 @@ static inline PHYSFS_sint64 WZ_PHYSFS_writeBytes (PHYSFS_File * handle, const vo
 #endif
 }
 
+// Lookups through an index of the directories in the search path, each listed on first use. The write
+// directory is checked directly, and files missing from all mounted archives and directories are found
+// missing without asking each of them in turn. Files that do exist are still looked up through PhysFS.
+bool WZ_PHYSFS_cachedExists(const char *path);
+bool WZ_PHYSFS_cachedIsDirectory(const char *path);
+// Must be called whenever the search path or the write directory change, or files are written. The
+// wrappers below and openSaveFile() do this.
+void WZ_PHYSFS_invalidatePathIndex();
+
+static inline int WZ_PHYSFS_mount (const char * newDir, const char * mountPoint, int appendToPath)
+{
+	WZ_PHYSFS_invalidatePathIndex();
+	return PHYSFS_mount(newDir, mountPoint, appendToPath);
+}
+
 static inline int WZ_PHYSFS_unmount (const char * oldDir)
 {
+	WZ_PHYSFS_invalidatePathIndex();
 #if defined(WZ_PHYSFS_2_1_OR_GREATER)
 	return PHYSFS_unmount(oldDir);
 #else
@@ -74,6 +90,12 @@ static inline int WZ_PHYSFS_unmount (const char * oldDir)
 #endif
 }
 
+static inline int WZ_PHYSFS_setWriteDir (const char * newDir)
+{
+	WZ_PHYSFS_invalidatePathIndex();
+	return PHYSFS_setWriteDir(newDir);
+}
+
 #if defined(WZ_PHYSFS_2_1_OR_GREATER)
 	#define WZ_PHYSFS_getLastError() \
 		PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode())
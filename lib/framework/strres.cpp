@@ -32,66 +32,62 @@
 
 #include "types.h"
 #include "debug.h"
-#include "treap.h"
 #include "strres.h"
 #include "strresly.h"
 #include "physfs_ext.h"
 
+#include <string>
+#include <unordered_map>
+
+#define STRRES_AVERAGE_ENTRY_SIZE 64  ///< Rough size of a line like: ID  _("Some string")
+
 /* A String Resource */
 struct STR_RES
 {
-	struct TREAP_NODE     **psIDTreap;              ///< The treap to store string identifiers
+	/// The strings, by identifier. Nodes don't move when the table grows, so returned pointers stay valid.
+	std::unordered_map<std::string, std::string> strings;
+	/// The identifier of each string. Where several identifiers have the same string, the (strcmp) smallest one.
+	std::unordered_map<std::string, const char *> ids;
 };
 
 /* Initialise the string system */
 STR_RES *strresCreate()
 {
-	STR_RES *const psRes = (STR_RES *)malloc(sizeof(*psRes));
-	if (!psRes)
-	{
-		debug(LOG_FATAL, "Out of memory");
-		abort();
-		return nullptr;
-	}
-
-	psRes->psIDTreap = treapCreate();
-	if (!psRes->psIDTreap)
-	{
-		debug(LOG_FATAL, "Out of memory");
-		abort();
-		free(psRes);
-		return nullptr;
-	}
-
-	return psRes;
+	return new STR_RES;
 }
 
 /* Shutdown the string system */
 void strresDestroy(STR_RES *psRes)
 {
-	// Release the treap and free the final memory
-	treapDestroy(psRes->psIDTreap);
-	free(psRes);
+	delete psRes;
 }
 
 
 /* Store a string */
 bool strresStoreString(STR_RES *psRes, const char *pID, const char *pString)
 {
+	auto stored = psRes->strings.emplace(pID, pString);
 	// Make sure that this ID string hasn't been used before
-	if (treapFind(psRes->psIDTreap, pID) != nullptr)
+	if (!stored.second)
 	{
 		debug(LOG_FATAL, "Duplicate string for id: \"%s\"", pID);
 		abort();
 		return false;
 	}
 
-	return treapAdd(psRes->psIDTreap, pID, pString);
+	const char *id = stored.first->first.c_str();
+	auto idIt = psRes->ids.emplace(pString, id).first;
+	if (strcmp(id, idIt->second) < 0)
+	{
+		idIt->second = id;
+	}
+	return true;
 }
 
 const char *strresGetString(const STR_RES *psRes, const char *ID)
 {
-	return treapFind(psRes->psIDTreap, ID);
+	auto it = psRes->strings.find(ID);
+	return it != psRes->strings.end() ? it->second.c_str() : nullptr;
 }
 
 /* Load a string resource file */
@@ -110,6 +106,15 @@ bool strresLoad(STR_RES *psRes, const char *fileName)
 	}
 	WZ_PHYSFS_SETBUFFER(input.input.physfsfile, 4096)//;
 
+	// Most string files are loaded into an empty resource, so size the tables for the whole file up front.
+	PHYSFS_sint64 fileSize = PHYSFS_fileLength(input.input.physfsfile);
+	if (fileSize > 0)
+	{
+		size_t expectedStrings = psRes->strings.size() + fileSize / STRRES_AVERAGE_ENTRY_SIZE;
+		psRes->strings.reserve(expectedStrings);
+		psRes->ids.reserve(expectedStrings);
+	}
+
 	strres_set_extra(&input);
 	retval = (strres_parse(psRes) == 0);
 
@@ -122,5 +127,6 @@ bool strresLoad(STR_RES *psRes, const char *fileName)
 /* Get the ID number for a string*/
 const char *strresGetIDfromString(STR_RES *psRes, const char *pString)
 {
-	return treapFindKey(psRes->psIDTreap, pString);
+	auto it = psRes->ids.find(pString);
+	return it != psRes->ids.end() ? it->second : nullptr;
 }
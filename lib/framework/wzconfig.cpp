@@ -67,55 +67,57 @@ static nlohmann::json jsonMerge(nlohmann::json original, const nlohmann::json& o
 	return original;
 }
 
+nlohmann::json WzConfig::parseDocument(const WzString &name)
+{
+	PHYSFS_file *fileHandle = PHYSFS_openRead(name.toUtf8().c_str());
+	if (fileHandle == nullptr)
+	{
+		return nlohmann::json();
+	}
+	PHYSFS_sint64 fileLength = PHYSFS_fileLength(fileHandle);
+	if (fileLength < 0)
+	{
+		PHYSFS_close(fileHandle);
+		return nlohmann::json();
+	}
+	std::vector<char> data(static_cast<size_t>(fileLength));
+	PHYSFS_sint64 lengthRead = WZ_PHYSFS_readBytes(fileHandle, data.data(), static_cast<PHYSFS_uint32>(fileLength));
+	PHYSFS_close(fileHandle);
+	if (lengthRead != fileLength)
+	{
+		return nlohmann::json();
+	}
+	try {
+		return nlohmann::json::parse(data.begin(), data.end());
+	}
+	catch (...) {
+		return nlohmann::json();
+	}
+}
+
 WzConfig::WzConfig(const WzString &name, WzConfig::warning warning)
+: WzConfig(name, nlohmann::json(), warning)
+{ }
+
+WzConfig::WzConfig(const WzString &name, nlohmann::json &&document, WzConfig::warning warning)
 : mArray(nlohmann::json::array())
 {
-	UDWORD size;
-	char *data;
-
 	mFilename = name;
 	mStatus = true;
 	mWarning = warning;
 	pCurrentObj = &mRoot;
 
-	if (!PHYSFS_exists(name.toUtf8().c_str()))
+	if (document.is_object())
 	{
-		if (warning == ReadOnly)
-		{
-			mStatus = false;
-			return;
-		}
-		else if (warning == ReadOnlyAndRequired)
-		{
-			debug(LOG_FATAL, "Missing required file %s", name.toUtf8().c_str());
-			abort();
-		}
-		else if (warning == ReadAndWrite)
-		{
-			return;
-		}
+		mRoot = std::move(document);
 	}
-	if (!loadFile(name.toUtf8().c_str(), &data, &size))
+	else if (!loadDocument(name, warning))
 	{
-		debug(LOG_FATAL, "Could not open \"%s\"", name.toUtf8().c_str());
-	}
-
-	try {
-		mRoot = nlohmann::json::parse(data, data + size);
-	}
-	catch (const std::exception &e) {
-		ASSERT(false, "JSON document from %s is invalid: %s", name.toUtf8().c_str(), e.what());
-	}
-	catch (...) {
-		debug(LOG_FATAL, "Unexpected exception parsing JSON %s", name.toUtf8().c_str());
+		return;
 	}
-	pCurrentObj = &mRoot;
-	ASSERT(!mRoot.is_null(), "JSON document from %s is null", name.toUtf8().c_str());
-	ASSERT(mRoot.is_object(), "JSON document from %s is not an object. Read: \n%s", name.toUtf8().c_str(), data);
-	free(data);
 	WZ_PHYSFS_enumerateFiles("diffs", [&](const char *i) -> bool {
 		std::string str(std::string("diffs/") + i + std::string("/") + name.toUtf8().c_str());
-		if (!PHYSFS_exists(str.c_str()))
+		if (!WZ_PHYSFS_cachedExists(str.c_str()))
 		{
 			return true; // continue;
 		}
@@ -146,6 +148,48 @@ WzConfig::WzConfig(const WzString &name, WzConfig::warning warning)
 	pCurrentObj = &mRoot;
 }
 
+bool WzConfig::loadDocument(const WzString &name, WzConfig::warning warning)
+{
+	UDWORD size;
+	char *data;
+
+	if (!WZ_PHYSFS_cachedExists(name.toUtf8().c_str()))
+	{
+		if (warning == ReadOnly)
+		{
+			mStatus = false;
+			return false;
+		}
+		else if (warning == ReadOnlyAndRequired)
+		{
+			debug(LOG_FATAL, "Missing required file %s", name.toUtf8().c_str());
+			abort();
+		}
+		else if (warning == ReadAndWrite)
+		{
+			return false;
+		}
+	}
+	if (!loadFile(name.toUtf8().c_str(), &data, &size))
+	{
+		debug(LOG_FATAL, "Could not open \"%s\"", name.toUtf8().c_str());
+	}
+
+	try {
+		mRoot = nlohmann::json::parse(data, data + size);
+	}
+	catch (const std::exception &e) {
+		ASSERT(false, "JSON document from %s is invalid: %s", name.toUtf8().c_str(), e.what());
+	}
+	catch (...) {
+		debug(LOG_FATAL, "Unexpected exception parsing JSON %s", name.toUtf8().c_str());
+	}
+	ASSERT(!mRoot.is_null(), "JSON document from %s is null", name.toUtf8().c_str());
+	ASSERT(mRoot.is_object(), "JSON document from %s is not an object. Read: \n%s", name.toUtf8().c_str(), data);
+	free(data);
+	return true;
+}
+
 bool WzConfig::isAtDocumentRoot() const
 {
 	return pCurrentObj == &mRoot;
@@ -109,10 +109,19 @@ private:
 	bool mStatus;
 	warning mWarning;
 
+	bool loadDocument(const WzString &name, WzConfig::warning warning);
+
 public:
 	WzConfig(const WzString &name, WzConfig::warning warning);
+	/// Uses an already parsed document (see parseDocument()) instead of reading the file again.
+	/// Falls back to reading the file if the document is not a JSON object.
+	WzConfig(const WzString &name, nlohmann::json &&document, WzConfig::warning warning);
 	~WzConfig();
 
+	/// Reads and parses a JSON document without touching any WzConfig or debug state, so it
+	/// is safe to call from worker threads. Returns a null value if the file is missing or invalid.
+	static nlohmann::json parseDocument(const WzString &name);
+
 	Vector3f vector3f(const WzString &name);
 	void setVector3f(const WzString &name, const Vector3f &v);
 	Vector3i vector3i(const WzString &name);
@@ -42,6 +42,9 @@ float graphicsTimeFraction = 0.0, realTimeFraction = 0.0;
 /** The current clock modifier. Set to speed up the game. */
 static Rational modifier;
 
+/** Set to not wait for real time at all. */
+static bool uncapped = false;
+
 /// The real time, the last time graphicsTime updated.
 static uint32_t prevRealTime;
 
@@ -174,6 +177,13 @@ void gameTimeUpdate(bool mayUpdate)
 
 	uint32_t newGraphicsTime = graphicsTime + newDeltaGraphicsTime;
 
+	if (uncapped && !NetPlay.bComms)
+	{
+		// Tick right away if allowed to, otherwise just catch up with the game time.
+		newGraphicsTime = mayUpdate ? gameTime + 1 : gameTime;
+		newDeltaGraphicsTime = newGraphicsTime - graphicsTime;
+	}
+
 	if (newGraphicsTime > gameTime && !mayUpdate)
 	{
 		newGraphicsTime = gameTime;
@@ -275,6 +285,16 @@ Rational gameTimeGetMod()
 	return modifier;
 }
 
+void gameTimeSetUncapped(bool newUncapped)
+{
+	uncapped = newUncapped;
+}
+
+bool gameTimeIsUncapped()
+{
+	return uncapped && !NetPlay.bComms;
+}
+
 bool gameTimeIsStopped(void)
 {
 	return stopCount != 0;
@@ -99,6 +99,13 @@ void gameTimeSetMod(Rational mod);
 /** Get the current time modifier. */
 Rational gameTimeGetMod();
 
+/** Makes the game time tick whenever allowed to, without waiting for real time. For running games without
+ *  anyone watching as fast as possible. Has no effect in network games, which must keep pace with the other players. */
+void gameTimeSetUncapped(bool uncapped);
+
+/** Returns true if the game time doesn't wait for real time. */
+bool gameTimeIsUncapped();
+
 /**
  * Returns the game time, modulo the time period, scaled to 0..requiredRange.
  * For instance getModularScaledGameTime(4096,256) will return a number that cycles through the values
@@ -307,6 +307,9 @@ namespace gfx_api
 		virtual void debugPerfBegin(PERF_POINT pp, const char *descr) = 0;
 		virtual void debugPerfEnd(PERF_POINT pp) = 0;
 		virtual uint64_t debugGetPerfValue(PERF_POINT pp) = 0;
+		/// Call once per frame, after flip(). Moves on to the next frame's timer queries, and gets the GPU time in nanoseconds
+		/// spent on each PERF_POINT (0 if not drawn) of an earlier frame, if ready without waiting. Returns false otherwise.
+		virtual bool debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT]) = 0;
 		virtual std::map<std::string, std::string> getBackendGameInfo() = 0;
 		virtual const std::string& getFormattedRendererInfoString() const = 0;
 		virtual bool getScreenshot(std::function<void (std::unique_ptr<iV_Image>)> callback) = 0;
@@ -604,6 +607,17 @@ namespace gfx_api
 	vertex_buffer_description<12, vertex_attribute_description<position, gfx_api::vertex_attribute_type::float3, 0>>
 	>, notexture, SHADER_TERRAIN_DEPTH>;
 
+	// Must match MAX_DYNAMIC_LIGHTS in the terrain and decals shaders
+	static const size_t max_dynamic_lights = 32;
+
+	// Dynamic lights (explosions, fires, ...) that the terrain shaders add to the lightmap.
+	// Lights are packed at the front, the first light with a range of 0 ends the list.
+	struct dynamic_lights
+	{
+		glm::vec4 position_range[max_dynamic_lights]; // position in terrain coordinates (x, height, -y), range in w
+		glm::vec4 colour[max_dynamic_lights];
+	};
+
 	template<>
 	struct constant_buffer_type<SHADER_TERRAIN>
 	{
@@ -614,6 +628,7 @@ namespace gfx_api
 		glm::vec4 paramYLight;
 		glm::mat4 unused;
 		glm::mat4 texture_matrix;
+		dynamic_lights lights;
 		glm::vec4 fog_colour;
 		int fog_enabled;
 		float fog_begin;
@@ -635,6 +650,7 @@ namespace gfx_api
 		glm::vec4 param1;
 		glm::vec4 param2;
 		glm::mat4 texture_matrix;
+		dynamic_lights lights;
 		glm::vec4 fog_colour;
 		int fog_enabled;
 		float fog_begin;
@@ -46,8 +46,39 @@ struct OPENGL_DATA
 };
 OPENGL_DATA opengl;
 
-static GLuint perfpos[PERF_COUNT];
-static bool perfStarted = false;
+#define PERF_QUERY_FRAMES 4  ///< Timer query results are read this many frames later, so reading them doesn't stall
+
+static GLuint perfQueries[PERF_QUERY_FRAMES][PERF_COUNT];
+static bool perfQueriesUsed[PERF_QUERY_FRAMES][PERF_COUNT];
+static size_t perfQueryFrame = 0;
+static uint64_t perfLastValues[PERF_COUNT];  ///< Of the last frame read back
+
+#define STREAM_BUFFER_INITIAL_SIZE (256 * 1024)  ///< Per frame, grows when a frame streams more than this
+
+// ARB_buffer_storage and ARB_sync (core in OpenGL 4.4 and 3.2) aren't part of the generated glad loader, so look them up here.
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D
+#endif
+typedef void (APIENTRYP PFN_wzglBufferStorage)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+typedef GLsync (APIENTRYP PFN_wzglFenceSync)(GLenum condition, GLbitfield flags);
+typedef GLenum (APIENTRYP PFN_wzglClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (APIENTRYP PFN_wzglDeleteSync)(GLsync sync);
+static PFN_wzglBufferStorage wzglBufferStorage = nullptr;
+static PFN_wzglFenceSync wzglFenceSync = nullptr;
+static PFN_wzglClientWaitSync wzglClientWaitSync = nullptr;
+static PFN_wzglDeleteSync wzglDeleteSync = nullptr;
 
 static std::pair<GLenum, GLenum> to_gl(const gfx_api::pixel_format& format)
 {
@@ -295,12 +326,12 @@ static const std::map<SHADER_MODE, program_data> shader_to_file_table =
 			"fogColor", "fogEnd", "fogStart", "hasTangents" } }),
 	std::make_pair(SHADER_TERRAIN, program_data{ "terrain program", "shaders/terrain_water.vert", "shaders/terrain.frag",
 		{ "ModelViewProjectionMatrix", "paramx1", "paramy1", "paramx2", "paramy2", "tex", "lightmap_tex", "textureMatrix1", "textureMatrix2",
-			"fogColor", "fogEnabled", "fogEnd", "fogStart" } }),
+			"fogColor", "fogEnabled", "fogEnd", "fogStart", "lightPositionRange", "lightColour" } }),
 	std::make_pair(SHADER_TERRAIN_DEPTH, program_data{ "terrain_depth program", "shaders/terrain_water.vert", "shaders/terraindepth.frag",
 		{ "ModelViewProjectionMatrix", "paramx2", "paramy2", "lightmap_tex", "paramx2", "paramy2" } }),
 	std::make_pair(SHADER_DECALS, program_data{ "decals program", "shaders/decals.vert", "shaders/decals.frag",
 		{ "ModelViewProjectionMatrix", "paramxlight", "paramylight", "lightTextureMatrix",
-			"fogColor", "fogEnabled", "fogEnd", "fogStart", "tex", "lightmap_tex" } }),
+			"fogColor", "fogEnabled", "fogEnd", "fogStart", "tex", "lightmap_tex", "lightPositionRange", "lightColour" } }),
 	std::make_pair(SHADER_WATER, program_data{ "water program", "shaders/terrain_water.vert", "shaders/water.frag",
 		{ "ModelViewProjectionMatrix", "paramx1", "paramy1", "paramx2", "paramy2", "tex1", "tex2", "textureMatrix1", "textureMatrix2",
 			"fogColor", "fogEnabled", "fogEnd", "fogStart" } }),
@@ -1011,6 +1042,15 @@ void gl_pipeline_state_object::setUniforms(size_t uniformIdx, const ::glm::vec4
 	}
 }
 
+void gl_pipeline_state_object::setUniforms(size_t uniformIdx, const ::glm::vec4 *v, size_t count)
+{
+	glUniform4fv(locations[uniformIdx], static_cast<GLsizei>(count), glm::value_ptr(*v));
+	if (duplicateFragmentUniformLocations[uniformIdx] != -1)
+	{
+		glUniform4fv(duplicateFragmentUniformLocations[uniformIdx], static_cast<GLsizei>(count), glm::value_ptr(*v));
+	}
+}
+
 void gl_pipeline_state_object::setUniforms(size_t uniformIdx, const ::glm::mat4 &m)
 {
 	glUniformMatrix4fv(locations[uniformIdx], 1, GL_FALSE, glm::value_ptr(m));
@@ -1114,6 +1154,8 @@ void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type
 	setUniforms(10, cbuf.fog_enabled);
 	setUniforms(11, cbuf.fog_begin);
 	setUniforms(12, cbuf.fog_end);
+	setUniforms(13, cbuf.lights.position_range, gfx_api::max_dynamic_lights);
+	setUniforms(14, cbuf.lights.colour, gfx_api::max_dynamic_lights);
 }
 
 void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type<SHADER_TERRAIN_DEPTH>& cbuf)
@@ -1138,6 +1180,8 @@ void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type
 	setUniforms(7, cbuf.fog_end);
 	setUniforms(8, cbuf.texture0);
 	setUniforms(9, cbuf.texture1);
+	setUniforms(10, cbuf.lights.position_range, gfx_api::max_dynamic_lights);
+	setUniforms(11, cbuf.lights.colour, gfx_api::max_dynamic_lights);
 }
 
 void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type<SHADER_WATER>& cbuf)
@@ -1370,22 +1414,132 @@ void gl_context::disable_all_vertex_buffers()
 	glBindBuffer(to_gl(gfx_api::buffer::usage::vertex_buffer), 0);
 }
 
+void gl_context::createStreamBuffer(size_t segmentSize)
+{
+	deleteStreamBuffer();
+	glGenBuffers(1, &streamBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, streamBuffer);
+	if (bufferStorageAvailable)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		streamBufferSize = segmentSize * streamBufferFrames;
+		wzglBufferStorage(GL_ARRAY_BUFFER, streamBufferSize, nullptr, flags);
+		streamBufferMapping = static_cast<uint8_t *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, streamBufferSize, flags));
+		if (streamBufferMapping == nullptr)
+		{
+			debug(LOG_3D, "Mapping the stream buffer failed, not using ARB_buffer_storage");
+			bufferStorageAvailable = false;
+			createStreamBuffer(segmentSize);
+			return;
+		}
+	}
+	else
+	{
+		streamBufferSize = segmentSize;
+		glBufferData(GL_ARRAY_BUFFER, streamBufferSize, nullptr, GL_STREAM_DRAW);
+	}
+	streamBufferSegment = 0;
+	streamBufferOffset = 0;
+}
+
+void gl_context::deleteStreamBuffer()
+{
+	for (auto &fence : streamBufferFences)
+	{
+		if (fence != nullptr)
+		{
+			wzglDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+	if (streamBuffer != 0)
+	{
+		// Draws that still use the buffer keep it alive until they are done.
+		if (streamBufferMapping != nullptr)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, streamBuffer);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			streamBufferMapping = nullptr;
+		}
+		glDeleteBuffers(1, &streamBuffer);
+		streamBuffer = 0;
+	}
+	streamBufferSize = 0;
+}
+
+// Copies the data into the stream buffer, which is left bound, and returns its offset there.
+size_t gl_context::streamVertexData(const void *data, size_t size)
+{
+	const size_t segmentSize = streamBufferMapping != nullptr ? streamBufferSize / streamBufferFrames : streamBufferSize;
+	const size_t segmentEnd = streamBufferMapping != nullptr ? (streamBufferSegment + 1) * segmentSize : segmentSize;
+	if (size > segmentSize || (streamBufferMapping != nullptr && streamBufferOffset + size > segmentEnd))
+	{
+		// The segment of this frame is full, and the others may still be in use.
+		createStreamBuffer(std::max(size, segmentSize * 2));
+	}
+	else if (streamBufferOffset + size > segmentEnd)
+	{
+		// Orphan the full buffer, the driver keeps the old storage until the GPU is done with it.
+		glBindBuffer(GL_ARRAY_BUFFER, streamBuffer);
+		glBufferData(GL_ARRAY_BUFFER, streamBufferSize, nullptr, GL_STREAM_DRAW);
+		streamBufferOffset = 0;
+	}
+
+	const size_t offset = streamBufferOffset;
+	streamBufferOffset += (size + 15) & ~size_t(15);  // Keep the offsets aligned for any vertex format.
+	glBindBuffer(GL_ARRAY_BUFFER, streamBuffer);
+	if (streamBufferMapping != nullptr)
+	{
+		memcpy(streamBufferMapping + offset, data, size);
+		return offset;
+	}
+	// Nothing since the last orphaning used this range, so there is no need to synchronise.
+	void *mapping = glMapBufferRange ? glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT) : nullptr;
+	if (mapping != nullptr)
+	{
+		memcpy(mapping, data, size);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+	else
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	}
+	return offset;
+}
+
+void gl_context::nextStreamBufferFrame()
+{
+	if (streamBufferMapping == nullptr)
+	{
+		return;  // Orphaning takes care of it.
+	}
+	streamBufferFences[streamBufferSegment] = wzglFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	streamBufferSegment = (streamBufferSegment + 1) % streamBufferFrames;
+	streamBufferOffset = streamBufferSegment * (streamBufferSize / streamBufferFrames);
+
+	// Wait until the GPU is done with the frame that used this segment before, normally it is long done.
+	GLsync &fence = streamBufferFences[streamBufferSegment];
+	if (fence != nullptr)
+	{
+		if (wzglClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_WAIT_FAILED)
+		{
+			debug(LOG_3D, "glClientWaitSync failed");
+		}
+		wzglDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
 void gl_context::bind_streamed_vertex_buffers(const void* data, const std::size_t size)
 {
 	ASSERT_OR_RETURN(, current_program != nullptr, "current_program == NULL");
 	ASSERT(size > 0, "bind_streamed_vertex_buffers called with size 0");
-	glBindBuffer(GL_ARRAY_BUFFER, scratchbuffer);
-	if (scratchbuffer_size > 0)
-	{
-		glBufferData(GL_ARRAY_BUFFER, scratchbuffer_size, nullptr, GL_STREAM_DRAW); // orphan previous buffer
-	}
-	glBufferData(GL_ARRAY_BUFFER, size, data, GL_STREAM_DRAW);
-	scratchbuffer_size = size;
+	const size_t offset = streamVertexData(data, size);
 	const auto& buffer_desc = current_program->vertex_buffer_desc[0];
 	for (const auto& attribute : buffer_desc.attributes)
 	{
 		enableVertexAttribArray(static_cast<GLuint>(attribute.id));
-		glVertexAttribPointer(static_cast<GLuint>(attribute.id), get_size(attribute.type), get_type(attribute.type), get_normalisation(attribute.type), static_cast<GLsizei>(buffer_desc.stride), nullptr);
+		glVertexAttribPointer(static_cast<GLuint>(attribute.id), get_size(attribute.type), get_type(attribute.type), get_normalisation(attribute.type), static_cast<GLsizei>(buffer_desc.stride), reinterpret_cast<void*>(attribute.offset + offset));
 	}
 }
 
@@ -1540,12 +1694,12 @@ bool gl_context::debugPerfAvailable()
 
 bool gl_context::debugPerfStart(size_t sample)
 {
+	// The timer queries run all the time, this just marks the sample in the debug output.
 	if (GLAD_GL_ARB_timer_query)
 	{
 		char text[80];
 		ssprintf(text, "Starting performance sample %02d", sample);
 		debugStringMarker(text);
-		perfStarted = true;
 		return true;
 	}
 	return false;
@@ -1553,7 +1707,7 @@ bool gl_context::debugPerfStart(size_t sample)
 
 void gl_context::debugPerfStop()
 {
-	perfStarted = false;
+	// no-op
 }
 
 void gl_context::debugPerfBegin(PERF_POINT pp, const char *descr)
@@ -1562,11 +1716,12 @@ void gl_context::debugPerfBegin(PERF_POINT pp, const char *descr)
 	{
 		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, pp, -1, descr);
 	}
-	if (!perfStarted)
+	if (!GLAD_GL_ARB_timer_query)
 	{
 		return;
 	}
-	glBeginQuery(GL_TIME_ELAPSED, perfpos[pp]);
+	glBeginQuery(GL_TIME_ELAPSED, perfQueries[perfQueryFrame][pp]);
+	perfQueriesUsed[perfQueryFrame][pp] = true;
 }
 
 void gl_context::debugPerfEnd(PERF_POINT pp)
@@ -1575,7 +1730,7 @@ void gl_context::debugPerfEnd(PERF_POINT pp)
 	{
 		glPopDebugGroup();
 	}
-	if (!perfStarted)
+	if (!GLAD_GL_ARB_timer_query)
 	{
 		return;
 	}
@@ -1584,9 +1739,44 @@ void gl_context::debugPerfEnd(PERF_POINT pp)
 
 uint64_t gl_context::debugGetPerfValue(PERF_POINT pp)
 {
-	GLuint64 count;
-	glGetQueryObjectui64v(perfpos[pp], GL_QUERY_RESULT, &count);
-	return count;
+	return perfLastValues[pp];
+}
+
+bool gl_context::debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT])
+{
+	if (!GLAD_GL_ARB_timer_query)
+	{
+		return false;
+	}
+
+	// The queries of the oldest frame are reused for the next frame, so read them now, if they are done.
+	perfQueryFrame = (perfQueryFrame + 1) % PERF_QUERY_FRAMES;
+	GLuint *queries = perfQueries[perfQueryFrame];
+	bool *used = perfQueriesUsed[perfQueryFrame];
+	bool ready = std::any_of(used, used + PERF_COUNT, [](bool u) { return u; });
+	for (int pp = 0; pp < PERF_COUNT && ready; ++pp)
+	{
+		GLint available = GL_TRUE;
+		if (used[pp])
+		{
+			glGetQueryObjectiv(queries[pp], GL_QUERY_RESULT_AVAILABLE, &available);
+		}
+		ready = available == GL_TRUE;
+	}
+	if (ready)
+	{
+		for (int pp = 0; pp < PERF_COUNT; ++pp)
+		{
+			GLuint64 time = 0;
+			if (used[pp])
+			{
+				glGetQueryObjectui64v(queries[pp], GL_QUERY_RESULT, &time);
+			}
+			gpuTimes[pp] = perfLastValues[pp] = time;
+		}
+	}
+	std::fill(used, used + PERF_COUNT, false);
+	return ready;
 }
 
 // Returns a space-separated list of OpenGL extensions
@@ -2024,7 +2214,7 @@ bool gl_context::initGLContext()
 
 	if (GLAD_GL_ARB_timer_query)
 	{
-		glGenQueries(PERF_COUNT, perfpos);
+		glGenQueries(PERF_QUERY_FRAMES * PERF_COUNT, &perfQueries[0][0]);
 	}
 
 	if (khr_debug)
@@ -2043,7 +2233,18 @@ bool gl_context::initGLContext()
 		}
 	}
 
-	glGenBuffers(1, &scratchbuffer);
+	// Persistently mapped buffers need fences too, to know when the GPU is done with a part of the buffer.
+	if (!gles && std::find(glExtensions.begin(), glExtensions.end(), "GL_ARB_buffer_storage") != glExtensions.end()
+		&& std::find(glExtensions.begin(), glExtensions.end(), "GL_ARB_sync") != glExtensions.end() && glMapBufferRange)
+	{
+		wzglBufferStorage = reinterpret_cast<PFN_wzglBufferStorage>(func_GLGetProcAddress("glBufferStorage"));
+		wzglFenceSync = reinterpret_cast<PFN_wzglFenceSync>(func_GLGetProcAddress("glFenceSync"));
+		wzglClientWaitSync = reinterpret_cast<PFN_wzglClientWaitSync>(func_GLGetProcAddress("glClientWaitSync"));
+		wzglDeleteSync = reinterpret_cast<PFN_wzglDeleteSync>(func_GLGetProcAddress("glDeleteSync"));
+		bufferStorageAvailable = wzglBufferStorage && wzglFenceSync && wzglClientWaitSync && wzglDeleteSync;
+	}
+	debug(LOG_3D, "  * Persistently mapped stream buffer %s used", bufferStorageAvailable ? "is" : "is NOT");
+	createStreamBuffer(STREAM_BUFFER_INITIAL_SIZE);
 
 	return true;
 }
@@ -2054,6 +2255,7 @@ void gl_context::flip(int clearMode)
 	backend_impl->swapWindow();
 	glUseProgram(0);
 	current_program = nullptr;
+	nextStreamBufferFrame();
 
 	if (clearMode & CLEAR_OFF_AND_NO_BUFFER_DOWNLOAD)
 	{
@@ -2089,8 +2291,7 @@ void gl_context::shutdown()
 
 	if (glDeleteBuffers) // glDeleteBuffers might be NULL (if initializing the OpenGL loader library fails)
 	{
-		glDeleteBuffers(1, &scratchbuffer);
-		scratchbuffer = 0;
+		deleteStreamBuffer();
 	}
 }
 
@@ -129,6 +129,7 @@ private:
 	 * Please do not use directly, use pie_ActivateShader below.
 	 */
 	void setUniforms(size_t uniformIdx, const ::glm::vec4 &v);
+	void setUniforms(size_t uniformIdx, const ::glm::vec4 *v, size_t count);
 	void setUniforms(size_t uniformIdx, const ::glm::mat4 &m);
 	void setUniforms(size_t uniformIdx, const Vector2i &v);
 	void setUniforms(size_t uniformIdx, const Vector2f &v);
@@ -185,8 +186,15 @@ struct gl_context final : public gfx_api::context
 	std::unique_ptr<gfx_api::backend_OpenGL_Impl> backend_impl;
 
 	gl_pipeline_state_object* current_program = nullptr;
-	GLuint scratchbuffer = 0;
-	size_t scratchbuffer_size = 0;
+	// ring buffer for streamed vertex data, split into one segment per frame in flight if it is persistently mapped
+	static const size_t streamBufferFrames = 3;
+	GLuint streamBuffer = 0;
+	size_t streamBufferSize = 0;
+	size_t streamBufferOffset = 0;  ///< Where the next upload goes
+	size_t streamBufferSegment = 0;  ///< Segment of the current frame, if persistently mapped
+	uint8_t *streamBufferMapping = nullptr;  ///< Only if ARB_buffer_storage is available
+	GLsync streamBufferFences[streamBufferFrames] = {};
+	bool bufferStorageAvailable = false;
 	bool khr_debug = false;
 
 	bool gles = false;
@@ -229,6 +237,7 @@ struct gl_context final : public gfx_api::context
 	virtual void debugPerfBegin(PERF_POINT pp, const char *descr) override;
 	virtual void debugPerfEnd(PERF_POINT pp) override;
 	virtual uint64_t debugGetPerfValue(PERF_POINT pp) override;
+	virtual bool debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT]) override;
 	virtual std::map<std::string, std::string> getBackendGameInfo() override;
 	virtual const std::string& getFormattedRendererInfoString() const override;
 	virtual bool getScreenshot(std::function<void (std::unique_ptr<iV_Image>)> callback) override;
@@ -244,6 +253,10 @@ private:
 	void enableVertexAttribArray(GLuint index);
 	void disableVertexAttribArray(GLuint index);
 	std::string calculateFormattedRendererInfoString() const;
+	void createStreamBuffer(size_t segmentSize);
+	void deleteStreamBuffer();
+	size_t streamVertexData(const void *data, size_t size);
+	void nextStreamBufferFrame();
 
 	std::vector<bool> enabledVertexAttribIndexes;
 	size_t frameNum = 0;
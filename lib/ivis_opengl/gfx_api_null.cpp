@@ -292,6 +292,11 @@ uint64_t null_context::debugGetPerfValue(PERF_POINT pp)
 	return 0;
 }
 
+bool null_context::debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT])
+{
+	return false;
+}
+
 std::map<std::string, std::string> null_context::getBackendGameInfo()
 {
 	std::map<std::string, std::string> backendGameInfo;
@@ -118,6 +118,7 @@ public:
 	virtual void debugPerfBegin(PERF_POINT pp, const char *descr) override;
 	virtual void debugPerfEnd(PERF_POINT pp) override;
 	virtual uint64_t debugGetPerfValue(PERF_POINT pp) override;
+	virtual bool debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT]) override;
 	virtual std::map<std::string, std::string> getBackendGameInfo() override;
 	virtual const std::string& getFormattedRendererInfoString() const override;
 	virtual bool getScreenshot(std::function<void (std::unique_ptr<iV_Image>)> callback) override;
@@ -41,6 +41,8 @@
 
 #include "gfx_api_vk.h"
 #include "lib/framework/physfs_ext.h"
+#include "lib/framework/file.h"
+#include "lib/framework/crc.h"
 #include "lib/exceptionhandler/dumpinfo.h"
 
 #include <algorithm>
@@ -1155,6 +1157,7 @@ VkPSO::VkPSO(vk::Device _dev,
 	vk::RenderPass rp,
 	const std::shared_ptr<VkhRenderPassCompat>& renderpass_compat,
 	vk::SampleCountFlagBits rasterizationSamples,
+	vk::PipelineCache pipelineCache,
 	const vk::DispatchLoaderDynamic& _vkDynLoader
 	) : dev(_dev), pVkDynLoader(&_vkDynLoader), renderpass_compat(renderpass_compat)
 {
@@ -1281,7 +1284,7 @@ VkPSO::VkPSO(vk::Device _dev,
 		.setPMultisampleState(&multisampleState)
 		.setRenderPass(rp);
 
-	vk::ResultValue<vk::Pipeline> result = dev.createGraphicsPipeline(vk::PipelineCache(), pso, nullptr, *pVkDynLoader);
+	vk::ResultValue<vk::Pipeline> result = dev.createGraphicsPipeline(pipelineCache, pso, nullptr, *pVkDynLoader);
 	switch (result.result)
 	{
 		case vk::Result::eSuccess:
@@ -1653,15 +1656,179 @@ gfx_api::pipeline_state_object * VkRoot::build_pipeline(const gfx_api::state_des
 	const std::vector<gfx_api::vertex_buffer>& attribute_descriptions)
 {
 	// build a pipeline, return an indirect VkPSOId (to enable rebuilding pipelines if needed)
+	// the pipeline is compiled on the pipeline thread, and only waited for once it is bound
 	const gfxapi_PipelineCreateInfo createInfo(state_desc, shader_mode, primitive, texture_desc, attribute_descriptions);
-	auto pipeline = new VkPSO(dev, physDeviceProps.limits, createInfo, rp, rp_compat_info, msaaSamples, vkDynLoader);
-	createdPipelines.emplace_back(createInfo, pipeline);
+	const vk::RenderPass renderPass = rp;
+	const std::shared_ptr<VkhRenderPassCompat> renderPassCompat = rp_compat_info;
+	const vk::SampleCountFlagBits samples = msaaSamples;
+	wz::packaged_task<VkPSO *()> job([this, createInfo, renderPass, renderPassCompat, samples]() {
+		return new VkPSO(dev, physDeviceProps.limits, createInfo, renderPass, renderPassCompat, samples, pipelineCache, vkDynLoader);
+	});
+	createdPipelines.emplace_back(createInfo, nullptr);
+	pipelineResults.push_back(job.get_future());
+	if (pipelineThread == nullptr)
+	{
+		job();
+	}
+	else
+	{
+		{
+			std::lock_guard<wz::mutex> lock(pipelineJobsMutex);
+			pipelineJobs.push_back(std::move(job));
+		}
+		wzSemaphorePost(pipelineSemaphore);
+	}
 	return new VkPSOId(createdPipelines.size() - 1);
 }
 
+VkPSO *VkRoot::getPipeline(size_t psoID)
+{
+	auto& pipeline = createdPipelines[psoID];
+	if (pipeline.second == nullptr)
+	{
+		pipeline.second = pipelineResults[psoID].get();  // waits if it is still being built
+	}
+	return pipeline.second;
+}
+
+void VkRoot::finishPendingPipelines()
+{
+	for (size_t psoID = 0; psoID < createdPipelines.size(); ++psoID)
+	{
+		getPipeline(psoID);
+	}
+}
+
+int VkRoot::pipelineThreadFunc(void *data)
+{
+	VkRoot &root = *static_cast<VkRoot *>(data);
+	while (true)
+	{
+		// posted once for each job, and once more to quit
+		wzSemaphoreWait(root.pipelineSemaphore);
+		root.pipelineJobsMutex.lock();
+		if (root.pipelineJobs.empty())
+		{
+			bool quit = root.pipelineThreadQuit;
+			root.pipelineJobsMutex.unlock();
+			if (quit)
+			{
+				return 0;
+			}
+			continue;
+		}
+		wz::packaged_task<VkPSO *()> job = std::move(root.pipelineJobs.front());
+		root.pipelineJobs.pop_front();
+		root.pipelineJobsMutex.unlock();
+		job();
+	}
+}
+
+#define PIPELINE_CACHE_MAGIC 0x4350575a  // "ZWPC"
+
+/// Written in front of the driver's pipeline cache data, since not all drivers cope with damaged data.
+struct PipelineCacheFileHeader
+{
+	uint32_t magic;
+	uint32_t dataSize;
+	uint32_t dataCrc;
+};
+
+/// One file per device, so switching between GPUs doesn't throw away the cache of the other one.
+static std::string pipelineCacheFileName(const vk::PhysicalDeviceProperties& props)
+{
+	return astringf("vkpipelinecache_%04" PRIx32 "_%04" PRIx32 ".bin", props.vendorID, props.deviceID);
+}
+
+/// Checks the header that the driver puts in front of its pipeline cache data (see VkPipelineCacheHeaderVersionOne),
+/// the data is only usable by the same device and driver version (pipelineCacheUUID).
+static bool isPipelineCacheCompatible(const std::vector<uint8_t>& data, const vk::PhysicalDeviceProperties& props)
+{
+	const size_t headerSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+	if (data.size() < headerSize)
+	{
+		return false;
+	}
+	uint32_t fields[4];  // length, version, vendorID, deviceID
+	memcpy(fields, data.data(), sizeof(fields));
+	return fields[0] >= headerSize && fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && fields[2] == props.vendorID && fields[3] == props.deviceID
+		&& memcmp(data.data() + 4 * sizeof(uint32_t), &props.pipelineCacheUUID[0], VK_UUID_SIZE) == 0;
+}
+
+void VkRoot::createPipelineCache()
+{
+	const std::string fileName = pipelineCacheFileName(physDeviceProps);
+	std::vector<uint8_t> initialData;
+	PHYSFS_file *file = PHYSFS_exists(fileName.c_str()) ? PHYSFS_openRead(fileName.c_str()) : nullptr;
+	if (file != nullptr)
+	{
+		PipelineCacheFileHeader header;
+		const PHYSFS_sint64 fileSize = PHYSFS_fileLength(file);
+		if (fileSize >= static_cast<PHYSFS_sint64>(sizeof(header))
+			&& WZ_PHYSFS_readBytes(file, &header, sizeof(header)) == static_cast<PHYSFS_sint64>(sizeof(header))
+			&& header.magic == PIPELINE_CACHE_MAGIC && static_cast<PHYSFS_sint64>(header.dataSize) == fileSize - static_cast<PHYSFS_sint64>(sizeof(header)))
+		{
+			initialData.resize(header.dataSize);
+			if (WZ_PHYSFS_readBytes(file, initialData.data(), header.dataSize) != static_cast<PHYSFS_sint64>(header.dataSize)
+				|| crcSum(0, initialData.data(), initialData.size()) != header.dataCrc)
+			{
+				initialData.clear();
+			}
+		}
+		PHYSFS_close(file);
+		if (!isPipelineCacheCompatible(initialData, physDeviceProps))
+		{
+			debug(LOG_3D, "Ignoring pipeline cache %s, it is damaged or from another driver version", fileName.c_str());
+			initialData.clear();
+		}
+	}
+
+	try
+	{
+		pipelineCache = dev.createPipelineCache(vk::PipelineCacheCreateInfo()
+			.setInitialDataSize(initialData.size())
+			.setPInitialData(initialData.data())
+			, nullptr, vkDynLoader);
+		debug(LOG_3D, "Created pipeline cache, with %zu bytes of cached data", initialData.size());
+	}
+	catch (const vk::SystemError& e)
+	{
+		debug(LOG_3D, "createPipelineCache failed: %s", e.what());
+		pipelineCache = vk::PipelineCache();  // pipelines are compiled without a cache
+	}
+}
+
+void VkRoot::savePipelineCache()
+{
+	if (!pipelineCache || PHYSFS_getWriteDir() == nullptr)
+	{
+		return;
+	}
+	std::vector<uint8_t> data;
+	try
+	{
+		data = dev.getPipelineCacheData(pipelineCache, vkDynLoader);
+	}
+	catch (const vk::SystemError& e)
+	{
+		debug(LOG_3D, "getPipelineCacheData failed: %s", e.what());
+		return;
+	}
+	if (data.empty())
+	{
+		return;
+	}
+	const PipelineCacheFileHeader header = {PIPELINE_CACHE_MAGIC, static_cast<uint32_t>(data.size()), crcSum(0, data.data(), data.size())};
+	std::vector<char> fileData(sizeof(header) + data.size());
+	memcpy(fileData.data(), &header, sizeof(header));
+	memcpy(fileData.data() + sizeof(header), data.data(), data.size());
+	saveFile(pipelineCacheFileName(physDeviceProps).c_str(), fileData.data(), static_cast<UDWORD>(fileData.size()));
+}
+
 void VkRoot::rebuildPipelinesIfNecessary()
 {
 	ASSERT(rp_compat_info, "Called before rendering pass is set up");
+	finishPendingPipelines();
 	// rebuild existing pipelines
 	for (auto& pipeline : createdPipelines)
 	{
@@ -1669,7 +1836,7 @@ void VkRoot::rebuildPipelinesIfNecessary()
 		if (!rp_compat_info->isCompatibleWith(*pipeline.second->renderpass_compat))
 		{
 			delete pipeline.second;
-			pipeline.second = new VkPSO(dev, physDeviceProps.limits, pipeline.first, rp, rp_compat_info, msaaSamples, vkDynLoader);
+			pipeline.second = new VkPSO(dev, physDeviceProps.limits, pipeline.first, rp, rp_compat_info, msaaSamples, pipelineCache, vkDynLoader);
 		}
 	}
 }
@@ -2003,11 +2170,38 @@ void VkRoot::shutdown()
 {
 	destroySwapchainAndSwapchainSpecificStuff(true);
 
+	if (pipelineThread)
+	{
+		// the thread finishes any jobs left, then quits
+		{
+			std::lock_guard<wz::mutex> lock(pipelineJobsMutex);
+			pipelineThreadQuit = true;
+		}
+		wzSemaphorePost(pipelineSemaphore);
+		wzThreadJoin(pipelineThread);
+		pipelineThread = nullptr;
+		pipelineThreadQuit = false;
+	}
+	if (pipelineSemaphore)
+	{
+		wzSemaphoreDestroy(pipelineSemaphore);
+		pipelineSemaphore = nullptr;
+	}
+
+	finishPendingPipelines();
 	for (auto& pipeline : createdPipelines)
 	{
 		delete pipeline.second;
 	}
 	createdPipelines.clear();
+	pipelineResults.clear();
+
+	if (pipelineCache)
+	{
+		savePipelineCache();
+		dev.destroyPipelineCache(pipelineCache, nullptr, vkDynLoader);
+		pipelineCache = vk::PipelineCache();
+	}
 
 	// destroy allocator
 	if (allocator != VK_NULL_HANDLE)
@@ -2052,6 +2246,9 @@ void VkRoot::destroySwapchainAndSwapchainSpecificStuff(bool doDestroySwapchain)
 		return;
 	}
 
+	// pipelines that are still being built use the render pass
+	finishPendingPipelines();
+
 	if (graphicsQueue)
 	{
 		graphicsQueue.waitIdle(vkDynLoader);
@@ -2859,6 +3056,14 @@ bool VkRoot::_initialize(const gfx_api::backend_Impl_Factory& impl, int32_t anti
 		return false;
 	}
 
+	createPipelineCache();
+	pipelineSemaphore = wzSemaphoreCreate(0);
+	pipelineThread = wzThreadCreate(pipelineThreadFunc, this);
+	if (pipelineThread)
+	{
+		wzThreadStart(pipelineThread);
+	}
+
 	if (!createAllocator())
 	{
 		debug(LOG_ERROR, "createAllocator() failed");
@@ -3295,7 +3500,7 @@ void VkRoot::bind_pipeline(gfx_api::pipeline_state_object* pso, bool /*notexture
 {
 	VkPSOId* newPSOId = static_cast<VkPSOId*>(pso);
 	// lookup PSO
-	VkPSO* newPSO = createdPipelines[newPSOId->psoID].second;
+	VkPSO* newPSO = getPipeline(newPSOId->psoID);
 	if (currentPSO != newPSO)
 	{
 		currentPSO = newPSO;
@@ -3589,6 +3794,12 @@ uint64_t VkRoot::debugGetPerfValue(PERF_POINT pp)
 	return 0;
 }
 
+bool VkRoot::debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT])
+{
+	// TODO: Implement
+	return false;
+}
+
 std::map<std::string, std::string> VkRoot::getBackendGameInfo()
 {
 	std::map<std::string, std::string> backendGameInfo;
@@ -44,6 +44,7 @@
 #endif
 
 #include "lib/framework/frame.h"
+#include "lib/framework/wzapp.h"
 
 #include "gfx_api.h"
 #include <algorithm>
@@ -51,6 +52,7 @@
 #include <map>
 #include <vector>
 #include <unordered_map>
+#include <list>
 
 #include <optional-lite/optional.hpp>
 using nonstd::optional;
@@ -316,6 +318,7 @@ public:
 		  vk::RenderPass rp,
 		  const std::shared_ptr<VkhRenderPassCompat>& renderpass_compat,
 		  vk::SampleCountFlagBits rasterizationSamples,
+		  vk::PipelineCache pipelineCache,
 		  const vk::DispatchLoaderDynamic& _vkDynLoader
 		  );
 
@@ -469,7 +472,15 @@ struct VkRoot final : gfx_api::context
 	PFN_vkDebugReportMessageEXT dbgBreakCallback = nullptr;
 	VkDebugReportCallbackEXT msgCallback = 0;
 
-	std::vector<std::pair<const gfxapi_PipelineCreateInfo, VkPSO *>> createdPipelines;
+	// pipelines are built on a separate thread, and looked up once they are first bound
+	std::vector<std::pair<const gfxapi_PipelineCreateInfo, VkPSO *>> createdPipelines;  ///< VkPSO is nullptr while it is still being built
+	std::vector<wz::future<VkPSO *>> pipelineResults;  ///< Same indices as createdPipelines
+	std::list<wz::packaged_task<VkPSO *()>> pipelineJobs;
+	wz::mutex pipelineJobsMutex;
+	WZ_SEMAPHORE *pipelineSemaphore = nullptr;
+	WZ_THREAD *pipelineThread = nullptr;
+	bool pipelineThreadQuit = false;  ///< Guarded by pipelineJobsMutex
+	vk::PipelineCache pipelineCache;  ///< Saved in the config directory, so pipelines are only compiled once per driver
 	VkPSO* currentPSO = nullptr;
 
 	bool debugLayer = false;
@@ -518,6 +529,11 @@ private:
 	void getQueues();
 	bool createSwapchain();
 	void rebuildPipelinesIfNecessary();
+	VkPSO *getPipeline(size_t psoID);
+	void finishPendingPipelines();
+	void createPipelineCache();
+	void savePipelineCache();
+	static int pipelineThreadFunc(void *data);
 
 	void createDefaultRenderpass(vk::Format swapchainFormat, vk::Format depthFormat);
 	void setupSwapchainImages();
@@ -567,6 +583,7 @@ public:
 	virtual void debugPerfBegin(PERF_POINT pp, const char *descr) override;
 	virtual void debugPerfEnd(PERF_POINT pp) override;
 	virtual uint64_t debugGetPerfValue(PERF_POINT pp) override;
+	virtual bool debugPerfNextFrame(uint64_t (&gpuTimes)[PERF_COUNT]) override;
 	virtual std::map<std::string, std::string> getBackendGameInfo() override;
 	virtual const std::string& getFormattedRendererInfoString() const override;
 	virtual bool getScreenshot(std::function<void (std::unique_ptr<iV_Image>)> callback) override;
@@ -126,6 +126,15 @@ void pie_FreeShaders()
 //static float fogBegin;
 //static float fogEnd;
 
+/// Builds the pipelines up front, instead of the first time something is drawn with them.
+/// The Vulkan backend compiles them in the background, while the game keeps loading.
+template <typename... PSOs>
+static void pie_PreparePipelines()
+{
+	int unused[] = {(PSOs::get(), 0)...};
+	(void)unused;
+}
+
 // Run from screen.c on init.
 bool pie_LoadShaders()
 {
@@ -141,6 +150,18 @@ bool pie_LoadShaders()
 		pie_internal::rectBuffer = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer);
 	pie_internal::rectBuffer->upload(16 * sizeof(gfx_api::gfxUByte), rect);
 
+	pie_PreparePipelines<
+		gfx_api::Draw3DButtonPSO,
+		gfx_api::Draw3DShapeOpaque, gfx_api::Draw3DShapeAlpha, gfx_api::Draw3DShapePremul, gfx_api::Draw3DShapeAdditive,
+		gfx_api::Draw3DShapeNoLightOpaque, gfx_api::Draw3DShapeNoLightAlpha, gfx_api::Draw3DShapeNoLightPremul, gfx_api::Draw3DShapeNoLightAdditive,
+		gfx_api::TransColouredTrianglePSO, gfx_api::DrawStencilShadow,
+		gfx_api::TerrainDepth, gfx_api::TerrainLayer, gfx_api::TerrainDecals, gfx_api::WaterPSO,
+		gfx_api::VideoPSO, gfx_api::BackDropPSO, gfx_api::SkyboxPSO,
+		gfx_api::RadarPSO, gfx_api::RadarViewInsideFillPSO, gfx_api::RadarViewOutlinePSO,
+		gfx_api::DrawImageTextPSO, gfx_api::ShadowBox2DPSO, gfx_api::UniTransBoxPSO,
+		gfx_api::DrawImagePSO, gfx_api::DrawImageAnisotropicPSO, gfx_api::BoxFillPSO, gfx_api::BoxFillAlphaPSO, gfx_api::LinePSO
+	>();
+
 	return true;
 }
 
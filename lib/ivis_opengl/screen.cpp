@@ -52,6 +52,7 @@
 #include <string>
 #include <vector>
 #include <cstring>
+#include <chrono>
 #ifndef GLM_ENABLE_EXPERIMENTAL
 	#define GLM_ENABLE_EXPERIMENTAL
 #endif
@@ -75,6 +76,30 @@ struct PERF_STORE
 static std::vector<PERF_STORE> perfList;
 static PERF_POINT queryActive = PERF_COUNT;
 
+#define PERF_HISTORY_FRAMES 600  ///< About 10 seconds at 60 frames per second
+
+/// Timings of the recent frames in microseconds, kept all the time, since hitches don't happen on request.
+struct PERF_HISTORY
+{
+	uint32_t times[PERF_HISTORY_FRAMES][PERF_COUNT];
+	size_t count = 0;
+	size_t next = 0;
+
+	void push(uint32_t const (&frame)[PERF_COUNT])
+	{
+		std::copy(frame, frame + PERF_COUNT, times[next]);
+		next = (next + 1) % PERF_HISTORY_FRAMES;
+		count = std::min<size_t>(count + 1, PERF_HISTORY_FRAMES);
+	}
+};
+static PERF_HISTORY perfCpuHistory;
+static PERF_HISTORY perfGpuHistory;
+static uint32_t perfFrameHistory[PERF_HISTORY_FRAMES];  ///< Same order as perfCpuHistory
+static uint32_t perfCpuTimes[PERF_COUNT];  ///< Of the current frame
+static bool perfBegun[PERF_COUNT];  ///< Points begun in the current frame, each has a single GPU timer query per frame
+static std::chrono::steady_clock::time_point perfCpuBegin;
+static std::chrono::steady_clock::time_point perfLastFrame;  ///< Unset until the first frame
+
 static int preview_width = 0, preview_height = 0;
 static Vector2i player_pos[MAX_PLAYERS];
 static WzText player_Text[MAX_PLAYERS];
@@ -104,6 +129,53 @@ void wzPerfStart()
 	perfStarted = gfx_api::context::get().debugPerfStart(perfList.size());
 }
 
+const char *wzPerfPointName(PERF_POINT pp)
+{
+	static const char *const names[PERF_COUNT] = {"Start", "Effects", "Terrain", "Skybox", "Model init", "Particles", "Water", "Models", "Misc", "GUI"};
+	return pp < PERF_COUNT ? names[pp] : "?";
+}
+
+/// Sets *p50 and *p99 to the percentiles of the values, reordering them.
+static void perfPercentiles(std::vector<uint32_t> &values, uint32_t *p50, uint32_t *p99)
+{
+	*p50 = *p99 = 0;
+	if (values.empty())
+	{
+		return;
+	}
+	auto nth = [&values](size_t n) {
+		std::nth_element(values.begin(), values.begin() + n, values.end());
+		return values[n];
+	};
+	*p50 = nth(values.size() / 2);
+	*p99 = nth(values.size() * 99 / 100);
+}
+
+void wzPerfGetStats(PERF_STATS &stats)
+{
+	static std::vector<uint32_t> values;  // static to avoid allocations.
+
+	stats.frames = perfCpuHistory.count;
+	stats.gpuFrames = perfGpuHistory.count;
+	values.assign(perfFrameHistory, perfFrameHistory + perfCpuHistory.count);
+	perfPercentiles(values, &stats.frameP50, &stats.frameP99);
+	for (int pp = 0; pp < PERF_COUNT; ++pp)
+	{
+		values.clear();
+		for (size_t i = 0; i < perfCpuHistory.count; ++i)
+		{
+			values.push_back(perfCpuHistory.times[i][pp]);
+		}
+		perfPercentiles(values, &stats.cpuP50[pp], &stats.cpuP99[pp]);
+		values.clear();
+		for (size_t i = 0; i < perfGpuHistory.count; ++i)
+		{
+			values.push_back(perfGpuHistory.times[i][pp]);
+		}
+		perfPercentiles(values, &stats.gpuP50[pp], &stats.gpuP99[pp]);
+	}
+}
+
 void wzPerfWriteOut(const std::vector<PERF_STORE> &list, const WzString &outfile)
 {
 	PHYSFS_file *fileHandle = PHYSFS_openWrite(outfile.toUtf8().c_str());
@@ -163,11 +235,33 @@ void wzPerfShutdown()
 // call after swap buffers
 void wzPerfFrame()
 {
+	ASSERT(queryActive == PERF_COUNT, "Missing wfPerfEnd() call");
+
+	// Keep the history of frame times up to date. The first frame has no previous one to measure from, so it is left out.
+	auto now = std::chrono::steady_clock::now();
+	if (perfLastFrame != std::chrono::steady_clock::time_point())
+	{
+		perfFrameHistory[perfCpuHistory.next] = std::chrono::duration_cast<std::chrono::microseconds>(now - perfLastFrame).count();
+		perfCpuHistory.push(perfCpuTimes);
+	}
+	perfLastFrame = now;
+	std::fill(perfCpuTimes, perfCpuTimes + PERF_COUNT, 0);
+	std::fill(perfBegun, perfBegun + PERF_COUNT, false);
+	uint64_t gpuTimes[PERF_COUNT];
+	if (gfx_api::context::get().debugPerfNextFrame(gpuTimes))
+	{
+		uint32_t gpuTimesMicroseconds[PERF_COUNT];
+		for (int pp = 0; pp < PERF_COUNT; ++pp)
+		{
+			gpuTimesMicroseconds[pp] = gpuTimes[pp] / 1000;
+		}
+		perfGpuHistory.push(gpuTimesMicroseconds);
+	}
+
 	if (!perfStarted)
 	{
 		return; // not started yet
 	}
-	ASSERT(queryActive == PERF_COUNT, "Missing wfPerfEnd() call");
 	PERF_STORE store;
 	for (int i = 0; i < PERF_COUNT; i++)
 	{
@@ -207,14 +301,18 @@ void wzSceneEnd(const char *descr)
 void wzPerfBegin(PERF_POINT pp, const char *descr)
 {
 	ASSERT(queryActive == PERF_COUNT || pp > queryActive, "Out of order timer query call");
+	ASSERT(!perfBegun[pp], "%s begun more than once in a frame", wzPerfPointName(pp));
+	perfBegun[pp] = true;
 	queryActive = pp;
 	gfx_api::context::get().debugPerfBegin(pp, descr);
+	perfCpuBegin = std::chrono::steady_clock::now();
 }
 
 void wzPerfEnd(PERF_POINT pp)
 {
 	ASSERT(queryActive == pp, "Mismatched wzPerfBegin...End");
 	queryActive = PERF_COUNT;
+	perfCpuTimes[pp] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - perfCpuBegin).count();
 	gfx_api::context::get().debugPerfEnd(pp);
 }
 
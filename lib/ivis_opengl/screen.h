@@ -92,6 +92,19 @@ void wzPerfFrame();
 /// Are performance measurements available?
 bool wzPerfAvailable();
 
+/// Timings of the recent frames, in microseconds.
+struct PERF_STATS
+{
+	size_t frames;                 ///< Number of frames the CPU times are of
+	size_t gpuFrames;              ///< Number of frames the GPU times are of, 0 if not available
+	uint32_t frameP50, frameP99;   ///< Time from the end of one frame to the end of the next
+	uint32_t cpuP50[PERF_COUNT], cpuP99[PERF_COUNT];
+	uint32_t gpuP50[PERF_COUNT], gpuP99[PERF_COUNT];
+};
+/// Gets the median and 99th percentile times of each measurement point, over the last few hundred frames.
+void wzPerfGetStats(PERF_STATS &stats);
+const char *wzPerfPointName(PERF_POINT pp);
+
 void wzSceneBegin(const char *descr);
 void wzSceneEnd(const char *descr);
 
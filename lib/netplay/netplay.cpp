@@ -1664,6 +1664,7 @@ static bool NETprocessSystemMessage(NETQUEUE playerQueue, uint8_t type)
 				      || message->type == NET_COLOURREQUEST
 				      || message->type == NET_POSITIONREQUEST
 				      || message->type == NET_FILE_CANCELLED
+				      || message->type == NET_FILE_ACK
 				      || message->type == NET_JOIN
 				      || message->type == NET_PLAYER_INFO) && receiver != NET_HOST_ONLY))
 				{
@@ -2123,23 +2124,23 @@ bool NETrecvGame(NETQUEUE *queue, uint8_t *type)
 // ////////////////////////////////////////////////////////////////////////
 // File Transfer programs.
 /** Send file. It returns % of file sent when 100 it's complete. Call until it returns 100.
-*  @TODO: more error checking (?) different file types (?)
-*          Maybe should close file handle, and seek each time?
+*  Sends a single chunk, the caller should check NETcanSendFile() first.
 *
-*  @NOTE: MAX_FILE_TRANSFER_PACKET is set to 2k per packet since 7*2 = 14K which is pretty
-*         much our limit.  Don't screw with that without having a bigger buffer!
-*         NET_BUFFER_SIZE is at 16k.  (also remember text chat, plus all the other cruff)
+*  @NOTE: MAX_FILE_TRANSFER_PACKET must fit in a message, with room to spare, since MaxMsgSize is 16k.
 */
-#define MAX_FILE_TRANSFER_PACKET 2048
+#define MAX_FILE_TRANSFER_PACKET 8192
+/** The host keeps sending chunks until this many bytes are unacknowledged, so the transfer isn't limited
+ *  by the round trip time, while a slow link doesn't get a backlog of data it can't take.
+ */
+#define FILE_TRANSFER_WINDOW (32 * MAX_FILE_TRANSFER_PACKET)
 int NETsendFile(WZFile &file, unsigned player)
 {
 	ASSERT_OR_RETURN(100, NetPlay.isHost, "Trying to send a file and we are not the host!");
 
 	uint8_t inBuff[MAX_FILE_TRANSFER_PACKET];
-	memset(inBuff, 0x0, sizeof(inBuff));
 
 	// read some bytes.
-	uint32_t bytesToRead = WZ_PHYSFS_readBytes(file.handle, inBuff, MAX_FILE_TRANSFER_PACKET);
+	uint32_t bytesToRead = WZ_PHYSFS_readBytes(file.handle, inBuff, std::min<uint32_t>(MAX_FILE_TRANSFER_PACKET, file.size - file.pos));
 	ASSERT_OR_RETURN(100, (int32_t)bytesToRead >= 0, "Error reading file.");
 
 	NETbeginEncode(NETnetQueue(player), NET_FILE_PAYLOAD);
@@ -2151,15 +2152,104 @@ int NETsendFile(WZFile &file, unsigned player)
 	NETend();
 
 	file.pos += bytesToRead;  // update position!
-	if (file.pos == file.size)
+	if (file.pos == file.size || bytesToRead == 0)
 	{
 		PHYSFS_close(file.handle);
 		file.handle = nullptr;  // We are done sending to this client.
+		return 100;
 	}
 
 	return (uint64_t)file.pos * 100 / file.size;
 }
 
+bool NETcanSendFile(WZFile const &file)
+{
+	return file.handle != nullptr && file.pos - file.acknowledged < FILE_TRANSFER_WINDOW;
+}
+
+void NETrecvFileAck(NETQUEUE queue)
+{
+	ASSERT_OR_RETURN(, NetPlay.isHost, "Host only routine detected for client!");
+
+	Sha256 hash;
+	hash.setZero();
+	uint32_t pos = 0;
+
+	NETbeginDecode(queue, NET_FILE_ACK);
+	NETbin(hash.bytes, hash.Bytes);
+	NETuint32_t(&pos);
+	NETend();
+
+	auto &files = NetPlay.players[queue.index].wzFiles;
+	auto file = std::find_if(files.begin(), files.end(), [&](WZFile const &file) { return file.hash == hash; });
+	if (file != files.end() && pos > file->acknowledged && pos <= file->pos)
+	{
+		file->acknowledged = pos;
+	}
+}
+
+/** Continues a download that was interrupted, if the file already has the start of what is requested.
+ *  If it doesn't, the hash won't match once the download completes, and the file is deleted, so
+ *  the next request starts from scratch.
+ */
+bool NETrequestFile(Sha256 const &hash, std::string const &filename)
+{
+	PHYSFS_file *pFileHandle = nullptr;
+	uint32_t resumePos = 0;
+	std::shared_ptr<Sha256Stream> receivedHash;
+
+	const char *writeDir = PHYSFS_getWriteDir();
+	const char *realDir = PHYSFS_getRealDir(filename.c_str());
+	if (writeDir != nullptr && realDir != nullptr && strcmp(writeDir, realDir) == 0)
+	{
+		PHYSFS_file *pPartialHandle = PHYSFS_openRead(filename.c_str());
+		if (pPartialHandle != nullptr)
+		{
+			receivedHash = std::make_shared<Sha256Stream>();
+			uint8_t buffer[MAX_FILE_TRANSFER_PACKET];
+			PHYSFS_sint64 length;
+			while ((length = WZ_PHYSFS_readBytes(pPartialHandle, buffer, sizeof(buffer))) > 0 && resumePos + length <= MAX_NET_TRANSFERRABLE_FILE_SIZE)
+			{
+				receivedHash->update(buffer, length);
+				resumePos += length;
+			}
+			bool complete = length == 0 && PHYSFS_eof(pPartialHandle);
+			PHYSFS_close(pPartialHandle);
+			if (complete && resumePos > 0)
+			{
+				pFileHandle = PHYSFS_openAppend(filename.c_str());
+			}
+		}
+	}
+	if (pFileHandle != nullptr)
+	{
+		debug(LOG_INFO, "Resuming download of %s from %" PRIu32" bytes", filename.c_str(), resumePos);
+	}
+	else
+	{
+		resumePos = 0;
+		receivedHash = nullptr;
+		pFileHandle = PHYSFS_openWrite(filename.c_str());
+	}
+	if (pFileHandle == nullptr)
+	{
+		debug(LOG_ERROR, "Failed to open %s for writing: %s", filename.c_str(), WZ_PHYSFS_getLastError());
+		return false;
+	}
+
+	NetPlay.wzFiles.emplace_back(pFileHandle, filename, hash, 0, resumePos);
+	NetPlay.wzFiles.back().receivedHash = receivedHash;
+
+	// Request the map/mod from the host
+	Sha256 requestHash = hash;
+	NETbeginEncode(NETnetQueue(NET_HOST_ONLY), NET_FILE_REQUESTED);
+	NETbin(requestHash.bytes, requestHash.Bytes);
+	NETuint32_t(&resumePos);
+	NETend();
+
+	return true;
+}
+
 bool validateReceivedFile(const WZFile& file)
 {
 	PHYSFS_file *fileHandle = PHYSFS_openRead(file.filename.c_str());
@@ -2190,6 +2280,18 @@ bool validateReceivedFile(const WZFile& file)
 	// verify actual downloaded file hash matches expected hash
 
 	Sha256 actualFileHash;
+	if (file.receivedHash && file.pos == file.size)
+	{
+		PHYSFS_close(fileHandle);
+		actualFileHash = file.receivedHash->finalise();
+		if (actualFileHash != file.hash)
+		{
+			debug(LOG_ERROR, "Downloaded file hash (%s) does not match requested file hash (%s)", actualFileHash.toString().c_str(), file.hash.toString().c_str());
+			return false;
+		}
+		return true;
+	}
+
 	crypto_hash_sha256_state state;
 	crypto_hash_sha256_init(&state);
 	size_t bufferSize = std::min<size_t>(actualFileSize, 4 * 1024 * 1024);
@@ -2292,7 +2394,6 @@ int NETrecvFile(NETQUEUE queue)
 	uint32_t pos = 0;
 	uint32_t bytesToRead = 0;
 	uint8_t buf[MAX_FILE_TRANSFER_PACKET];
-	memset(buf, 0x0, sizeof(buf));
 
 	//read incoming bytes.
 	NETbeginDecode(queue, NET_FILE_PAYLOAD);
@@ -2358,7 +2459,22 @@ int NETrecvFile(NETQUEUE queue)
 		return 100;
 	}
 
-	if (PHYSFS_tell(file->handle) != static_cast<PHYSFS_sint64>(pos))
+	if (pos == 0 && file->pos != 0)
+	{
+		// The host didn't resume the download where we asked, so start over.
+		PHYSFS_close(file->handle);
+		file->handle = PHYSFS_openWrite(file->filename.c_str());
+		if (file->handle == nullptr)
+		{
+			debug(LOG_ERROR, "Failed to open %s for writing: %s", file->filename.c_str(), WZ_PHYSFS_getLastError());
+			sendCancelFileDownload(file->hash);
+			NetPlay.wzFiles.erase(file);
+			return 100;
+		}
+		file->pos = 0;
+		file->receivedHash = nullptr;
+	}
+	if (file->pos != pos)
 	{
 		// actual position in file does not equal the expected position in the file (sent by the host)
 		debug(LOG_ERROR, "Invalid file position in downloaded file; (desired: %" PRIu32")", pos);
@@ -2366,18 +2482,40 @@ int NETrecvFile(NETQUEUE queue)
 		return 100;
 	}
 
-	// Write packet to the file.
-	WZ_PHYSFS_writeBytes(file->handle, buf, bytesToRead);
+	// Write packet to the file, and hash it while it's at hand, so the file needn't be read back to validate it.
+	if (WZ_PHYSFS_writeBytes(file->handle, buf, bytesToRead) != bytesToRead)
+	{
+		debug(LOG_ERROR, "Could not write to %s: %s", file->filename.c_str(), WZ_PHYSFS_getLastError());
+		std::string filename = file->filename;
+		terminateFileDownload(file); // 'file' is now an invalidated iterator.
+		PHYSFS_delete(filename.c_str());
+		return 100;
+	}
+	if (pos == 0)
+	{
+		file->receivedHash = std::make_shared<Sha256Stream>();
+	}
+	if (file->receivedHash)
+	{
+		file->receivedHash->update(buf, bytesToRead);
+	}
 
 	uint32_t newPos = pos + bytesToRead;
 	file->pos = newPos;
 
+	// Let the host know it may send more.
+	NETbeginEncode(NETnetQueue(NET_HOST_ONLY), NET_FILE_ACK);
+	NETbin(hash.bytes, hash.Bytes);
+	NETuint32_t(&newPos);
+	NETend();
+
 	if (newPos >= size)  // last packet
 	{
 		int noError = PHYSFS_close(file->handle);
 		if (noError == 0)
 		{
 			debug(LOG_ERROR, "Could not close file handle after trying to save map: %s", WZ_PHYSFS_getLastError());
+			file->receivedHash = nullptr;  // Buffered data may not have been written, so check what is on disk.
 		}
 		file->handle = nullptr;
 
@@ -4412,6 +4550,7 @@ const char *messageTypeToString(unsigned messageType_)
 	case NET_DEBUG_SYNC:                return "NET_DEBUG_SYNC";
 	case NET_VOTE:                      return "NET_VOTE";
 	case NET_VOTE_REQUEST:              return "NET_VOTE_REQUEST";
+	case NET_FILE_ACK:                  return "NET_FILE_ACK";
 	case NET_MAX_TYPE:                  return "NET_MAX_TYPE";
 
 	// Game-state-related messages, must be processed by all clients at the same game time.
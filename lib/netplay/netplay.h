@@ -95,6 +95,7 @@ enum MESSAGE_TYPES
 	NET_DEBUG_SYNC,                 ///< Synch error messages, so people don't have to use pastebin.
 	NET_VOTE,                       ///< player vote
 	NET_VOTE_REQUEST,               ///< Setup a vote popup
+	NET_FILE_ACK,                   ///< Player has received a file up to the given position
 	NET_MAX_TYPE,                   ///< Maximum+1 valid NET_ type, *MUST* be last.
 
 	// Game-state-related messages, must be processed by all clients at the same game time.
@@ -210,13 +211,15 @@ struct SYNC_COUNTER
 struct WZFile
 {
 	//WZFile() : handle(nullptr), size(0), pos(0) { hash.setZero(); }
-	WZFile(PHYSFS_file *handle, const std::string &filename, Sha256 hash, uint32_t size = 0) : handle(handle), filename(filename), hash(hash), size(size), pos(0) {}
+	WZFile(PHYSFS_file *handle, const std::string &filename, Sha256 hash, uint32_t size = 0, uint32_t pos = 0) : handle(handle), filename(filename), hash(hash), size(size), pos(pos), acknowledged(pos) {}
 
 	PHYSFS_file *handle;
 	std::string filename;
 	Sha256 hash;
 	uint32_t size;
 	uint32_t pos;  // Current position, the range [0; currPos[ has been sent or received already.
+	uint32_t acknowledged;  // When sending, the range [0; acknowledged[ is known to have arrived.
+	std::shared_ptr<Sha256Stream> receivedHash;  // Hash of the range [0; currPos[, when receiving.
 };
 
 enum class AIDifficulty : int8_t
@@ -343,7 +346,10 @@ WZ_DECL_NONNULL(1, 2) bool NETrecvGame(NETQUEUE *queue, uint8_t *type);       //
 void NETflush();                                                              ///< Flushes any data stuck in compression buffers.
 
 int NETsendFile(WZFile &file, unsigned player);  ///< Send file chunk. Returns 100 when done.
+bool NETcanSendFile(WZFile const &file);         ///< Whether another chunk fits in the window of unacknowledged data.
 int NETrecvFile(NETQUEUE queue);                 ///< Receive file chunk. Returns 100 when done.
+void NETrecvFileAck(NETQUEUE queue);             ///< Receive acknowledgement of file chunks.
+bool NETrequestFile(Sha256 const &hash, std::string const &filename);  ///< Request a file from the host, resuming a partial download.
 unsigned NETgetDownloadProgress(unsigned player);     ///< Returns 100 when done.
 
 int NETclose();					// close current game
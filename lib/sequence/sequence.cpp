@@ -79,6 +79,12 @@
 #include <AL/al.h>
 
 #include "lib/framework/physfs_ext.h"
+#include "lib/framework/wzapp.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <vector>
 
 // stick this in sequence.h perhaps?
 struct AudioData
@@ -87,8 +93,7 @@ struct AudioData
 	ALuint buffer2;			// buffer 2
 	ALuint source;			// source
 	int totbufstarted;		// number of buffers started
-	int audiofd_fragsize;	// audio fragment size, used to calculate how big audiobuf is
-	int audiobuf_fill;		// how full our audio buffer is
+	int audiofd_fragsize;	// audio fragment size, used to calculate how big a decoded audio chunk is
 };
 
 struct VideoData
@@ -107,6 +112,23 @@ struct VideoData
 };
 // stick that in sequence.h perhaps?
 
+/// A video frame, converted to RGBA by the decoder thread
+struct DecodedFrame
+{
+	std::vector<uint32_t> rgba;
+	double time = 0;		// when to show the frame, relative to the start of playback
+};
+
+/// A fragment of audio, converted to 16 bit samples by the decoder thread
+struct DecodedAudio
+{
+	std::vector<ogg_int16_t> pcm;
+	ogg_int64_t granulepos = 0;	// time position of the last sample
+};
+
+#define VIDEO_FRAME_QUEUE_LENGTH 4	// frames decoded ahead, enough to smooth over a slow frame
+#define AUDIO_QUEUE_LENGTH 2		// audio fragments decoded ahead, each is a second long
+
 // for our audio structure
 static AudioData audiodata;
 static ALint sourcestate = 0;		//Source state information
@@ -122,14 +144,28 @@ static int vorbis_p = 0;
 
 static bool stateflag = false;
 static bool videoplaying = false;
-static bool videobuf_ready = false;		// single frame video buffer ready for processing
-static bool audiobuf_ready = false;		// single 'frame' audio buffer ready for processing
 
 // file handle
 static PHYSFS_file *fpInfile = nullptr;
 
-static uint32_t *RGBAframe = nullptr;					// texture buffer
-static ogg_int16_t *audiobuf = nullptr;			// audio buffer
+// The file is read and decoded on a thread of its own, which keeps a few frames and audio
+// fragments ready for seq_Update(). Until the thread is joined in seq_Shutdown(), the file,
+// the Ogg, Theora and Vorbis state, pendingAudio and the decode* state below belong to it.
+// If the thread can't be created, seq_Update() decodes on the calling thread instead.
+static wz::mutex decodeMutex;
+static WZ_THREAD *decodeThread = nullptr;
+static WZ_SEMAPHORE *decodeSemaphore = nullptr;		// posted when a queue has room, or the thread must quit
+static bool decodeQuit = false;
+static bool decodeEnd = false;						// everything was decoded
+static bool decodeVideoEnd = false;					// no more video to decode
+static bool decodeAudioEnd = false;					// no more audio to decode
+static bool decodeFileEnd = false;					// the whole file was read
+static DecodedFrame decodeFrame;					// video frame being decoded
+static std::deque<DecodedFrame> decodedFrames;
+static std::deque<DecodedAudio> decodedAudio;
+static std::vector<std::vector<uint32_t>> freeFrames;	// buffers of shown frames, for reuse
+static DecodedAudio pendingAudio;					// audio fragment being filled
+static SCANLINE_MODE videoScanMode = SCANLINES_OFF;	// scanline mode of the video being played
 
 // For timing
 static double audioTime = 0;
@@ -137,13 +173,9 @@ static double audioTime = 0;
 static double videobuf_time = 0;
 static double sampletimeOffset = 0;
 static double basetime = -1;
-static double last_time;
 static double timer_expire;
 static bool timer_started = false;
 
-static ogg_int64_t audiobuf_granulepos = 0;	// time position of last sample
-static ogg_int64_t videobuf_granulepos = -1;	// time position of last video frame
-
 // frame & dropped frame counter
 static int frames = 0;
 static int dropped = 0;
@@ -200,7 +232,6 @@ static void open_audio(void)
 	float volume = 1.0;
 
 	audiodata.audiofd_fragsize = (((videodata.vi.channels * 16) / 8) * videodata.vi.rate);
-	audiobuf = (ogg_int16_t *)malloc(audiodata.audiofd_fragsize);
 
 	// FIX ME:  This call will fail, since we have, most likely, already
 	// used up all available sources late in the game!
@@ -226,18 +257,11 @@ static void open_audio(void)
 static void audio_close(void)
 {
 	// NOTE: sources & buffers deleted in seq_Shutdown()
-	audiobuf_granulepos = 0;
 //	clear struct
 //	memset(&audiodata,0x0,sizeof(audiodata));
-	audiodata.audiobuf_fill = 0;
 	audiodata.audiofd_fragsize = 0;
 	audiodata.source = 0;
 	audiodata.buffer1 = audiodata.buffer2 = 0;
-	if (audiobuf)
-	{
-		free(audiobuf);
-		audiobuf = nullptr;
-	}
 }
 
 // Retrieves the current time with millisecond accuracy
@@ -262,28 +286,6 @@ static double getRelativeTime(void)
 const size_t texture_width = 1024;
 const size_t texture_height = 1024;
 
-/** Allocates memory to hold the decoded video frame
- */
-static void Allocate_videoFrame(void)
-{
-	int size = videodata.ti.frame_width * videodata.ti.frame_height * 4;
-	if (!seq_getScanlinesDisabled() && seq_getScanlineMode())
-	{
-		size *= 2;
-	}
-
-	RGBAframe = (uint32_t *)malloc(size);
-	memset(RGBAframe, 0, size);
-}
-
-static void deallocateVideoFrame(void)
-{
-	if (RGBAframe)
-	{
-		free(RGBAframe);
-	}
-}
-
 #ifndef __BIG_ENDIAN__
 const int Rshift = 0;
 const int Gshift = 8;
@@ -300,88 +302,262 @@ const int Ashift = 0;
 const int RGBmask = 0x7f7f7f00;
 const int Amask = 0x000000ff;
 #endif
-#define Vclip( x )	( (x > 0) ? ((x < 255) ? x : 255) : 0 )
-// main routine to display video on screen.
-static void video_write(bool update)
+
+static inline uint32_t Vclip(int x)
+{
+	return std::min(std::max(x, 0), 255);
+}
+
+/** Converts a decoded frame to RGBA, adding scanlines if wanted.
+ *  Each row is converted in a simple loop without branches, which compilers turn into vector code.
+ */
+static void convertFrame(yuv_buffer const &yuv, uint32_t *RGBAframe)
 {
-	unsigned int x = 0, y = 0;
 	const int video_width = videodata.ti.frame_width;
 	const int video_height = videodata.ti.frame_height;
-	SCANLINE_MODE scanMode = seq_getScanlinesDisabled() ? SCANLINES_OFF : seq_getScanlineMode();
-	// when using scanlines we need to double the height
-	const int height_factor = (scanMode ? 2 : 1);
-	yuv_buffer yuv;
 
-	if (update)
+	for (int y = 0; y < video_height; y++)
 	{
-		int rgb_offset = 0;
-		int y_offset = 0;
-		int uv_offset = 0;
-		const int half_width = video_width / 2;
+		const unsigned char *Yrow = yuv.y + y * yuv.y_stride;
+		const unsigned char *Urow = yuv.u + (y >> 1) * yuv.uv_stride;
+		const unsigned char *Vrow = yuv.v + (y >> 1) * yuv.uv_stride;
+		uint32_t *row = RGBAframe + y * video_width * (videoScanMode ? 2 : 1);
 
-		theora_decode_YUVout(&videodata.td, &yuv);
-
-		// fill the RGBA buffer
-		for (y = 0; y < video_height; y++)
+		for (int x = 0; x < video_width; x++)
 		{
-			y_offset = y * yuv.y_stride;
-			uv_offset = (y >> 1) * yuv.uv_stride;
+			const int A = 298 * (Yrow[x] - 16);
+			const int U = Urow[x >> 1] - 128;
+			const int C = 409 * (Vrow[x >> 1] - 128);
 
-			for (x = 0; x < half_width; x++)
-			{
-				int Y = yuv.y[y_offset++] - 16;
-				const int U = yuv.u[uv_offset] - 128;
-				const int V = yuv.v[uv_offset++] - 128;
+			const uint32_t R = Vclip((A + C + 128) >> 8);
+			const uint32_t G = Vclip((A - 100 * U - (C >> 1) + 128) >> 8);
+			const uint32_t B = Vclip((A + 516 * U + 128) >> 8);
 
-				int A = 298 * Y;
-				const int C = 409 * V;
+			row[x] = (R << Rshift) | (G << Gshift) | (B << Bshift) | (0xFFu << Ashift);
+		}
 
-				int R = Vclip((A + C + 128) >> 8);
-				int G = Vclip((A - 100 * U - (C >> 1) + 128) >> 8);
-				int B = Vclip((A + 516 * U + 128) >> 8);
+		if (videoScanMode == SCANLINES_50)
+		{
+			// halve the rgb values for a dimmed scanline
+			for (int x = 0; x < video_width; x++)
+			{
+				row[video_width + x] = (row[x] >> 1 & RGBmask) | Amask;
+			}
+		}
+		else if (videoScanMode == SCANLINES_BLACK)
+		{
+			std::fill(row + video_width, row + 2 * video_width, (uint32_t)Amask);
+		}
+	}
+}
 
-				uint32_t rgba = (R << Rshift) | (G << Gshift) | (B << Bshift) | (0xFF << Ashift);
+/** Decodes the next video frame into psFrame.
+ *  \return false if more data must be read first
+ */
+static bool decodeVideoFrame(DecodedFrame *psFrame)
+{
+	ogg_packet op;
+	yuv_buffer yuv;
 
-				RGBAframe[rgb_offset] = rgba;
-				if (scanMode == SCANLINES_50)
-				{
-					// halve the rgb values for a dimmed scanline
-					RGBAframe[rgb_offset + video_width] = (rgba >> 1 & RGBmask) | Amask;
-				}
-				else if (scanMode == SCANLINES_BLACK)
-				{
-					RGBAframe[rgb_offset + video_width] = Amask;
-				}
-				rgb_offset++;
+	/* theora is one in, one out... */
+	if (ogg_stream_packetout(&videodata.to, &op) <= 0)
+	{
+		return false;
+	}
+	theora_decode_packetin(&videodata.td, &op);
+	psFrame->time = theora_granule_time(&videodata.td, videodata.td.granulepos);
+	theora_decode_YUVout(&videodata.td, &yuv);
+	convertFrame(yuv, psFrame->rgba.data());
+	return true;
+}
 
-				// second pixel, U and V (and thus C) are the same as before.
-				Y = yuv.y[y_offset++] - 16;
-				A = 298 * Y;
+/** Decodes audio until pendingAudio holds a whole fragment.
+ *  \return false if more data must be read first
+ */
+static bool decodeAudio()
+{
+	const size_t fragmentSize = audiodata.audiofd_fragsize / 2;
+	const int channels = videodata.vi.channels;
+	ogg_packet op;
+	float **pcm;
+	int ret;
 
-				R = Vclip((A + C + 128) >> 8);
-				G = Vclip((A - 100 * U - (C >> 1) + 128) >> 8);
-				B = Vclip((A + 516 * U + 128) >> 8);
+	while (pendingAudio.pcm.size() < fragmentSize)
+	{
+		/* if there's pending, decoded audio, grab it */
+		if ((ret = vorbis_synthesis_pcmout(&videodata.vd, &pcm)) > 0)
+		{
+			// we now have float pcm data in pcm
+			// going to convert that to int pcm in the fragment
+			const int maxsamples = (fragmentSize - pendingAudio.pcm.size()) / channels;
+			int i;
 
-				rgba = (R << Rshift) | (G << Gshift) | (B << Bshift) | (0xFF << Ashift);
-				RGBAframe[rgb_offset] = rgba;
-				if (scanMode == SCANLINES_50)
-				{
-					// halve the rgb values for a dimmed scanline
-					RGBAframe[rgb_offset + video_width] = (rgba >> 1 & RGBmask) | Amask;
-				}
-				else if (scanMode == SCANLINES_BLACK)
+			for (i = 0; i < ret && i < maxsamples; i++)
+			{
+				for (int j = 0; j < channels; j++)
 				{
-					RGBAframe[rgb_offset + video_width] = Amask;
+					int val = nearbyint(pcm[j][i] * 32767.f);
+					pendingAudio.pcm.push_back(std::min(std::max(val, -32768), 32767));
 				}
-				rgb_offset++;
 			}
-			if (scanMode)
+
+			vorbis_synthesis_read(&videodata.vd, i);
+
+			if (videodata.vd.granulepos >= 0)
 			{
-				rgb_offset += video_width;
+				pendingAudio.granulepos = videodata.vd.granulepos - ret + i;
 			}
+			else
+			{
+				pendingAudio.granulepos += i;
+			}
+		}
+		/* no pending audio; is there a pending packet to decode? */
+		else if (ogg_stream_packetout(&videodata.vo, &op) > 0)
+		{
+			if (vorbis_synthesis(&videodata.vb, &op) == 0)
+			{
+				/* test for success! */
+				vorbis_synthesis_blockin(&videodata.vd, &videodata.vb);
+			}
+		}
+		else
+		{
+			/* we need more data; break out to suck in another page */
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Decodes a video frame and an audio fragment, or reads another page of the file if there was no data.
+ *  Called with decodeMutex held through lock, which is released while decoding.
+ *  \return false if there is no room in the queues, or nothing left to decode.
+ */
+static bool seq_DecodeStep(std::unique_lock<wz::mutex> &lock)
+{
+	const bool needVideo = !decodeVideoEnd && decodedFrames.size() < VIDEO_FRAME_QUEUE_LENGTH;
+	const bool needAudio = !decodeAudioEnd && decodedAudio.size() < AUDIO_QUEUE_LENGTH;
+	if (!needVideo && !needAudio)
+	{
+		return false;
+	}
+	if (needVideo && decodeFrame.rgba.empty())
+	{
+		if (!freeFrames.empty())
+		{
+			decodeFrame.rgba = std::move(freeFrames.back());
+			freeFrames.pop_back();
+		}
+		decodeFrame.rgba.resize(videodata.ti.frame_width * videodata.ti.frame_height * (videoScanMode ? 2 : 1));
+	}
+	lock.unlock();
+
+	const bool gotVideo = needVideo && decodeVideoFrame(&decodeFrame);
+	const bool gotAudio = needAudio && decodeAudio();
+	if (!gotVideo && !gotAudio)
+	{
+		/* no data yet for somebody.  Grab another page */
+		decodeFileEnd = buffer_data(fpInfile, &videodata.oy) == 0;
+		while (ogg_sync_pageout(&videodata.oy, &videodata.og) > 0)
+		{
+			queue_page(&videodata.og);
+		}
+	}
+
+	lock.lock();
+	if (gotVideo)
+	{
+		decodedFrames.push_back(std::move(decodeFrame));
+		decodeFrame = DecodedFrame();
+	}
+	if (gotAudio || (decodeFileEnd && needAudio && !pendingAudio.pcm.empty()))
+	{
+		DecodedAudio next;
+		next.granulepos = pendingAudio.granulepos;
+		decodedAudio.push_back(std::move(pendingAudio));
+		pendingAudio = std::move(next);
+	}
+	if (decodeFileEnd)
+	{
+		// Streams which wanted more data have nothing left to decode.
+		decodeVideoEnd = decodeVideoEnd || (needVideo && !gotVideo);
+		decodeAudioEnd = decodeAudioEnd || (needAudio && !gotAudio);
+	}
+	decodeEnd = decodeVideoEnd && decodeAudioEnd;
+	return true;
+}
+
+/** Reads and decodes the file, while there is room in the queues.
+ */
+static int seq_DecodeThreadFunc(void *)
+{
+	std::unique_lock<wz::mutex> lock(decodeMutex);
+	while (!decodeQuit)
+	{
+		if (!seq_DecodeStep(lock))
+		{
+			// Wait until seq_Update() takes something from a queue.
+			lock.unlock();
+			wzSemaphoreWait(decodeSemaphore);
+			lock.lock();
 		}
+	}
+	return 0;
+}
 
-		videoGfx->updateTexture(RGBAframe, static_cast<size_t>(video_width), static_cast<size_t>(video_height) * static_cast<size_t>(height_factor));
+/** Starts decoding the file on a thread, once all headers were read.
+ */
+static void seq_StartDecoding()
+{
+	decodeQuit = false;
+	decodeEnd = false;
+	decodeVideoEnd = !theora_p;
+	decodeAudioEnd = !vorbis_p;
+	decodeFileEnd = false;
+	decodeFrame = DecodedFrame();
+	pendingAudio = DecodedAudio();
+	pendingAudio.pcm.reserve(audiodata.audiofd_fragsize / 2);
+	decodeSemaphore = wzSemaphoreCreate(0);
+	decodeThread = wzThreadCreate(seq_DecodeThreadFunc, nullptr);
+	if (decodeThread != nullptr)
+	{
+		wzThreadStart(decodeThread);
+	}
+	else
+	{
+		debug(LOG_WARNING, "Could not create the video decoding thread, decoding on the main thread");
+	}
+}
+
+static void seq_StopDecoding()
+{
+	if (decodeThread != nullptr)
+	{
+		{
+			std::lock_guard<wz::mutex> lock(decodeMutex);
+			decodeQuit = true;
+		}
+		wzSemaphorePost(decodeSemaphore);
+		wzThreadJoin(decodeThread);
+		decodeThread = nullptr;
+	}
+	wzSemaphoreDestroy(decodeSemaphore);
+	decodeSemaphore = nullptr;
+
+	decodedFrames.clear();
+	decodedAudio.clear();
+	freeFrames.clear();
+	decodeFrame = DecodedFrame();
+	pendingAudio = DecodedAudio();
+}
+
+// main routine to display video on screen, RGBAframe is the new frame to show, if any.
+static void video_write(uint32_t const *RGBAframe)
+{
+	if (RGBAframe != nullptr)
+	{
+		videoGfx->updateTexture(RGBAframe, static_cast<size_t>(videodata.ti.frame_width), static_cast<size_t>(videodata.ti.frame_height) * (videoScanMode ? 2 : 1));
 	}
 
 	const auto& modelViewProjectionMatrix = glm::ortho(0.f, static_cast<float>(pie_GetVideoBufferWidth()), static_cast<float>(pie_GetVideoBufferHeight()), 0.f) *
@@ -397,55 +573,63 @@ static void video_write(bool update)
 static void audio_write(void)
 {
 	ALint processed = 0;
-	ALint queued = 0;
+	DecodedAudio chunk;
 
 	alGetSourcei(audiodata.source, AL_BUFFERS_PROCESSED, &processed);
-	alGetSourcei(audiodata.source, AL_BUFFERS_QUEUED, &queued);
-	if ((audiodata.totbufstarted < 2 || processed) && audiodata.audiobuf_fill > 0)
+	if (audiodata.totbufstarted >= 2 && !processed)
 	{
-		// we have audiobuf_fill bytes of data
-		ALuint oldbuffer = 0;
-
-		if (audiodata.totbufstarted == 0)
-		{
-			oldbuffer = audiodata.buffer1;
-		}
-		else if (audiodata.totbufstarted == 1)
-		{
-			oldbuffer = audiodata.buffer2;
-		}
-		else
+		return;
+	}
+	{
+		std::lock_guard<wz::mutex> lock(decodeMutex);
+		if (decodedAudio.empty())
 		{
-			ALint buffer_size = 0;
-			ogg_int64_t current_sample = 0;
-
-			alSourceUnqueueBuffers(audiodata.source, 1, &oldbuffer);
-			alGetBufferi(oldbuffer, AL_SIZE, &buffer_size);
-			// audio time sync
-			audioTime += (double) buffer_size / (videodata.vi.rate * videodata.vi.channels);
-			debug(LOG_VIDEO, "Audio sync");
-			current_sample = audiobuf_granulepos - audiodata.audiobuf_fill / 2 / videodata.vi.channels;
-			sampletimeOffset -= getTimeNow() - 1000 * current_sample / videodata.vi.rate;
+			return;
 		}
+		chunk = std::move(decodedAudio.front());
+		decodedAudio.pop_front();
+	}
+	wzSemaphorePost(decodeSemaphore);
 
-		alBufferData(oldbuffer, (videodata.vi.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16),
-		             audiobuf, audiodata.audiobuf_fill, videodata.vi.rate);
+	// we have chunk.pcm.size() samples of data
+	ALuint oldbuffer = 0;
 
-		alSourceQueueBuffers(audiodata.source, 1, &oldbuffer);
-		audiodata.totbufstarted++;
-		if (audiodata.totbufstarted > 2)
-		{
-			audiodata.totbufstarted = 2;
-		}
+	if (audiodata.totbufstarted == 0)
+	{
+		oldbuffer = audiodata.buffer1;
+	}
+	else if (audiodata.totbufstarted == 1)
+	{
+		oldbuffer = audiodata.buffer2;
+	}
+	else
+	{
+		ALint buffer_size = 0;
+		ogg_int64_t current_sample = 0;
+
+		alSourceUnqueueBuffers(audiodata.source, 1, &oldbuffer);
+		alGetBufferi(oldbuffer, AL_SIZE, &buffer_size);
+		// audio time sync
+		audioTime += (double) buffer_size / (videodata.vi.rate * videodata.vi.channels);
+		debug(LOG_VIDEO, "Audio sync");
+		current_sample = chunk.granulepos - chunk.pcm.size() / videodata.vi.channels;
+		sampletimeOffset -= getTimeNow() - 1000 * current_sample / videodata.vi.rate;
+	}
 
-		if (sourcestate != AL_PLAYING)
-		{
-			debug(LOG_VIDEO, "starting source\n");
-			alSourcePlay(audiodata.source);
-		}
+	alBufferData(oldbuffer, (videodata.vi.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16),
+	             chunk.pcm.data(), chunk.pcm.size() * sizeof(ogg_int16_t), videodata.vi.rate);
 
-		audiobuf_ready = false;
-		audiodata.audiobuf_fill = 0;
+	alSourceQueueBuffers(audiodata.source, 1, &oldbuffer);
+	audiodata.totbufstarted++;
+	if (audiodata.totbufstarted > 2)
+	{
+		audiodata.totbufstarted = 2;
+	}
+
+	if (sourcestate != AL_PLAYING)
+	{
+		debug(LOG_VIDEO, "starting source\n");
+		alSourcePlay(audiodata.source);
 	}
 }
 
@@ -460,18 +644,10 @@ static void seq_InitOgg(void)
 	videoplaying = false;
 	seq_setScanlinesDisabled(false);
 
-	/* single frame video buffering */
-	videobuf_ready = false;
-	videobuf_granulepos = -1;
 	videobuf_time = 0;
 	frames = 0;
 	dropped = 0;
 
-	/* single audio fragment audio buffering */
-	audiodata.audiobuf_fill = 0;
-	audiobuf_ready = false;
-
-	audiobuf_granulepos = 0;	/* time position of last sample */
 	audioTime = 0;
 
 	sampletimeOffset = 0;
@@ -702,12 +878,12 @@ bool seq_Play(const char *filename)
 			seq_setScanlinesDisabled(true);
 		}
 
-		Allocate_videoFrame();
 		videoGfx->makeTexture(texture_width, texture_height, gfx_api::pixel_format::FORMAT_RGBA8_UNORM_PACK8, blackframe);
 		free(blackframe);
 
 		// when using scanlines we need to double the height
-		const uint32_t height_factor = ((!seq_getScanlinesDisabled() && seq_getScanlineMode()) ? 2 : 1);
+		videoScanMode = seq_getScanlinesDisabled() ? SCANLINES_OFF : seq_getScanlineMode();
+		const uint32_t height_factor = (videoScanMode ? 2 : 1);
 		const gfx_api::gfxFloat vtwidth = (float)videodata.ti.frame_width / (float)texture_width;
 		const gfx_api::gfxFloat vtheight = (float)videodata.ti.frame_height * height_factor / (float)texture_height;
 		gfx_api::gfxFloat texcoords[NUM_VERTICES * 2] = { 0.0f, 0.0f, vtwidth, 0.0f, 0.0f, vtheight, vtwidth, vtheight };
@@ -720,6 +896,7 @@ bool seq_Play(const char *filename)
 		assumption in Ogg A/V streams! It will always be true of the
 		example_encoder (and most streams) though. */
 	sampletimeOffset = getTimeNow();
+	seq_StartDecoding();
 	videoplaying = true;
 	return true;
 }
@@ -735,174 +912,96 @@ bool seq_Playing()
  */
 bool seq_Update()
 {
-	ogg_packet op;
-	int ret;
-	int i, j;
-	float   **pcm;
-	int count, maxsamples;
+	DecodedFrame frame;
+	bool newFrame = false;
+	bool finished;
 
-	/* we want a video and audio frame ready to go at all times.  If
-		   we have to buffer incoming, buffer the compressed data (ie, let
-		   ogg do the buffering) */
+	/* the decoder thread keeps a few video frames and audio fragments ready to go,
+	   we only pick the ones which are due */
 	if (!videoplaying)
 	{
 		debug(LOG_VIDEO, "no movie playing");
 		return false;
 	}
 
-	while (vorbis_p && !audiobuf_ready)
 	{
-		/* if there's pending, decoded audio, grab it */
-		if ((ret = vorbis_synthesis_pcmout(&videodata.vd, &pcm)) > 0)
+		std::unique_lock<wz::mutex> lock(decodeMutex);
+		if (decodeThread == nullptr)
 		{
-			// we now have float pcm data in pcm
-			// going to convert that to int pcm in audiobuf
-			count = audiodata.audiobuf_fill / 2;
-			maxsamples = (audiodata.audiofd_fragsize - audiodata.audiobuf_fill) / 2 / videodata.vi.channels;
-
-			for (i = 0; i < ret && i < maxsamples; i++)
-			{
-				for (j = 0; j < videodata.vi.channels; j++)
-				{
-					int val = nearbyint(pcm[j][i] * 32767.f);
-
-					if (val > 32767)
-					{
-						val = 32767;
-					}
-					else if (val < -32768)
-					{
-						val = -32768;
-					}
-					audiobuf[count++] = val;
-				}
-			}
-
-			vorbis_synthesis_read(&videodata.vd, i);
-			audiodata.audiobuf_fill += i * videodata.vi.channels * 2;
-
-			if (audiodata.audiobuf_fill == audiodata.audiofd_fragsize)
-			{
-				audiobuf_ready = true;
-			}
-
-			if (videodata.vd.granulepos >= 0)
-			{
-				audiobuf_granulepos = videodata.vd.granulepos - ret + i;
-			}
-			else
-			{
-				audiobuf_granulepos += i;
-			}
+			// No decoding thread, so fill the queues here.
+			while (seq_DecodeStep(lock)) {}
 		}
-		else
+		if (vorbis_p && audio_Disabled() && !decodedAudio.empty())
 		{
-			/* no pending audio; is there a pending packet to decode? */
-			if (ogg_stream_packetout(&videodata.vo, &op) > 0)
-			{
-				if (vorbis_synthesis(&videodata.vb, &op) == 0)
-				{
-					/* test for success! */
-					vorbis_synthesis_blockin(&videodata.vd, &videodata.vb);
-				}
-			}
-			else
-			{
-				/* we need more data; break out to suck in another page */
-				break;
-			}
+			// nobody will play it
+			decodedAudio.clear();
+			wzSemaphorePost(decodeSemaphore);
 		}
-	}
-
-	while (theora_p && !videobuf_ready)
-	{
-		/* theora is one in, one out... */
-		if (ogg_stream_packetout(&videodata.to, &op) > 0)
-		{
-			double now_time = 0;
-			double delay = 0;
 
-			theora_decode_packetin(&videodata.td, &op);
-			videobuf_granulepos = videodata.td.granulepos;
-			videobuf_time = theora_granule_time(&videodata.td, videobuf_granulepos);
-
-			now_time = getRelativeTime();
-			delay = videobuf_time - getRelativeTime();
-
-			if ((delay >= 0.0f) || (now_time - last_time >= 1.0f))
-			{
-				videobuf_ready = true;
-				seq_SetFrameNumber(seq_GetFrameNumber() + 1);
-			}
-			else
-			{
-				// running slow, so we skip this frame
-				dropped++;
-			}
-		}
-		else
+		/* if our buffers either don't exist or are ready to go,
+		   we can begin playback, same if we've run out of input */
+		if (!stateflag && (((!theora_p || !decodedFrames.empty()) && (!vorbis_p || !decodedAudio.empty() || audio_Disabled())) || decodeEnd))
 		{
-			break;
+			debug(LOG_VIDEO, "all buffers ready");
+			stateflag = true;
 		}
+
+		finished = decodeEnd && decodedFrames.empty() && (decodedAudio.empty() || audio_Disabled());
 	}
 
 	alGetSourcei(audiodata.source, AL_SOURCE_STATE, &sourcestate);
 
-	if (PHYSFS_eof(fpInfile)
-		&& !videobuf_ready
-		&& ((!audiobuf_ready && (audiodata.audiobuf_fill == 0)) || audio_Disabled())
-		&& sourcestate != AL_PLAYING)
+	if (finished && sourcestate != AL_PLAYING)
 	{
-		video_write(false);
+		video_write(nullptr);
 		seq_Shutdown();
 		debug(LOG_VIDEO, "video finished");
 		return false;
 	}
 
-	if (!videobuf_ready || !audiobuf_ready)
+	if (!stateflag)
 	{
-		/* no data yet for somebody.  Grab another page */
-		ret = buffer_data(fpInfile, &videodata.oy);
-		while (ogg_sync_pageout(&videodata.oy, &videodata.og) > 0)
-		{
-			queue_page(&videodata.og);
-		}
+		return true;
 	}
 
 	/* If playback has begun, top audio buffer off immediately. */
-	if (vorbis_p
-	    && stateflag
-	    // FIXME : it is possible to crash if people are playing with no sound.
-	    && !audio_Disabled())
+	if (vorbis_p && !audio_Disabled())
 	{
 		// play the data in pcm
 		audio_write();
 	}
 
-	/* are we at or past time for this video frame? */
-	if (stateflag && videobuf_ready && (videobuf_time <= getRelativeTime()))
+	/* show the last frame which is due, frames before it are late and skipped */
 	{
-		video_write(true);
-		last_time = getRelativeTime();
-		videobuf_ready = false;
-	}
-	else if (stateflag)
-	{
-		video_write(false);
+		const double now = getRelativeTime();
+		std::lock_guard<wz::mutex> lock(decodeMutex);
+		while (!decodedFrames.empty() && decodedFrames.front().time <= now)
+		{
+			if (newFrame)
+			{
+				// running slow, so we skip this frame
+				freeFrames.push_back(std::move(frame.rgba));
+				dropped++;
+			}
+			frame = std::move(decodedFrames.front());
+			decodedFrames.pop_front();
+			newFrame = true;
+		}
 	}
 
-	/* if our buffers either don't exist or are ready to go,
-		   we can begin playback */
-	if ((!theora_p || videobuf_ready) && (!vorbis_p || audiobuf_ready) && !stateflag)
+	if (newFrame)
 	{
-		debug(LOG_VIDEO, "all buffers ready");
-		stateflag = true;
-	}
+		wzSemaphorePost(decodeSemaphore);
+		video_write(frame.rgba.data());
+		videobuf_time = frame.time;
+		seq_SetFrameNumber(seq_GetFrameNumber() + 1);
 
-	/* same if we've run out of input */
-	if (PHYSFS_eof(fpInfile))
+		std::lock_guard<wz::mutex> lock(decodeMutex);
+		freeFrames.push_back(std::move(frame.rgba));
+	}
+	else
 	{
-		stateflag = true;
+		video_write(nullptr);
 	}
 
 	return true;
@@ -918,6 +1017,7 @@ void seq_Shutdown()
 		debug(LOG_VIDEO, "movie is not playing");
 		return;
 	}
+	seq_StopDecoding();
 	delete videoGfx;
 	videoGfx = nullptr;
 
@@ -942,7 +1042,6 @@ void seq_Shutdown()
 		theora_clear(&videodata.td);
 		theora_comment_clear(&videodata.tc);
 		theora_info_clear(&videodata.ti);
-		deallocateVideoFrame();
 	}
 
 	ogg_sync_clear(&videodata.oy);
@@ -957,7 +1056,7 @@ void seq_Shutdown()
 	Timer_stop();
 
 	audioTime = 0;
-	sampletimeOffset = last_time = timer_expire = timer_started = 0;
+	sampletimeOffset = timer_expire = timer_started = 0;
 	basetime = -1;
 
 	debug(LOG_VIDEO, " **** frames = %d dropped = %d ****", frames, dropped);
@@ -30,6 +30,11 @@
 #include "audio_id.h"
 #include "openal_error.h"
 #include "mixer.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 // defines
 #define NO_SAMPLE				- 2
 #define MAX_SAME_SAMPLES		2
@@ -41,6 +46,10 @@ static bool			g_bAudioEnabled = false;
 static bool			g_bAudioPaused = false;
 static AUDIO_SAMPLE g_sPreviousSample;
 static int			g_iPreviousSampleTime = 0;
+static std::unordered_map<int, std::vector<AUDIO_SAMPLE *>> g_sameTrackSamples;  // Samples in g_psSampleList, by track
+static Vector3f		g_listenerPos(0.f, 0.f, 0.f);
+static float		g_fEffectsVolume = -1.f;
+static bool			g_bListenerMoved = true;  // Or the effects volume changed, so all gains need updating
 
 /** Counts the number of samples in the SampleQueue
  *  \return the number of samples in the SampleQueue
@@ -155,6 +164,8 @@ bool audio_Shutdown(void)
 
 	// free sample heap
 	g_psSampleList = nullptr;
+	g_sameTrackSamples.clear();
+	g_fEffectsVolume = -1.f;  // Make audio_Update() set the listener position again
 	g_psSampleQueue = nullptr;
 
 	return bOK;
@@ -283,6 +294,31 @@ static void audio_RemoveSample(AUDIO_SAMPLE **ppsSampleList, AUDIO_SAMPLE *psSam
 	psSample->psNext = nullptr;
 }
 
+/** Adds the sample to the list of playing samples, and to the samples playing its track. */
+static void audio_AddPlayingSample(AUDIO_SAMPLE *psSample)
+{
+	audio_AddSampleToHead(&g_psSampleList, psSample);
+	g_sameTrackSamples[psSample->iTrack].push_back(psSample);
+}
+
+/** Removes the sample from the list of playing samples, but doesn't free its memory. */
+static void audio_RemovePlayingSample(AUDIO_SAMPLE *psSample)
+{
+	audio_RemoveSample(&g_psSampleList, psSample);
+	auto it = g_sameTrackSamples.find(psSample->iTrack);
+	if (it == g_sameTrackSamples.end())
+	{
+		return;
+	}
+	std::vector<AUDIO_SAMPLE *> &samples = it->second;
+	auto sample = std::find(samples.begin(), samples.end(), psSample);
+	if (sample != samples.end())
+	{
+		*sample = samples.back();
+		samples.pop_back();
+	}
+}
+
 //*
 // =======================================================================================================================
 // =======================================================================================================================
@@ -531,7 +567,7 @@ static void audio_UpdateQueue(void)
 		return;
 	}
 
-	audio_AddSampleToHead(&g_psSampleList, psSample);
+	audio_AddPlayingSample(psSample);
 
 	// update last queue sound coords
 	if (psSample->x != SAMPLE_COORD_INVALID && psSample->y != SAMPLE_COORD_INVALID
@@ -566,7 +602,13 @@ void audio_Update()
 	// get player position
 	playerPos = audio_GetPlayerPos();
 	audio_Get3DPlayerRotAboutVerticalAxis(&angle);
-	sound_SetPlayerPos(playerPos);
+	g_bListenerMoved = playerPos != g_listenerPos || sound_GetEffectsVolume() != g_fEffectsVolume;
+	g_listenerPos = playerPos;
+	g_fEffectsVolume = sound_GetEffectsVolume();
+	if (g_bListenerMoved)
+	{
+		sound_SetPlayerPos(playerPos);
+	}
 	sound_SetPlayerOrientation(angle);
 
 	// loop through 3D sounds and remove if finished or update position
@@ -577,7 +619,7 @@ void audio_Update()
 		if (psSample->bFinishedPlaying == true)
 		{
 			psSampleTemp = psSample->psNext;
-			audio_RemoveSample(&g_psSampleList, psSample);
+			audio_RemovePlayingSample(psSample);
 			free(psSample);
 			psSample = psSampleTemp;
 		}
@@ -595,8 +637,16 @@ void audio_Update()
 				}
 				else	// update sample position
 				{
-					audio_GetObjectPos(psSample->psObj, &psSample->x, &psSample->y, &psSample->z);
-					sound_SetObjectPosition(psSample);
+					// The gain only needs recomputing if the object or the listener moved
+					SDWORD iX, iY, iZ;
+					audio_GetObjectPos(psSample->psObj, &iX, &iY, &iZ);
+					if (g_bListenerMoved || iX != psSample->x || iY != psSample->y || iZ != psSample->z)
+					{
+						psSample->x = iX;
+						psSample->y = iY;
+						psSample->z = iZ;
+						sound_SetObjectPosition(psSample);
+					}
 				}
 			}
 			// next sample
@@ -640,48 +690,34 @@ unsigned int audio_SetTrackVals(const char *fileName, bool loop, unsigned int vo
 //
 static bool audio_CheckSame3DTracksPlaying(SDWORD iTrack, SDWORD iX, SDWORD iY, SDWORD iZ)
 {
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-	SDWORD			iCount, iDx, iDy, iDz, iDistSq, iMaxDistSq, iRad;
-	AUDIO_SAMPLE	*psSample = nullptr;
-	bool			bOK = true;
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
 	// return if audio not enabled
 	if (g_bAudioEnabled == false || g_bAudioPaused == true)
 	{
 		return true;
 	}
 
-	iCount = 0;
+	auto it = g_sameTrackSamples.find(iTrack);
+	if (it == g_sameTrackSamples.end() || it->second.size() <= MAX_SAME_SAMPLES)
+	{
+		return true;
+	}
 
-	// loop through 3D sounds and check whether too many already in earshot
-	psSample = g_psSampleList;
-	while (psSample != nullptr)
+	// check whether too many samples of this track already in earshot
+	SDWORD iRad = sound_GetTrackAudibleRadius(iTrack);
+	SDWORD iMaxDistSq = iRad * iRad;
+	SDWORD iCount = 0;
+	for (AUDIO_SAMPLE *psSample : it->second)
 	{
-		if (psSample->iTrack == iTrack)
+		SDWORD iDx = iX - psSample->x;
+		SDWORD iDy = iY - psSample->y;
+		SDWORD iDz = iZ - psSample->z;
+		if ((iDx * iDx) + (iDy * iDy) + (iDz * iDz) < iMaxDistSq && ++iCount > MAX_SAME_SAMPLES)
 		{
-			iDx = iX - psSample->x;
-			iDy = iY - psSample->y;
-			iDz = iZ - psSample->z;
-			iDistSq = (iDx * iDx) + (iDy * iDy) + (iDz * iDz);
-			iRad = sound_GetTrackAudibleRadius(iTrack);
-			iMaxDistSq = iRad * iRad;
-			if (iDistSq < iMaxDistSq)
-			{
-				iCount++;
-			}
-
-			if (iCount > MAX_SAME_SAMPLES)
-			{
-				bOK = false;
-				break;
-			}
+			return false;
 		}
-
-		psSample = psSample->psNext;
 	}
 
-	return bOK;
+	return true;
 }
 
 //*
@@ -692,10 +728,9 @@ static bool audio_Play3DTrack(SDWORD iX, SDWORD iY, SDWORD iZ, int iTrack, SIMPL
 {
 	AUDIO_SAMPLE	*psSample;
 	// coordinates
-	float	listenerX = .0f, listenerY = .0f, listenerZ = .0f, dX, dY, dZ;
+	float	dX, dY, dZ;
 	// calculation results
 	float	distance, gain;
-	ALenum err;
 
 	// if audio not enabled return true to carry on game without audio
 	if (g_bAudioEnabled == false || g_bAudioPaused == true)
@@ -708,17 +743,10 @@ static bool audio_Play3DTrack(SDWORD iX, SDWORD iY, SDWORD iZ, int iTrack, SIMPL
 		return false;
 	}
 
-	// compute distance
-	// NOTE, if this call fails, expect garbage
-	alGetListener3f(AL_POSITION, &listenerX, &listenerY, &listenerZ);
-	err = sound_GetError();
-	if (err != AL_NO_ERROR)
-	{
-		return false;
-	}
-	dX = (float)iX - listenerX; // distances on all axis
-	dY = (float)iY - listenerY;
-	dZ = (float)iZ - listenerZ;
+	// compute distance, from the listener position set by the last audio_Update()
+	dX = (float)iX - g_listenerPos.x; // distances on all axis
+	dY = (float)iY - g_listenerPos.y;
+	dZ = (float)iZ - g_listenerPos.z;
 	distance = sqrtf(dX * dX + dY * dY + dZ * dZ); // Pythagorean theorem
 
 	// compute gain
@@ -762,7 +790,7 @@ static bool audio_Play3DTrack(SDWORD iX, SDWORD iY, SDWORD iZ, int iTrack, SIMPL
 		return false;
 	}
 
-	audio_AddSampleToHead(&g_psSampleList, psSample);
+	audio_AddPlayingSample(psSample);
 	return true;
 }
 
@@ -976,7 +1004,7 @@ void audio_PlayTrack(int iTrack)
 		return;
 	}
 
-	audio_AddSampleToHead(&g_psSampleList, psSample);
+	audio_AddPlayingSample(psSample);
 }
 
 //*
@@ -1165,7 +1193,7 @@ void audio_RemoveObj(SIMPLE_OBJECT const *psObj)
 			sound_RemoveActiveSample(toRemove);   //remove from global active list.
 
 			// Perform the actual task of destroying this sample
-			audio_RemoveSample(&g_psSampleList, toRemove);
+			audio_RemovePlayingSample(toRemove);
 			free(toRemove);
 
 			// Increment the deletion count
@@ -35,9 +35,17 @@
 
 #include <physfs.h>
 #include "lib/framework/physfs_ext.h"
+#include "lib/framework/wzapp.h"
 #include <string.h>
 #include <math.h>
+#include <algorithm>
+#include <deque>
 #include <limits>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "tracklib.h"
 #include "audio.h"
@@ -47,6 +55,10 @@
 #include "mixer.h"
 #include "openal_info.h"
 
+#define TRACK_DECODE_THREADS      3                  // Sound effects are decoded on this many threads while loading
+#define PCM_CACHE_SIZE            (32 * 1024 * 1024) // Bytes of decoded sound effects to keep, for when the tracks are loaded again
+#define PCM_CACHE_MAX_TRACK_SIZE  (2 * 1024 * 1024)  // Decoded tracks larger than this aren't kept
+
 static ALuint current_queue_sample = -1;
 
 static bool openal_initialized = false;
@@ -64,10 +76,60 @@ struct AUDIO_STREAM
 
 	size_t                  bufferSize = 0;
 
+	// Decoding ahead on the stream decoder thread, guarded by streamDecodeMutex
+	std::deque<soundDataBuffer *> decoded;      // Decoded buffers, waiting to be queued on the source
+	unsigned int            decodeAhead = 0;    // Number of buffers to keep decoded
+	bool                    decoding = false;   // The decoder is in use, see sound_LockStreamDecoder()
+	bool                    decoderWanted = false;  // The main thread waits for the decoder thread to finish with the decoder
+	bool                    decodedEnd = false; // The decoder has reached the end of the file
+	bool                    stopRequested = false;  // Stopped by sound_StopStream(), rather than by running out of buffers
+
 	// Linked list pointer
 	AUDIO_STREAM           *next = nullptr;
 };
 
+/* Streams are decoded ahead on their own thread, so music and speech don't cause hitches in the main loop.
+ * The list of active streams is only changed on the main thread, with this mutex locked.
+ */
+static wz::mutex streamDecodeMutex;
+static WZ_THREAD *streamDecodeThread = nullptr;
+static WZ_SEMAPHORE *streamDecodeSemaphore = nullptr;  // Posted when a stream may need more buffers decoded
+static WZ_SEMAPHORE *streamDecoderHandedOver = nullptr;  // Posted when the decoder thread hands a decoder to the main thread
+static bool streamDecodeQuit = false;
+
+/* Sound effects are decoded on worker threads while the tracks are being loaded, and the decoded
+ * data is handed to OpenAL on the main thread, when the track is first played or in sound_Update().
+ */
+struct TrackDecodeJob
+{
+	TRACK                  *psTrack;
+	PHYSFS_file            *fileHandle;
+	std::string             cacheKey;
+	soundDataBuffer        *result;
+	bool                    started;
+	bool                    finished;
+};
+
+static wz::mutex trackDecodeMutex;
+static std::list<TrackDecodeJob> trackDecodeJobs;  // Only added and removed on the main thread
+static std::vector<WZ_THREAD *> trackDecodeThreads;  // Started with the first job, joined in sound_CancelTrackDecodes()
+static WZ_SEMAPHORE *trackDecodeSemaphore = nullptr;  // Posted once for each job added, and for each thread when quitting
+static WZ_SEMAPHORE *trackDecodeFinished = nullptr;   // Posted when a worker thread finishes a job
+static bool trackDecodeQuit = false;
+
+/* Decoded sound effects, most recently used first. Only used on the main thread. */
+struct CachedPCM
+{
+	std::string             key;
+	ALenum                  format;
+	ALsizei                 frequency;
+	std::vector<char>       data;
+};
+
+static std::list<CachedPCM> pcmCache;
+static std::unordered_map<std::string, std::list<CachedPCM>::iterator> pcmCacheIndex;
+static size_t pcmCacheSize = 0;
+
 struct SAMPLE_LIST
 {
 	AUDIO_SAMPLE   *curr;
@@ -76,6 +138,8 @@ struct SAMPLE_LIST
 
 static SAMPLE_LIST *active_samples = nullptr;
 
+static Vector3f listenerPos(0.f, 0.f, 0.f);  // Last position passed to sound_SetPlayerPos, to not query OpenAL for every sample
+
 static AUDIO_STREAM *active_streams = nullptr;
 
 static ALfloat		sfx_volume = 1.0;
@@ -364,6 +428,8 @@ bool sound_SetHRTFMode(HRTFMode mode)
 }
 
 static void sound_UpdateStreams(void);
+static void sound_FinishTrackDecodes(TRACK *psWaitFor);
+static void sound_CancelTrackDecodes();
 
 void sound_ShutdownLibrary(void)
 {
@@ -383,6 +449,27 @@ void sound_ShutdownLibrary(void)
 	}
 	sound_UpdateStreams();
 
+	if (streamDecodeThread != nullptr)
+	{
+		{
+			std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+			streamDecodeQuit = true;
+		}
+		wzSemaphorePost(streamDecodeSemaphore);
+		wzThreadJoin(streamDecodeThread);
+		wzSemaphoreDestroy(streamDecodeSemaphore);
+		wzSemaphoreDestroy(streamDecoderHandedOver);
+		streamDecodeThread = nullptr;
+		streamDecodeSemaphore = nullptr;
+		streamDecoderHandedOver = nullptr;
+		streamDecodeQuit = false;
+	}
+
+	sound_CancelTrackDecodes();
+	pcmCache.clear();
+	pcmCacheIndex.clear();
+	pcmCacheSize = 0;
+
 	alcGetError(device);	// clear error codes
 
 	/* On Linux since this caused some versions of OpenAL to hang on exit. - Per */
@@ -465,6 +552,9 @@ void sound_Update()
 	// Update all streaming audio
 	sound_UpdateStreams();
 
+	// Hand any sound effects which finished decoding to OpenAL
+	sound_FinishTrackDecodes(nullptr);
+
 	while (node != nullptr)
 	{
 		ALenum state, err;
@@ -590,69 +680,199 @@ bool sound_QueueSamplePlaying(void)
 	return false;
 }
 
-/** Decodes an opened OggVorbis file into an OpenAL buffer
- *  \param psTrack pointer to object which will contain the final buffer
+/** Decodes an opened OggVorbis file entirely, and closes it. Can be called from any thread.
  *  \param PHYSFS_fileHandle file handle given by PhysicsFS to the opened file
- *  \return on success the psTrack pointer, otherwise it will be free'd and a NULL pointer is returned instead
+ *  \return the decoded data, or NULL if it couldn't be decoded
  */
-static inline TRACK *sound_DecodeOggVorbisTrack(TRACK *psTrack, PHYSFS_file *PHYSFS_fileHandle)
+static soundDataBuffer *sound_DecodeOggVorbisFile(PHYSFS_file *PHYSFS_fileHandle)
 {
-	ALenum		format;
-	ALuint		buffer;
-	struct OggVorbisDecoderState *decoder;
-	soundDataBuffer	*soundBuffer;
-
-	if (!openal_initialized)
-	{
-		return nullptr;
-	}
-
-	decoder = sound_CreateOggVorbisDecoder(PHYSFS_fileHandle, true);
+	struct OggVorbisDecoderState *decoder = sound_CreateOggVorbisDecoder(PHYSFS_fileHandle, true);
 	if (decoder == nullptr)
 	{
 		debug(LOG_WARNING, "Failed to open audio file for decoding");
-		free(psTrack);
+		PHYSFS_close(PHYSFS_fileHandle);
 		return nullptr;
 	}
 
-	soundBuffer = sound_DecodeOggVorbis(decoder, 0);
+	soundDataBuffer *soundBuffer = sound_DecodeOggVorbis(decoder, 0);
 	sound_DestroyOggVorbisDecoder(decoder);
+	PHYSFS_close(PHYSFS_fileHandle);
 
-	if (soundBuffer == nullptr)
+	if (soundBuffer != nullptr && soundBuffer->size == 0)
 	{
-		free(psTrack);
-		return nullptr;
+		debug(LOG_WARNING, "sound_DecodeOggVorbisFile: OggVorbis track is entirely empty after decoding");
 	}
+	return soundBuffer;
+}
 
-	if (soundBuffer->size == 0)
+/** Puts decoded data into the OpenAL buffer of the track */
+static void sound_BufferTrackData(TRACK *psTrack, ALenum format, const void *data, size_t size, ALsizei frequency)
+{
+	ASSERT(size <= static_cast<size_t>(std::numeric_limits<ALsizei>::max()), "size (%zu) exceeds ALsizei::max", size);
+	alBufferData(psTrack->iBufferName, format, data, static_cast<ALsizei>(size), frequency);
+	sound_GetError();
+}
+
+/** Fills the buffer of the track from the cache of decoded sound effects.
+ *  \return true if the track was in the cache
+ */
+static bool sound_BufferCachedTrack(TRACK *psTrack, const std::string &cacheKey)
+{
+	auto it = pcmCacheIndex.find(cacheKey);
+	if (it == pcmCacheIndex.end())
 	{
-		debug(LOG_WARNING, "sound_DecodeOggVorbisTrack: OggVorbis track is entirely empty after decoding");
-// NOTE: I'm not entirely sure if a track that's empty after decoding should be
-//       considered an error condition. Therefore I'll only error out on DEBUG
-//       builds. (Returning NULL here __will__ result in a program termination.)
-#ifdef DEBUG
-		free(soundBuffer);
-		free(psTrack);
-		return NULL;
-#endif
+		return false;
 	}
+	pcmCache.splice(pcmCache.begin(), pcmCache, it->second);
+	CachedPCM const &cached = *it->second;
+	sound_BufferTrackData(psTrack, cached.format, cached.data.data(), cached.data.size(), cached.frequency);
+	return true;
+}
 
-	// Determine PCM data format
-	format = (soundBuffer->channelCount == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+static void sound_CacheTrack(const std::string &cacheKey, ALenum format, const soundDataBuffer *soundBuffer)
+{
+	if (soundBuffer->size > PCM_CACHE_MAX_TRACK_SIZE || pcmCacheIndex.count(cacheKey) != 0)
+	{
+		return;
+	}
+	pcmCache.push_front(CachedPCM{cacheKey, format, static_cast<ALsizei>(soundBuffer->frequency), std::vector<char>(soundBuffer->data, soundBuffer->data + soundBuffer->size)});
+	pcmCacheIndex[cacheKey] = pcmCache.begin();
+	pcmCacheSize += soundBuffer->size;
+	while (pcmCacheSize > PCM_CACHE_SIZE)
+	{
+		pcmCacheSize -= pcmCache.back().data.size();
+		pcmCacheIndex.erase(pcmCache.back().key);
+		pcmCache.pop_back();
+	}
+}
 
-	// Create an OpenAL buffer and fill it with the decoded data
-	alGenBuffers(1, &buffer);
-	sound_GetError();
-	ASSERT(soundBuffer->size <= static_cast<size_t>(std::numeric_limits<ALsizei>::max()), "soundBuffer->size (%zu) exceeds ALsizei::max", soundBuffer->size);
-	alBufferData(buffer, format, soundBuffer->data, static_cast<ALsizei>(soundBuffer->size), soundBuffer->frequency);
-	sound_GetError();
+static int sound_TrackDecodeThreadFunc(void *)
+{
+	std::unique_lock<wz::mutex> lock(trackDecodeMutex);
+	while (!trackDecodeQuit)
+	{
+		auto job = std::find_if(trackDecodeJobs.begin(), trackDecodeJobs.end(), [](TrackDecodeJob const &job) { return !job.started; });
+		if (job == trackDecodeJobs.end())
+		{
+			lock.unlock();
+			wzSemaphoreWait(trackDecodeSemaphore);
+			lock.lock();
+			continue;
+		}
+		job->started = true;
+		lock.unlock();
+		soundDataBuffer *result = sound_DecodeOggVorbisFile(job->fileHandle);
+		lock.lock();
+		job->result = result;
+		job->finished = true;
+		wzSemaphorePost(trackDecodeFinished);
+	}
+	return 0;
+}
 
-	free(soundBuffer);
+/** Hands the decoded data of a finished job to OpenAL. Must be called on the main thread. */
+static void sound_UploadDecodedTrack(TrackDecodeJob &job)
+{
+	TRACK *psTrack = job.psTrack;
+	psTrack->bDecoding = false;
+	if (job.result == nullptr)
+	{
+		return;
+	}
+	if (job.result->size > 0)
+	{
+		ALenum format = (job.result->channelCount == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+		sound_BufferTrackData(psTrack, format, job.result->data, job.result->size, job.result->frequency);
+		sound_CacheTrack(job.cacheKey, format, job.result);
+	}
+	free(job.result);
+	job.result = nullptr;
+}
+
+/** Hands all sound effects which finished decoding to OpenAL.
+ *  \param psWaitFor if not NULL, also waits for this track to finish decoding, decoding it right away if no thread has started on it yet.
+ */
+static void sound_FinishTrackDecodes(TRACK *psWaitFor)
+{
+	std::unique_lock<wz::mutex> lock(trackDecodeMutex);
+	while (true)
+	{
+		bool waiting = false;
+		for (auto job = trackDecodeJobs.begin(); job != trackDecodeJobs.end();)
+		{
+			if (job->finished)
+			{
+				sound_UploadDecodedTrack(*job);
+				job = trackDecodeJobs.erase(job);
+				continue;
+			}
+			if (job->psTrack == psWaitFor)
+			{
+				if (!job->started)
+				{
+					job->started = true;
+					lock.unlock();
+					soundDataBuffer *result = sound_DecodeOggVorbisFile(job->fileHandle);
+					lock.lock();
+					job->result = result;
+					job->finished = true;
+					continue;  // Upload it right away.
+				}
+				waiting = true;
+			}
+			++job;
+		}
+		if (!waiting)
+		{
+			return;
+		}
+		// Posted for every finished job, so this may wake up for another track, and check again.
+		lock.unlock();
+		wzSemaphoreWait(trackDecodeFinished);
+		lock.lock();
+	}
+}
 
-	// save buffer name in track
-	psTrack->iBufferName = buffer;
+/** Drops the sound effects which are waiting to be decoded, and joins the worker threads. */
+static void sound_CancelTrackDecodes()
+{
+	{
+		std::lock_guard<wz::mutex> lock(trackDecodeMutex);
+		for (TrackDecodeJob &job : trackDecodeJobs)
+		{
+			if (!job.started)
+			{
+				job.started = true;
+				job.finished = true;
+				PHYSFS_close(job.fileHandle);
+			}
+		}
+		trackDecodeQuit = true;
+	}
+	for (size_t i = 0; i < trackDecodeThreads.size(); ++i)
+	{
+		wzSemaphorePost(trackDecodeSemaphore);
+	}
+	for (WZ_THREAD *thread : trackDecodeThreads)
+	{
+		wzThreadJoin(thread);
+	}
+	trackDecodeThreads.clear();
+	trackDecodeQuit = false;
+	if (trackDecodeSemaphore != nullptr)
+	{
+		wzSemaphoreDestroy(trackDecodeSemaphore);
+		wzSemaphoreDestroy(trackDecodeFinished);
+		trackDecodeSemaphore = nullptr;
+		trackDecodeFinished = nullptr;
+	}
 
-	return psTrack;
+	for (TrackDecodeJob &job : trackDecodeJobs)
+	{
+		job.psTrack->bDecoding = false;
+		free(job.result);
+	}
+	trackDecodeJobs.clear();
 }
 
 //*
@@ -711,15 +931,55 @@ TRACK *sound_LoadTrackFromFile(const char *fileName)
 	}
 	pTrack->fileName = track_name;
 
-	// Now use sound_ReadTrackFromBuffer to decode the file's contents
-	pTrack = sound_DecodeOggVorbisTrack(pTrack, fileHandle);
+	if (!openal_initialized)
+	{
+		PHYSFS_close(fileHandle);
+		free(pTrack);
+		return nullptr;
+	}
+
+	// Create the OpenAL buffer now, the decoded data is put into it later
+	alGenBuffers(1, &pTrack->iBufferName);
+	sound_GetError();
+
+	std::string cacheKey = WZ_PHYSFS_getRealDir_String(fileName) + "|" + fileName + "|" + std::to_string(WZ_PHYSFS_getLastModTime(fileName));
+	if (sound_BufferCachedTrack(pTrack, cacheKey))
+	{
+		PHYSFS_close(fileHandle);
+		return pTrack;
+	}
 
-	PHYSFS_close(fileHandle);
+	// Decode the file's contents on a worker thread
+	pTrack->bDecoding = true;
+	if (trackDecodeSemaphore == nullptr)
+	{
+		trackDecodeSemaphore = wzSemaphoreCreate(0);
+		trackDecodeFinished = wzSemaphoreCreate(0);
+		for (unsigned int i = 0; i < TRACK_DECODE_THREADS; ++i)
+		{
+			WZ_THREAD *thread = wzThreadCreate(sound_TrackDecodeThreadFunc, nullptr);
+			if (thread == nullptr)
+			{
+				break;  // If there are none, tracks are decoded by sound_FinishTrackDecodes() when they are needed.
+			}
+			wzThreadStart(thread);
+			trackDecodeThreads.push_back(thread);
+		}
+	}
+	{
+		std::lock_guard<wz::mutex> lock(trackDecodeMutex);
+		trackDecodeJobs.push_back(TrackDecodeJob{pTrack, fileHandle, cacheKey, nullptr, false, false});
+	}
+	wzSemaphorePost(trackDecodeSemaphore);
 	return pTrack;
 }
 
 void sound_FreeTrack(TRACK *psTrack)
 {
+	if (psTrack->bDecoding)
+	{
+		sound_FinishTrackDecodes(psTrack);
+	}
 	alDeleteBuffers(1, &psTrack->iBufferName);
 	sound_GetError();
 }
@@ -784,6 +1044,10 @@ bool sound_Play2DSample(TRACK *psTrack, AUDIO_SAMPLE *psSample, bool bQueued)
 	{
 		return false;
 	}
+	if (psTrack->bDecoding)
+	{
+		sound_FinishTrackDecodes(psTrack);
+	}
 	volume = ((float)psTrack->iVol / 100.0f);		// each object can have OWN volume!
 	psSample->fVol = volume;						// save computed volume
 	volume *= sfx_volume;							// and now take into account the Users sound Prefs.
@@ -856,6 +1120,10 @@ bool sound_Play3DSample(TRACK *psTrack, AUDIO_SAMPLE *psSample)
 	{
 		return false;
 	}
+	if (psTrack->bDecoding)
+	{
+		sound_FinishTrackDecodes(psTrack);
+	}
 
 	volume = ((float)psTrack->iVol / 100.f);		// max range is 0-100
 	psSample->fVol = volume;						// store results for later
@@ -910,6 +1178,114 @@ bool sound_Play3DSample(TRACK *psTrack, AUDIO_SAMPLE *psSample)
 	return true;
 }
 
+/** Stores a buffer decoded for the stream, or notes that the end was reached. Must be called with streamDecodeMutex locked. */
+static void sound_AddDecodedStreamBuffer(AUDIO_STREAM *stream, soundDataBuffer *soundBuffer)
+{
+	if (soundBuffer != nullptr && soundBuffer->size > 0)
+	{
+		stream->decoded.push_back(soundBuffer);
+	}
+	else
+	{
+		free(soundBuffer);
+		stream->decodedEnd = true;
+	}
+}
+
+static int sound_StreamDecodeThreadFunc(void *)
+{
+	std::unique_lock<wz::mutex> lock(streamDecodeMutex);
+	while (!streamDecodeQuit)
+	{
+		AUDIO_STREAM *stream = active_streams;
+		while (stream != nullptr && (stream->decoding || stream->decodedEnd || stream->decoded.size() >= stream->decodeAhead))
+		{
+			stream = stream->next;
+		}
+		if (stream == nullptr)
+		{
+			// Nothing to do, wait until buffers are used up or new streams start.
+			lock.unlock();
+			wzSemaphoreWait(streamDecodeSemaphore);
+			lock.lock();
+			continue;
+		}
+
+		stream->decoding = true;
+		lock.unlock();
+		soundDataBuffer *soundBuffer = sound_DecodeOggVorbis(stream->decoder, stream->bufferSize);
+		lock.lock();
+		if (stream->decoderWanted)
+		{
+			// The main thread is waiting in sound_LockStreamDecoder(), so the decoder stays in use, by it.
+			stream->decoderWanted = false;
+			wzSemaphorePost(streamDecoderHandedOver);
+		}
+		else
+		{
+			stream->decoding = false;
+		}
+		sound_AddDecodedStreamBuffer(stream, soundBuffer);
+	}
+	return 0;
+}
+
+/** Takes the decoder of the stream away from the decoder thread, waiting for it to finish its current buffer if needed.
+ *  Release it again with sound_UnlockStreamDecoder().
+ */
+static void sound_LockStreamDecoder(AUDIO_STREAM *stream)
+{
+	{
+		std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+		if (!stream->decoding)
+		{
+			stream->decoding = true;
+			return;
+		}
+		stream->decoderWanted = true;
+	}
+	// Only the decoder thread uses decoders besides the main thread, and it hands this one over once done with its buffer.
+	wzSemaphoreWait(streamDecoderHandedOver);
+}
+
+static void sound_UnlockStreamDecoder(AUDIO_STREAM *stream)
+{
+	std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+	stream->decoding = false;
+}
+
+/** Gets the next decoded buffer of the stream, decoding it right away if the decoder thread hasn't got to it yet.
+ *  \return the decoded buffer, or NULL at the end of the stream
+ */
+static soundDataBuffer *sound_NextStreamBuffer(AUDIO_STREAM *stream)
+{
+	sound_LockStreamDecoder(stream);
+	soundDataBuffer *soundBuffer = nullptr;
+	bool decodeNow;
+	{
+		std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+		if (!stream->decoded.empty())
+		{
+			soundBuffer = stream->decoded.front();
+			stream->decoded.pop_front();
+		}
+		decodeNow = soundBuffer == nullptr && !stream->decodedEnd;
+	}
+	if (decodeNow)
+	{
+		soundBuffer = sound_DecodeOggVorbis(stream->decoder, stream->bufferSize);
+		if (soundBuffer == nullptr || soundBuffer->size == 0)
+		{
+			free(soundBuffer);
+			soundBuffer = nullptr;
+			std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+			stream->decodedEnd = true;
+		}
+	}
+	sound_UnlockStreamDecoder(stream);
+	return soundBuffer;
+}
+
 /** Plays the audio data from the given file
  *  \param fileHandle PhysicsFS file handle to stream the audio from
  *  \param volume the volume to play the audio at (in a range of 0.0 to 1.0)
@@ -1089,9 +1465,40 @@ AUDIO_STREAM *sound_PlayStreamWithBuf(PHYSFS_file *fileHandle, float volume, con
 	stream->onFinished = onFinished;
 	stream->user_data = user_data;
 
-	// Prepend this stream to the linked list
-	stream->next = active_streams;
-	active_streams = stream;
+	// Keep as many buffers decoded ahead as are queued on the source
+	stream->decodeAhead = buffer_count;
+	stream->decodedEnd = i < buffer_count;
+
+	{
+		std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+
+		// Prepend this stream to the linked list
+		stream->next = active_streams;
+		active_streams = stream;
+
+		if (streamDecodeThread == nullptr)
+		{
+			streamDecodeSemaphore = wzSemaphoreCreate(0);
+			streamDecoderHandedOver = wzSemaphoreCreate(0);
+			streamDecodeThread = wzThreadCreate(sound_StreamDecodeThreadFunc, nullptr);
+			if (streamDecodeThread != nullptr)
+			{
+				wzThreadStart(streamDecodeThread);
+			}
+			else
+			{
+				// Decode on the main thread instead, in sound_NextStreamBuffer().
+				wzSemaphoreDestroy(streamDecodeSemaphore);
+				wzSemaphoreDestroy(streamDecoderHandedOver);
+				streamDecodeSemaphore = nullptr;
+				streamDecoderHandedOver = nullptr;
+			}
+		}
+	}
+	if (streamDecodeSemaphore != nullptr)
+	{
+		wzSemaphorePost(streamDecodeSemaphore);
+	}
 
 	if(freeBuffers)
 	{
@@ -1136,6 +1543,7 @@ void sound_StopStream(AUDIO_STREAM *stream)
 
 	alGetError();	// clear error codes
 	// Tell OpenAL to stop playing on the given source
+	stream->stopRequested = true;
 	alSourceStop(stream->source);
 	sound_GetError();
 }
@@ -1216,7 +1624,10 @@ void sound_SetStreamVolume(AUDIO_STREAM *stream, float volume)
 
 double sound_GetStreamTotalTime(AUDIO_STREAM *stream)
 {
-	return sound_GetOggVorbisTotalTime(stream->decoder);
+	sound_LockStreamDecoder(stream);
+	double totalTime = sound_GetOggVorbisTotalTime(stream->decoder);
+	sound_UnlockStreamDecoder(stream);
+	return totalTime;
 }
 
 /** Update the given stream by making sure its buffers remain full
@@ -1232,7 +1643,11 @@ static bool sound_UpdateStream(AUDIO_STREAM *stream)
 
 	if (state != AL_PLAYING && state != AL_PAUSED)
 	{
-		return false;
+		// A source also stops when it runs out of queued buffers, carry on if there is more to play.
+		if (state != AL_STOPPED || stream->stopRequested)
+		{
+			return false;
+		}
 	}
 
 	// Retrieve the amount of buffers which were processed and need refilling
@@ -1240,20 +1655,20 @@ static bool sound_UpdateStream(AUDIO_STREAM *stream)
 	sound_GetError();
 
 	// Refill and reattach all buffers
+	bool refilled = buffer_count != 0;
 	for (; buffer_count != 0; --buffer_count)
 	{
-		soundDataBuffer *soundBuffer;
 		ALuint buffer;
 
 		// Retrieve the buffer to work on
 		alSourceUnqueueBuffers(stream->source, 1, &buffer);
 		sound_GetError();
 
-		// Decode some data to stuff in our buffer
-		soundBuffer = sound_DecodeOggVorbis(stream->decoder, stream->bufferSize);
+		// Get some decoded data to stuff in our buffer
+		soundDataBuffer *soundBuffer = sound_NextStreamBuffer(stream);
 
 		// If we actually decoded some data
-		if (soundBuffer && soundBuffer->size > 0)
+		if (soundBuffer)
 		{
 			// Determine PCM data format
 			ALenum format = (soundBuffer->channelCount == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
@@ -1269,7 +1684,7 @@ static bool sound_UpdateStream(AUDIO_STREAM *stream)
 		}
 		else
 		{
-			// If no data has been decoded we're probably at the end of our
+			// If no data has been decoded we're at the end of our
 			// stream. So cleanup this buffer.
 
 			// Then remove OpenAL's buffer
@@ -1281,6 +1696,26 @@ static bool sound_UpdateStream(AUDIO_STREAM *stream)
 		free(soundBuffer);
 	}
 
+	if (refilled && streamDecodeSemaphore != nullptr)
+	{
+		// Let the decoder thread replace the buffers we used up.
+		wzSemaphorePost(streamDecodeSemaphore);
+	}
+
+	if (state == AL_STOPPED)
+	{
+		ALint queued;
+		alGetSourcei(stream->source, AL_BUFFERS_QUEUED, &queued);
+		sound_GetError();
+		if (queued == 0)
+		{
+			return false;  // Played everything.
+		}
+		debug(LOG_SOUND, "Stream ran out of decoded audio, resuming");
+		alSourcePlay(stream->source);
+		sound_GetError();
+	}
+
 	return true;
 }
 
@@ -1354,8 +1789,14 @@ static void sound_DestroyStream(AUDIO_STREAM *stream)
 	alDeleteSources(1, &stream->source);
 	sound_GetError();
 
-	// Destroy the sound decoder
+	// Destroy the sound decoder, once the decoder thread is done with it
+	sound_LockStreamDecoder(stream);
 	sound_DestroyOggVorbisDecoder(stream->decoder);
+	for (soundDataBuffer *soundBuffer : stream->decoded)
+	{
+		free(soundBuffer);
+	}
+	stream->decoded.clear();
 
 	// Now close the file
 	PHYSFS_close(stream->fileHandle);
@@ -1385,16 +1826,19 @@ static void sound_UpdateStreams()
 		if (!sound_UpdateStream(stream))
 		{
 			// First remove our current stream from the linked list
-			if (previous)
-			{
-				// Make the previous item skip over the current to the next item
-				previous->next = next;
-			}
-			else
 			{
-				// Apparently this is the first item in the list, so make the
-				// next item the list-head.
-				active_streams = next;
+				std::lock_guard<wz::mutex> lock(streamDecodeMutex);
+				if (previous)
+				{
+					// Make the previous item skip over the current to the next item
+					previous->next = next;
+				}
+				else
+				{
+					// Apparently this is the first item in the list, so make the
+					// next item the list-head.
+					active_streams = next;
+				}
 			}
 
 			// Now actually destroy the current stream
@@ -1432,6 +1876,7 @@ void sound_StopSample(AUDIO_SAMPLE *psSample)
 
 void sound_SetPlayerPos(Vector3f pos)
 {
+	listenerPos = pos;
 	alListener3f(AL_POSITION, pos.x, pos.y, pos.z);
 	sound_GetError();
 }
@@ -1479,7 +1924,7 @@ void sound_SetObjectPosition(AUDIO_SAMPLE *psSample)
 {
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	// coordinates
-	float	listenerX, listenerY, listenerZ, dX, dY, dZ;
+	float	dX, dY, dZ;
 
 	// calculation results
 	float	distance, gain;
@@ -1492,11 +1937,9 @@ void sound_SetObjectPosition(AUDIO_SAMPLE *psSample)
 	}
 
 	// compute distance
-	alGetListener3f(AL_POSITION, &listenerX, &listenerY, &listenerZ);
-	sound_GetError();
-	dX = psSample->x  - listenerX; // distances on all axis
-	dY = psSample->y - listenerY;
-	dZ = psSample->z - listenerZ;
+	dX = psSample->x - listenerPos.x; // distances on all axis
+	dY = psSample->y - listenerPos.y;
+	dZ = psSample->z - listenerPos.z;
 	distance = sqrtf(dX * dX + dY * dY + dZ * dZ); // Pythagorean theorem
 
 	// compute gain
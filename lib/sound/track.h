@@ -73,6 +73,7 @@ struct TRACK
 	UDWORD          iTimeLastFinished;      // time last finished in ms
 	UDWORD          iNumPlaying;
 	ALuint          iBufferName;            // OpenAL name of the buffer
+	bool            bDecoding;              // still being decoded on a worker thread, the buffer is filled once done
 	const char     *fileName;
 };
 
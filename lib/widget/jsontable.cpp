@@ -298,6 +298,62 @@ void PathBarWidget::relayoutComponentButtons()
 #define JSON_ACTION_BUTTONS_SPACING 10
 #define MENU_BUTTONS_PADDING 20
 
+struct JSONTableItem
+{
+	std::string key;
+	std::string valueStr;
+	PIELIGHT valueTextColor;
+	bool expandableItem;
+};
+
+static std::shared_ptr<TableRow> makeJSONTableRow(const JSONTableItem& item, const std::weak_ptr<JSONTableWidget>& psWeakJsonTable)
+{
+	auto keyLabel = std::make_shared<W_LABEL>();
+	keyLabel->setFont(font_regular, WZCOL_FORM_LIGHT);
+	keyLabel->setString(WzString::fromUtf8(item.key));
+	keyLabel->setCanTruncate(true);
+	keyLabel->setTransparentToClicks(true);
+
+	auto valueLabel = std::make_shared<W_LABEL>();
+	valueLabel->setFont(font_regular, item.valueTextColor);
+	valueLabel->setString(WzString::fromUtf8(item.valueStr));
+	valueLabel->setCanTruncate(true);
+	valueLabel->setTransparentToClicks(true);
+
+	auto expandButton = std::make_shared<W_LABEL>();
+	expandButton->setFont(font_regular, WZCOL_TEXT_MEDIUM);
+	if (item.expandableItem)
+	{
+		expandButton->setString("\u27A4"); // ➤
+	}
+	expandButton->setCanTruncate(false);
+	expandButton->setTransparentToClicks(true);
+
+	std::vector<std::shared_ptr<WIDGET>> columnWidgets {keyLabel, valueLabel, expandButton};
+	auto row = TableRow::make(columnWidgets, 24);
+	// Add custom "on click" handler TableRow itself to "dive into" objects / arrays (if expandableItem)
+	if (item.expandableItem)
+	{
+		std::string itemKey = item.key;
+		row->addOnClickHandler([itemKey, psWeakJsonTable](W_BUTTON& button) {
+			widgScheduleTask([psWeakJsonTable, itemKey]{
+				if (auto jsonTable = psWeakJsonTable.lock())
+				{
+					jsonTable->pushJSONPath(itemKey);
+				}
+			});
+		});
+		row->setHighlightsOnMouseOver(true);
+	}
+	return row;
+}
+
+static int getJSONTableTextWidth(const std::string& text)
+{
+	// Same as W_LABEL::getMaxLineWidth() of a label given the text with setString(), which keeps it as a single line
+	return iV_GetTextWidth(text.c_str(), font_regular);
+}
+
 template<typename json_type>
 void setTableToJson(const json_type& json, JSONTableWidget& jsonTable)
 {
@@ -305,16 +361,12 @@ void setTableToJson(const json_type& json, JSONTableWidget& jsonTable)
 	jsonTable.currentMaxColumnWidths = {0,0,0};
 	PIELIGHT specialValueTextColor = WZCOL_TEXT_MEDIUM;
 	specialValueTextColor.byte.a = static_cast<uint8_t>((float)specialValueTextColor.byte.a * 0.75f);
+
+	// Only the rows in view get widgets, large objects would need thousands of them otherwise.
+	auto items = std::make_shared<std::vector<JSONTableItem>>();
+	items->reserve(json.size());
 	for (auto item : json.items())
 	{
-		auto keyLabel = std::make_shared<W_LABEL>();
-		keyLabel->setFont(font_regular, WZCOL_FORM_LIGHT);
-		keyLabel->setString(WzString::fromUtf8(item.key()));
-		keyLabel->setCanTruncate(true);
-		keyLabel->setTransparentToClicks(true);
-		jsonTable.currentMaxColumnWidths[0] = std::max(jsonTable.currentMaxColumnWidths[0], keyLabel->getMaxLineWidth());
-
-		auto valueLabel = std::make_shared<W_LABEL>();
 		std::string valueStr;
 		PIELIGHT valueTextColor = WZCOL_FORM_LIGHT;
 		bool expandableItem = false;
@@ -384,40 +436,15 @@ void setTableToJson(const json_type& json, JSONTableWidget& jsonTable)
 				valueTextColor = pal_RGBA(150, 0, 0, 250);
 			}
 		}
-		valueLabel->setFont(font_regular, valueTextColor);
-		valueLabel->setString(WzString::fromUtf8(valueStr));
-		valueLabel->setCanTruncate(true);
-		valueLabel->setTransparentToClicks(true);
-		jsonTable.currentMaxColumnWidths[1] = std::max(jsonTable.currentMaxColumnWidths[1], valueLabel->getMaxLineWidth());
-
-		auto expandButton = std::make_shared<W_LABEL>();
-		expandButton->setFont(font_regular, WZCOL_TEXT_MEDIUM);
-		if (expandableItem)
-		{
-			expandButton->setString("\u27A4"); // ➤
-		}
-		expandButton->setCanTruncate(false);
-		expandButton->setTransparentToClicks(true);
-
-		std::vector<std::shared_ptr<WIDGET>> columnWidgets {keyLabel, valueLabel, expandButton};
-		auto row = TableRow::make(columnWidgets, 24);
-		// Add custom "on click" handler TableRow itself to "dive into" objects / arrays (if expandableItem)
-		if (expandableItem)
-		{
-			std::string itemKey = item.key();
-			std::weak_ptr<JSONTableWidget> psWeakJsonTable = std::dynamic_pointer_cast<JSONTableWidget>(jsonTable.shared_from_this());
-			row->addOnClickHandler([itemKey, psWeakJsonTable](W_BUTTON& button) {
-				widgScheduleTask([psWeakJsonTable, itemKey]{
-					if (auto jsonTable = psWeakJsonTable.lock())
-					{
-						jsonTable->pushJSONPath(itemKey);
-					}
-				});
-			});
-			row->setHighlightsOnMouseOver(true);
-		}
-		jsonTable.table->addRow(row);
+		jsonTable.currentMaxColumnWidths[0] = std::max(jsonTable.currentMaxColumnWidths[0], getJSONTableTextWidth(item.key()));
+		jsonTable.currentMaxColumnWidths[1] = std::max(jsonTable.currentMaxColumnWidths[1], getJSONTableTextWidth(valueStr));
+		items->push_back(JSONTableItem{item.key(), std::move(valueStr), valueTextColor, expandableItem});
 	}
+
+	std::weak_ptr<JSONTableWidget> psWeakJsonTable = std::dynamic_pointer_cast<JSONTableWidget>(jsonTable.shared_from_this());
+	jsonTable.table->setRowSource(items->size(), 24, [items, psWeakJsonTable](size_t index, const std::shared_ptr<TableRow>&) {
+		return makeJSONTableRow((*items)[index], psWeakJsonTable);
+	});
 }
 
 template<typename json_type>
@@ -25,6 +25,8 @@
 #include "lib/framework/input.h"
 #include "lib/ivis_opengl/pieblitfunc.h"
 
+#include <algorithm>
+
 static const auto SCROLLBAR_WIDTH = 15;
 
 void ScrollableListWidget::initialize()
@@ -45,7 +47,14 @@ void ScrollableListWidget::geometryChanged()
 void ScrollableListWidget::run(W_CONTEXT *psContext)
 {
 	updateLayout();
-	listView->setTopOffset(snapOffset ? snappedOffset() : scrollBar->position());
+	updateTopOffset();
+}
+
+void ScrollableListWidget::updateTopOffset()
+{
+	uint32_t topOffset = snapOffset ? snappedOffset() : scrollBar->position();
+	listView->setTopOffset(topOffset);
+	updateItemWidgets(topOffset);
 }
 
 /**
@@ -55,6 +64,12 @@ void ScrollableListWidget::run(W_CONTEXT *psContext)
  */
 uint32_t ScrollableListWidget::snappedOffset()
 {
+	if (itemSource.make)
+	{
+		auto it = std::lower_bound(itemOffsets.begin(), itemOffsets.end(), scrollBar->position());
+		return it != itemOffsets.end() ? *it : 0;
+	}
+
 	for (auto child : listView->children())
 	{
 		if (child->y() >= scrollBar->position())
@@ -68,18 +83,114 @@ uint32_t ScrollableListWidget::snappedOffset()
 
 void ScrollableListWidget::addItem(const std::shared_ptr<WIDGET> &item)
 {
+	ASSERT_OR_RETURN(, !itemSource.make, "Can't add items to a list with an item source");
 	listView->attach(item);
 	layoutDirty = true;
 }
 
 void ScrollableListWidget::clear()
 {
+	itemSource = ItemSource();
+	itemOffsets.clear();
+	itemHeights.clear();
+	itemWidgets.clear();
+	reusableItemWidgets.clear();
 	listView->removeAllChildren();
 	layoutDirty = true;
 	updateLayout();
 	listView->setTopOffset(0);
 }
 
+void ScrollableListWidget::setItemSource(const ItemSource &source)
+{
+	ASSERT_OR_RETURN(, source.count && source.height && source.make, "Incomplete item source");
+	clear();
+	itemSource = source;
+	itemSourceChanged();
+}
+
+void ScrollableListWidget::itemSourceChanged()
+{
+	if (!itemSource.make)
+	{
+		return;
+	}
+
+	// Row widgets may show outdated contents, so make them again.
+	for (auto const &item : itemWidgets)
+	{
+		listView->detach(item.second);
+	}
+	itemWidgets.clear();
+
+	size_t count = itemSource.count();
+	itemOffsets.resize(count);
+	itemHeights.resize(count);
+	scrollableHeight = 0;
+	uint32_t nextOffset = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		itemOffsets[i] = nextOffset;
+		itemHeights[i] = itemSource.height(i);
+		scrollableHeight = nextOffset + itemHeights[i];
+		nextOffset = scrollableHeight + itemSpacing;
+	}
+	layoutDirty = true;
+}
+
+/**
+ * Makes widgets for the rows of the item source which came into view, and takes them from the
+ * rows which went out of view. Only the handful of rows in view have widgets at any time.
+ */
+void ScrollableListWidget::updateItemWidgets(uint32_t topOffset)
+{
+	if (!itemSource.make)
+	{
+		return;
+	}
+
+	uint32_t bottomOffset = topOffset + calculateListViewHeight();
+	size_t first = std::upper_bound(itemOffsets.begin(), itemOffsets.end(), topOffset) - itemOffsets.begin();
+	first = first > 0 ? first - 1 : 0;
+	size_t last = std::lower_bound(itemOffsets.begin(), itemOffsets.end(), bottomOffset) - itemOffsets.begin();
+
+	for (auto it = itemWidgets.begin(); it != itemWidgets.end();)
+	{
+		if (it->first < first || it->first >= last)
+		{
+			listView->detach(it->second);
+			reusableItemWidgets.push_back(std::move(it->second));
+			it = itemWidgets.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	for (size_t i = first; i < last; ++i)
+	{
+		if (itemWidgets.count(i) != 0)
+		{
+			continue;
+		}
+		std::shared_ptr<WIDGET> reuse;
+		if (!reusableItemWidgets.empty())
+		{
+			reuse = std::move(reusableItemWidgets.back());
+			reusableItemWidgets.pop_back();
+		}
+		auto item = itemSource.make(i, reuse);
+		if (item == nullptr)
+		{
+			continue;
+		}
+		item->setGeometry(0, itemOffsets[i], itemWidth, itemHeights[i]);
+		listView->attach(item);
+		itemWidgets[i] = item;
+	}
+}
+
 void ScrollableListWidget::updateLayout()
 {
 	if (!layoutDirty) {
@@ -108,6 +219,17 @@ void ScrollableListWidget::updateLayout()
 
 void ScrollableListWidget::resizeChildren(uint32_t width)
 {
+	if (itemSource.make)
+	{
+		// scrollableHeight is known from itemSourceChanged()
+		itemWidth = width;
+		for (auto const &item : itemWidgets)
+		{
+			item.second->setGeometry(0, itemOffsets[item.first], width, itemHeights[item.first]);
+		}
+		return;
+	}
+
 	scrollableHeight = 0;
 	auto nextOffset = 0;
 	for (auto child : listView->children())
@@ -168,6 +290,7 @@ void ScrollableListWidget::setSnapOffset(bool value)
 void ScrollableListWidget::setItemSpacing(uint32_t value)
 {
 	itemSpacing = value;
+	itemSourceChanged();
 }
 
 void ScrollableListWidget::display(int xOffset, int yOffset)
@@ -183,6 +306,11 @@ void ScrollableListWidget::display(int xOffset, int yOffset)
 void ScrollableListWidget::displayRecursive(WidgetGraphicsContext const& context)
 {
 	updateLayout();
+	if (itemSource.make)
+	{
+		// The rows in view must have widgets, even if the list was scrolled since run().
+		updateTopOffset();
+	}
 	WIDGET::displayRecursive(context);
 }
 
@@ -200,5 +328,5 @@ void ScrollableListWidget::setScrollPosition(uint16_t newPosition)
 {
 	updateLayout();
 	scrollBar->setPosition(newPosition);
-	listView->setTopOffset(snapOffset ? snappedOffset() : scrollBar->position());
+	updateTopOffset();
 }
@@ -28,8 +28,22 @@
 #include "scrollbar.h"
 #include "cliprect.h"
 
+#include <functional>
+#include <map>
+
 class ScrollableListWidget : public WIDGET
 {
+public:
+	/// Describes the rows of a virtual list, see setItemSource().
+	struct ItemSource
+	{
+		std::function<size_t ()> count;                   ///< Number of rows
+		std::function<uint32_t (size_t index)> height;    ///< Height of a row
+		/// Makes the widget for a row. reuse is the widget of a row which scrolled out of view, or nullptr.
+		/// It may be updated and returned, instead of making a new widget.
+		std::function<std::shared_ptr<WIDGET> (size_t index, const std::shared_ptr<WIDGET> &reuse)> make;
+	};
+
 protected:
 	ScrollableListWidget(): WIDGET() {}
 	virtual void initialize();
@@ -46,6 +60,16 @@ public:
 	void run(W_CONTEXT *psContext) override;
 	void addItem(const std::shared_ptr<WIDGET> &widget);
 	void clear();
+	/// Shows the rows described by source instead of added items. Widgets are only made for the rows in view,
+	/// so that long lists don't need a widget for every row. clear() goes back to showing added items.
+	void setItemSource(const ItemSource &source);
+	/// Must be called after the number, heights or contents of the rows of the item source changed.
+	void itemSourceChanged();
+	/// The widgets of the items, or of the rows in view if there is an item source.
+	Children const &itemsInView()
+	{
+		return listView->children();
+	}
 	bool processClickRecursive(W_CONTEXT *psContext, WIDGET_KEY key, bool wasPressed) override;
 	void enableScroll();
 	void disableScroll();
@@ -75,8 +99,17 @@ private:
 	PIELIGHT backgroundColor;
 	uint32_t itemSpacing = 0;
 
+	ItemSource itemSource;
+	std::vector<uint32_t> itemOffsets;   ///< Top of each row of the item source
+	std::vector<uint32_t> itemHeights;
+	std::map<size_t, std::shared_ptr<WIDGET>> itemWidgets;  ///< Widgets of the rows in view, by row
+	std::vector<std::shared_ptr<WIDGET>> reusableItemWidgets;
+	uint32_t itemWidth = 0;
+
 	uint32_t snappedOffset();
 	void updateLayout();
+	void updateTopOffset();
+	void updateItemWidgets(uint32_t topOffset);
 	void resizeChildren(uint32_t width);
 };
 
@@ -391,6 +391,24 @@ void ScrollableTableWidget::clearRows()
 	rows.clear();
 }
 
+void ScrollableTableWidget::setRowSource(size_t numRows, int rowHeight, const MakeRowFunc& makeRow)
+{
+	rows.clear();
+	std::weak_ptr<ScrollableTableWidget> psWeakTable = std::static_pointer_cast<ScrollableTableWidget>(shared_from_this());
+	ScrollableListWidget::ItemSource source;
+	source.count = [numRows]() { return numRows; };
+	source.height = [rowHeight](size_t) { return static_cast<uint32_t>(std::max(rowHeight, 0)); };
+	source.make = [psWeakTable, makeRow](size_t index, const std::shared_ptr<WIDGET>& reuse) -> std::shared_ptr<WIDGET> {
+		auto psTable = psWeakTable.lock();
+		ASSERT_OR_RETURN(nullptr, psTable != nullptr, "Table no longer exists");
+		auto row = makeRow(index, std::static_pointer_cast<TableRow>(reuse));
+		ASSERT_OR_RETURN(nullptr, row != nullptr && row->numColumns() == psTable->columnWidths.size(), "Unexpected row");
+		row->resizeColumns(psTable->columnWidths, TABLE_COL_PADDING);
+		return row;
+	};
+	scrollableList->setItemSource(source);
+}
+
 bool ScrollableTableWidget::changeColumnWidths(const std::vector<size_t>& newColumnWidths, bool overrideUserColumnResizing /*= false*/)
 {
 	ASSERT_OR_RETURN(false, newColumnWidths.size() == columnWidths.size(), "newColumnWidths.size (%zu) does not match existing number of columns (%zu)", newColumnWidths.size(), columnWidths.size());
@@ -474,6 +492,14 @@ void ScrollableTableWidget::updateColumnWidths()
 	{
 		row->resizeColumns(columnWidths, TABLE_COL_PADDING);
 	}
+	if (rows.empty())
+	{
+		// Rows made by a row source, only those in view exist
+		for (auto& item : scrollableList->itemsInView())
+		{
+			std::static_pointer_cast<TableRow>(item)->resizeColumns(columnWidths, TABLE_COL_PADDING);
+		}
+	}
 }
 
 bool ScrollableTableWidget::relayoutColumns(std::vector<size_t> proposedColumnWidths, const std::unordered_set<size_t>& priorityIndexes)
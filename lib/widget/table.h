@@ -93,6 +93,12 @@ public:
 	void addRow(const std::shared_ptr<TableRow> &row);
 	void clearRows();
 
+	// Show numRows rows of rowHeight, instead of added rows
+	// Rows are only made (by calling makeRow) while they are in view, which keeps large tables cheap.
+	// makeRow may update and return reuse (a row which went out of view, if not nullptr) instead of making a new row.
+	typedef std::function<std::shared_ptr<TableRow> (size_t index, const std::shared_ptr<TableRow>& reuse)> MakeRowFunc;
+	void setRowSource(size_t numRows, int rowHeight, const MakeRowFunc& makeRow);
+
 	// Get the maximum width that can be used by the column widths passed to changeColumnWidths, based on the current widget size (minus padding)
 	size_t getMaxColumnTotalWidth(size_t numColumns) const;
 
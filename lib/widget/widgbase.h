@@ -30,6 +30,7 @@
 #include <vector>
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include "lib/framework/geometry.h"
 #include "lib/framework/wzstring.h"
 
@@ -381,7 +382,22 @@ public:
 		return lastHighlight.lock().get() == &widget;
 	}
 
+	/// Returns the widget with the given id, if it is the only one on the screen, or nullptr if not known.
+	/// Ids are often set right after attaching, so widgets are indexed by their id at the first lookup after
+	/// they were attached. Ids changed later are picked up by reindexWidgets(), or when found by the new id.
+	WIDGET *getIndexedWidget(UDWORD id);
+	void addIndexedWidget(const std::shared_ptr<WIDGET> &widget);
+	void removeIndexedWidget(WIDGET const &widget);
+	void widgetAttached(const std::shared_ptr<WIDGET> &widget);
+	/// Moves widgets whose ids changed to their current id in the index. Called once per widgRunScreen().
+	void reindexWidgets();
+
 private:
+	void indexAttachedWidgets();
+
+	std::unordered_map<UDWORD, std::vector<std::weak_ptr<WIDGET>>> widgetIndex;  ///< Widgets on the screen by id, to not search the whole tree in widgGetFromID()
+	std::vector<std::weak_ptr<WIDGET>> attachedWidgets;  ///< Attached since the last lookup, not indexed yet
+
 #ifdef WZ_CXX11
 	W_SCREEN(W_SCREEN const &) = delete;
 	W_SCREEN &operator =(W_SCREEN const &) = delete;
@@ -513,9 +513,14 @@ void WIDGET::setScreenPointer(const std::shared_ptr<W_SCREEN> &screen)
 		{
 			lockedScreen->lastHighlight.reset();
 		}
+		lockedScreen->removeIndexedWidget(*this);
 	}
 
 	screenPointer = screen;
+	if (screen)
+	{
+		screen->widgetAttached(shared_from_this());
+	}
 	for (auto const &child: childWidgets)
 	{
 		child->setScreenPointer(screen);
@@ -552,6 +557,113 @@ void W_SCREEN::initialize()
 
 	psForm = std::make_shared<W_FORM>(&sInit);
 	psForm->screenPointer = shared_from_this();
+	addIndexedWidget(psForm);
+}
+
+WIDGET *W_SCREEN::getIndexedWidget(UDWORD id)
+{
+	indexAttachedWidgets();
+	auto it = widgetIndex.find(id);
+	if (it == widgetIndex.end())
+	{
+		return nullptr;
+	}
+
+	// Forget widgets which were deleted or moved to another screen since, and move those given another id.
+	auto &widgets = it->second;
+	std::vector<std::shared_ptr<WIDGET>> moved;
+	widgets.erase(std::remove_if(widgets.begin(), widgets.end(), [this, id, &moved](std::weak_ptr<WIDGET> const &weakWidget) {
+		auto widget = weakWidget.lock();
+		if (widget != nullptr && widget->id != id && widget->screenPointer.lock().get() == this)
+		{
+			moved.push_back(widget);
+		}
+		return widget == nullptr || widget->id != id || widget->screenPointer.lock().get() != this;
+	}), widgets.end());
+	// If several widgets share the id, the caller must search the tree to find the first one.
+	WIDGET *result = widgets.size() == 1 ? widgets.front().lock().get() : nullptr;
+	if (widgets.empty())
+	{
+		widgetIndex.erase(it);
+	}
+	for (auto const &widget : moved)
+	{
+		addIndexedWidget(widget);
+	}
+	return result;
+}
+
+void W_SCREEN::addIndexedWidget(const std::shared_ptr<WIDGET> &widget)
+{
+	auto &widgets = widgetIndex[widget->id];
+	if (std::none_of(widgets.begin(), widgets.end(), [&widget](std::weak_ptr<WIDGET> const &other) { return other.lock() == widget; }))
+	{
+		widgets.push_back(widget);
+	}
+}
+
+void W_SCREEN::widgetAttached(const std::shared_ptr<WIDGET> &widget)
+{
+	attachedWidgets.push_back(widget);
+}
+
+void W_SCREEN::indexAttachedWidgets()
+{
+	for (auto const &weakWidget : attachedWidgets)
+	{
+		auto widget = weakWidget.lock();
+		if (widget != nullptr && widget->screenPointer.lock().get() == this)
+		{
+			addIndexedWidget(widget);
+		}
+	}
+	attachedWidgets.clear();
+}
+
+void W_SCREEN::reindexWidgets()
+{
+	indexAttachedWidgets();
+	std::vector<std::shared_ptr<WIDGET>> moved;
+	for (auto it = widgetIndex.begin(); it != widgetIndex.end();)
+	{
+		auto &widgets = it->second;
+		UDWORD id = it->first;
+		widgets.erase(std::remove_if(widgets.begin(), widgets.end(), [this, id, &moved](std::weak_ptr<WIDGET> const &weakWidget) {
+			auto widget = weakWidget.lock();
+			if (widget == nullptr || widget->screenPointer.lock().get() != this)
+			{
+				return true;
+			}
+			if (widget->id != id)
+			{
+				moved.push_back(widget);
+				return true;
+			}
+			return false;
+		}), widgets.end());
+		it = widgets.empty() ? widgetIndex.erase(it) : std::next(it);
+	}
+	for (auto const &widget : moved)
+	{
+		addIndexedWidget(widget);
+	}
+}
+
+void W_SCREEN::removeIndexedWidget(WIDGET const &widget)
+{
+	auto it = widgetIndex.find(widget.id);
+	if (it == widgetIndex.end())
+	{
+		return;
+	}
+	auto &widgets = it->second;
+	widgets.erase(std::remove_if(widgets.begin(), widgets.end(), [&widget](std::weak_ptr<WIDGET> const &other) {
+		return other.lock().get() == &widget;
+	}), widgets.end());
+	if (widgets.empty())
+	{
+		widgetIndex.erase(it);
+	}
 }
 
 void W_SCREEN::screenSizeDidChange(unsigned int oldWidth, unsigned int oldHeight, unsigned int newWidth, unsigned int newHeight)
@@ -728,7 +840,17 @@ static WIDGET *widgFormGetFromID(WIDGET *widget, UDWORD id)
 WIDGET *widgGetFromID(const std::shared_ptr<W_SCREEN> &psScreen, UDWORD id)
 {
 	ASSERT_OR_RETURN(nullptr, psScreen != nullptr, "Invalid screen pointer");
-	return widgFormGetFromID(psScreen->psForm.get(), id);
+	WIDGET *psWidget = psScreen->getIndexedWidget(id);
+	if (psWidget == nullptr)
+	{
+		// Not indexed, or the id was changed after the widget was attached.
+		psWidget = widgFormGetFromID(psScreen->psForm.get(), id);
+		if (psWidget != nullptr)
+		{
+			psScreen->addIndexedWidget(psWidget->shared_from_this());
+		}
+	}
+	return psWidget;
 }
 
 void widgHide(const std::shared_ptr<W_SCREEN> &psScreen, UDWORD id)
@@ -1168,6 +1290,7 @@ WidgetTriggers const &widgRunScreen(const std::shared_ptr<W_SCREEN> &psScreen)
 	ASSERT_OR_RETURN(assertReturn, psScreen != nullptr, "Invalid screen pointer");
 	psScreen->retWidgets.clear();
 	cleanupDeletedOverlays();
+	psScreen->reindexWidgets();
 
 	/* Initialise the context */
 	W_CONTEXT sContext = W_CONTEXT::ZeroContext();
@@ -1195,7 +1195,7 @@ void aiUpdateDroid(DROID *psDroid)
 				if (!orderState(psDroid, DORDER_HOLD)
 					&& secondaryGetState(psDroid, DSO_HALTTYPE) == DSS_HALT_PURSUE)
 				{
-					psDroid->order = DroidOrder(DORDER_OBSERVE, psTarget);
+					setDroidOrder(psDroid, DroidOrder(DORDER_OBSERVE, psTarget));
 				}
 				actionDroid(psDroid, DACTION_OBSERVE, psTarget);
 			}
@@ -1207,7 +1207,7 @@ void aiUpdateDroid(DROID *psDroid)
 				if (!orderState(psDroid, DORDER_HOLD)
 					&& secondaryGetState(psDroid, DSO_HALTTYPE) == DSS_HALT_PURSUE)
 				{
-					psDroid->order = DroidOrder(DORDER_ATTACK, psTarget);
+					setDroidOrder(psDroid, DroidOrder(DORDER_ATTACK, psTarget));
 				}
 				actionDroid(psDroid, DACTION_ATTACK, psTarget);
 			}
@@ -132,6 +132,9 @@ struct BASE_OBJECT : public SIMPLE_OBJECT
 
 	std::bitset<OBJECT_FLAG_COUNT> flags;
 
+	std::vector<BASE_OBJECT *> psReferrers;         ///< Objects with a target, order or base pointer to this one, once per pointer. See objChangeReference().
+	uint32_t            gridRepairableMark = 0;     ///< Grid reset at which the object was last added to the repairable objects, see gridMarkRepairable().
+
 	NEXTOBJ             psNext;                     ///< Pointer to the next object in the object list
 	NEXTOBJ             psNextFunc;                 ///< Pointer to the next object in the function list
 };
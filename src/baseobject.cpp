@@ -30,6 +30,8 @@
 #include "intdisplay.h"
 #include "map.h"
 
+#include <algorithm>
+
 
 static inline uint16_t interpolateAngle(uint16_t v1, uint16_t v2, uint32_t t1, uint32_t t2, uint32_t t)
 {
@@ -116,12 +118,83 @@ BASE_OBJECT::~BASE_OBJECT()
 {
 	visRemoveVisibility(this);
 
+	// Normally nothing refers to us any more (see checkReferences()), but if anything still does, don't leave it dangling.
+	while (!psReferrers.empty())
+	{
+		BASE_OBJECT *psReferrer = psReferrers.back();
+		if (psReferrer->type == OBJ_DROID)
+		{
+			DROID *psDroid = (DROID *)psReferrer;
+			if (psDroid->order.psObj == this)
+			{
+				setDroidTarget(psDroid, nullptr);
+			}
+			else if (psDroid->psBaseStruct == this)
+			{
+				setDroidBase(psDroid, nullptr);
+			}
+			else
+			{
+				for (unsigned i = 0; i < MAX_WEAPONS; ++i)
+				{
+					if (psDroid->psActionTarget[i] == this)
+					{
+						setDroidActionTarget(psDroid, nullptr, i);
+						break;
+					}
+				}
+			}
+		}
+		else if (psReferrer->type == OBJ_STRUCTURE)
+		{
+			STRUCTURE *psStruct = (STRUCTURE *)psReferrer;
+			for (unsigned i = 0; i < MAX_WEAPONS; ++i)
+			{
+				if (psStruct->psTarget[i] == this)
+				{
+					setStructureTarget(psStruct, nullptr, i, ORIGIN_UNKNOWN);
+					break;
+				}
+			}
+		}
+		if (!psReferrers.empty() && psReferrers.back() == psReferrer)
+		{
+			ASSERT(false, "Object %d is not referred to by %d", id, psReferrer->id);
+			psReferrers.pop_back();
+		}
+	}
+
 #ifdef DEBUG
 	psNext = this;                                                       // Hopefully this will trigger an infinite loop       if someone uses the freed object.
 	psNextFunc = this;                                                   // Hopefully this will trigger an infinite loop       if someone uses the freed object.
 #endif //DEBUG
 }
 
+void objChangeReference(BASE_OBJECT *psReferrer, BASE_OBJECT *psOld, BASE_OBJECT *psNew)
+{
+	if (psOld == psNew)
+	{
+		return;
+	}
+	if (psOld != nullptr)
+	{
+		// Search from the back, since the most recent references are the most likely to change again.
+		auto it = std::find(psOld->psReferrers.rbegin(), psOld->psReferrers.rend(), psReferrer);
+		if (it != psOld->psReferrers.rend())
+		{
+			psOld->psReferrers.erase(std::next(it).base());
+		}
+		else
+		{
+			ASSERT(false, "Object %d is not referred to by %d", psOld->id, psReferrer->id);
+		}
+	}
+	if (psNew != nullptr)
+	{
+		psNew->psReferrers.push_back(psReferrer);
+	}
+}
+
 void checkObject(const SIMPLE_OBJECT *psObject, const char *const location_description, const char *function, const int recurse)
 {
 	if (recurse < 0)
@@ -64,6 +64,10 @@ void checkObject(const SIMPLE_OBJECT *psObject, const char *const location_descr
 #define syncDebugObject(psObject, ch) _syncDebugObject(__FUNCTION__, psObject, ch)
 void _syncDebugObject(const char *function, SIMPLE_OBJECT const *psObject, char ch);
 
+/// Must be called whenever psReferrer's order target, action target, base or structure target changes from psOld to psNew,
+/// so that the objects referring to an object can be found without searching all objects. Use the setters in droid.h and structure.h.
+void objChangeReference(BASE_OBJECT *psReferrer, BASE_OBJECT *psOld, BASE_OBJECT *psNew);
+
 Vector2i getStatsSize(BASE_STATS const *pType, uint16_t direction);
 StructureBounds getStructureBounds(BASE_OBJECT const *object);
 StructureBounds getStructureBounds(BASE_STATS const *stats, Vector2i pos, uint16_t direction);
@@ -80,6 +80,7 @@ static CHEAT_ENTRY cheatCodes[] =
 	{"showunits", kf_ToggleUnitCount},	//displays unit count information
 	{"showsamples", kf_ToggleSamples}, //displays the # of Sound samples in Queue & List
 	{"showorders", kf_ToggleOrders}, //displays unit order/action state.
+	{"showperf", kf_TogglePerfStats}, //displays CPU and GPU times of the recent frames
 	{"pause", kf_TogglePauseMode}, // Pause the game.
 	{"power info", kf_PowerInfo},
 	{"reload me", kf_Reload},	// reload selected weapons immediately
@@ -107,6 +108,11 @@ bool _attemptCheatCode(const char *cheat_name)
 		kf_ToggleUnitCount();
 		return true;
 	}
+	if (!strcasecmp("showperf", cheat_name))
+	{
+		kf_TogglePerfStats();
+		return true;
+	}
 
 	if (strcmp(cheat_name, "cheat on") == 0 || strcmp(cheat_name, "debug") == 0)
 	{
@@ -82,6 +82,7 @@ static std::string wz_saveandquit;
 static std::string wz_test;
 static std::string wz_autoratingUrl;
 static bool wz_cli_headless = false;
+static bool wz_uncapped = false;
 
 #if defined(WZ_OS_WIN)
 
@@ -323,6 +324,7 @@ typedef enum
 	CLI_AUTOHOST,
 	CLI_AUTORATING,
 	CLI_AUTOHEADLESS,
+	CLI_UNCAPPED,
 #if defined(WZ_OS_WIN)
 	CLI_WIN_ENABLE_CONSOLE,
 #endif
@@ -377,6 +379,7 @@ static const struct poptOption *getOptionsTable()
 		},
 		{ "autogame", POPT_ARG_NONE, CLI_AUTOGAME,   N_("Run games automatically for testing"), nullptr },
 		{ "headless", POPT_ARG_NONE, CLI_AUTOHEADLESS,   N_("Headless mode (only supported when also specifying --autogame, --autohost, --skirmish)"), nullptr },
+		{ "uncapped", POPT_ARG_NONE, CLI_UNCAPPED,   N_("Run the game as fast as possible, without sound (only supported in headless mode)"), nullptr },
 		{ "saveandquit", POPT_ARG_STRING, CLI_SAVEANDQUIT, N_("Immediately save game and quit"), N_("save name") },
 		{ "skirmish", POPT_ARG_STRING, CLI_SKIRMISH,   N_("Start skirmish game with given settings file"), N_("test") },
 		{ "continue", POPT_ARG_NONE, CLI_CONTINUE,   N_("Continue the last saved game"), nullptr },
@@ -839,6 +842,10 @@ bool ParseCommandLine(int argc, const char * const *argv)
 			setHeadlessGameMode(true);
 			break;
 
+		case CLI_UNCAPPED:
+			wz_uncapped = true;
+			break;
+
 		case CLI_GAMEPORT:
 			token = poptGetOptArg(poptCon);
 			if (token == nullptr)
@@ -860,6 +867,11 @@ bool autogame_enabled()
 	return wz_autogame;
 }
 
+bool uncapped_enabled()
+{
+	return wz_uncapped;
+}
+
 const std::string &saveandquit_enabled()
 {
 	return wz_saveandquit;
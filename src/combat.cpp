@@ -482,6 +482,7 @@ int32_t objDamage(BASE_OBJECT *psObj, unsigned damage, unsigned originalhp, WEAP
 
 	// Subtract the dealt damage from the droid's remaining body points
 	psObj->body -= actualDamage;
+	gridMarkRepairable(psObj);
 
 	syncDebugObject(psObj, 'D');
 
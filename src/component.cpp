@@ -43,6 +43,9 @@
 #endif
 #include <glm/gtx/transform.hpp>
 
+#include <unordered_map>
+#include <vector>
+
 #define GetRadius(x) ((x)->sradius)
 
 #define	DEFAULT_COMPONENT_TRANSLUCENCY	128
@@ -324,18 +327,226 @@ void displayResearchButton(BASE_STATS *Stat, const Vector3i *Rotation, const Vec
 }
 
 
-static inline iIMDShape *getLeftPropulsionIMD(DROID *psDroid)
+/// Identifies a combination of droid components, droids that share one look exactly the same apart from animation
+struct DroidLayoutKey
 {
-	int bodyStat = psDroid->asBits[COMP_BODY];
-	int propStat = psDroid->asBits[COMP_PROPULSION];
-	return asBodyStats[bodyStat].ppIMDList[propStat * NUM_PROP_SIDES + LEFT_PROP];
+	DROID_TYPE droidType;
+	unsigned numWeaps;
+	uint8_t asBits[DROID_MAXCOMP];
+	uint32_t asWeaps[MAX_WEAPONS];
+
+	bool operator ==(DroidLayoutKey const &b) const
+	{
+		return memcmp(this, &b, sizeof(*this)) == 0;
+	}
+};
+
+namespace std
+{
+	template <>
+	struct hash<DroidLayoutKey>
+	{
+		std::size_t operator()(DroidLayoutKey const &k) const
+		{
+			// FNV-1a
+			uint32_t h = 2166136261u;
+			uint8_t const *bytes = reinterpret_cast<uint8_t const *>(&k);
+			for (size_t i = 0; i < sizeof(k); ++i)
+			{
+				h = (h ^ bytes[i]) * 16777619u;
+			}
+			return h;
+		}
+	};
 }
 
-static inline iIMDShape *getRightPropulsionIMD(DROID *psDroid)
+/// A turret and where it attaches, only the rotation and recoil of the turret change from frame to frame
+struct DroidLayoutTurret
+{
+	unsigned weaponSlot;             ///< Index into asWeaps, for rotation, recoil and muzzle flash
+	glm::mat4 connector;             ///< Moves to the body connector the turret is mounted on
+	iIMDShape *psMount;
+	glm::mat4 mountConnector;        ///< Moves from the mount to where the turret sits on it
+	iIMDShape *psShape;
+	iIMDShape *psMuzzleFlash;        ///< Weapons only
+	bool hasRepairConnector;         ///< Repair turrets only, where the repair flame comes out
+	glm::mat4 repairConnector;
+};
+
+/// Everything displayCompObj needs to know about a combination of components, worked out once per combination
+struct DroidLayout
 {
-	int bodyStat = psDroid->asBits[COMP_BODY];
-	int propStat = psDroid->asBits[COMP_PROPULSION];
-	return asBodyStats[bodyStat].ppIMDList[propStat * NUM_PROP_SIDES + RIGHT_PROP];
+	iIMDShape *psLeftProp;
+	iIMDShape *psRightProp;
+	iIMDShape *psBody;
+	iIMDShape *psMoveAnim;
+	iIMDShape *psStillAnim;
+	bool floating;                   ///< Propellors sink into the water, except in buttons
+	bool person;                     ///< People are drawn smaller
+	bool propTranslucent;            ///< Default components are drawn translucent
+	bool bodyTranslucent;
+	bool turretTranslucent;
+	bool vtolTurrets;                ///< Turrets hang underneath, upside down
+	bool weaponTurrets;              ///< Turrets are weapons rather than sensor, construct, ECM or repair turrets
+	std::vector<DroidLayoutTurret> turrets;
+};
+
+static std::unordered_map<DroidLayoutKey, DroidLayout> droidLayouts;
+
+static DroidLayout buildDroidLayout(DROID const *psDroid)
+{
+	DroidLayout layout;
+	BODY_STATS const &body = asBodyStats[psDroid->asBits[COMP_BODY]];
+	PROPULSION_STATS const *psPropStats = asPropulsionStats + psDroid->asBits[COMP_PROPULSION];
+	const int propStat = psDroid->asBits[COMP_PROPULSION];
+
+	layout.psLeftProp = body.ppIMDList[propStat * NUM_PROP_SIDES + LEFT_PROP];
+	layout.psRightProp = body.ppIMDList[propStat * NUM_PROP_SIDES + RIGHT_PROP];
+	layout.psBody = BODY_IMD(psDroid, psDroid->player);
+	layout.psMoveAnim = body.ppMoveIMDList[propStat];
+	layout.psStillAnim = body.ppStillIMDList[propStat];
+	layout.floating = psPropStats->propulsionType == PROPULSION_TYPE_PROPELLOR;
+	layout.person = psDroid->droidType == DROID_PERSON;
+	layout.propTranslucent = psDroid->asBits[COMP_PROPULSION] == 0;
+	layout.bodyTranslucent = psDroid->asBits[COMP_BODY] == 0;
+	layout.turretTranslucent = psDroid->asWeaps[0].nStat        == 0 &&
+	                           psDroid->asBits[COMP_SENSOR]     == 0 &&
+	                           psDroid->asBits[COMP_ECM]        == 0 &&
+	                           psDroid->asBits[COMP_BRAIN]      == 0 &&
+	                           psDroid->asBits[COMP_REPAIRUNIT] == 0 &&
+	                           psDroid->asBits[COMP_CONSTRUCT]  == 0;
+	layout.vtolTurrets = false;
+	layout.weaponTurrets = false;
+
+	iIMDShape *psShapeBody = layout.psBody;
+	if (!psShapeBody || !psShapeBody->nconnectors)
+	{
+		return layout;
+	}
+
+	/* vtol weapons attach to connector 2 (underneath);
+	 * all others to connector 1 */
+	/* VTOL's now skip the first 5 connectors(0 to 4),
+	VTOL's use 5,6,7,8 etc now */
+	layout.vtolTurrets = psPropStats->propulsionType == PROPULSION_TYPE_LIFT && psDroid->droidType == DROID_WEAPON;
+	const int iConnector = layout.vtolTurrets ? VTOL_CONNECTOR_START : 0;
+
+	switch (psDroid->droidType)
+	{
+	case DROID_DEFAULT:
+	case DROID_TRANSPORTER:
+	case DROID_SUPERTRANSPORTER:
+	case DROID_CYBORG:
+	case DROID_CYBORG_SUPER:
+	case DROID_WEAPON:
+	case DROID_COMMAND:		// command droids have a weapon to store all the graphics
+		layout.weaponTurrets = true;
+		/* Double check that the weapon droid actually has any */
+		for (unsigned i = 0; i < psDroid->numWeaps; i++)
+		{
+			if ((psDroid->asWeaps[i].nStat > 0 || psDroid->droidType == DROID_DEFAULT)
+			    && psShapeBody->connectors)
+			{
+				DroidLayoutTurret turret;
+				turret.weaponSlot = i;
+				turret.connector = glm::translate(glm::vec3(psShapeBody->connectors[iConnector + i].xzy()));
+				turret.psMount = WEAPON_MOUNT_IMD(psDroid, i);
+				/* translate for weapon mount point */
+				turret.mountConnector = turret.psMount && turret.psMount->nconnectors ? glm::translate(glm::vec3(turret.psMount->connectors->xzy())) : glm::mat4(1.f);
+				turret.psShape = WEAPON_IMD(psDroid, i);
+				turret.psMuzzleFlash = MUZZLE_FLASH_PIE(psDroid, i);
+				turret.hasRepairConnector = false;
+				layout.turrets.push_back(turret);
+			}
+		}
+		break;
+
+	case DROID_SENSOR:
+	case DROID_CONSTRUCT:
+	case DROID_CYBORG_CONSTRUCT:
+	case DROID_ECM:
+	case DROID_REPAIR:
+	case DROID_CYBORG_REPAIR:
+		{
+			DroidLayoutTurret turret;
+			turret.weaponSlot = 0;
+			turret.psMount = nullptr;
+			turret.psShape = nullptr;
+			turret.psMuzzleFlash = nullptr;
+			switch (psDroid->droidType)
+			{
+			default:
+				ASSERT(false, "Bad component type");
+				break;
+			case DROID_SENSOR:
+				turret.psMount = SENSOR_MOUNT_IMD(psDroid, psDroid->player);
+				/* Get the sensor graphic, assuming it's there */
+				turret.psShape = SENSOR_IMD(psDroid, psDroid->player);
+				break;
+			case DROID_CONSTRUCT:
+			case DROID_CYBORG_CONSTRUCT:
+				turret.psMount = CONSTRUCT_MOUNT_IMD(psDroid, psDroid->player);
+				/* Get the construct graphic assuming it's there */
+				turret.psShape = CONSTRUCT_IMD(psDroid, psDroid->player);
+				break;
+			case DROID_ECM:
+				turret.psMount = ECM_MOUNT_IMD(psDroid, psDroid->player);
+				/* Get the ECM graphic assuming it's there.... */
+				turret.psShape = ECM_IMD(psDroid, psDroid->player);
+				break;
+			case DROID_REPAIR:
+			case DROID_CYBORG_REPAIR:
+				turret.psMount = REPAIR_MOUNT_IMD(psDroid, psDroid->player);
+				/* Get the Repair graphic assuming it's there.... */
+				turret.psShape = REPAIR_IMD(psDroid, psDroid->player);
+				break;
+			}
+			//sensor and cyborg and ecm uses connectors[0]
+			turret.connector = glm::translate(glm::vec3(psShapeBody->connectors[0].xzy()));
+
+			/* translate for construct mount point if cyborg */
+			const bool cyborgMount = cyborgDroid(psDroid) && turret.psMount && turret.psMount->nconnectors;
+			turret.mountConnector = cyborgMount ? glm::translate(glm::vec3(turret.psMount->connectors[0].xzy())) : glm::mat4(1.f);
+
+			turret.hasRepairConnector = (psDroid->droidType == DROID_REPAIR || psDroid->droidType == DROID_CYBORG_REPAIR) &&
+			                            turret.psShape && turret.psShape->nconnectors;
+			turret.repairConnector = turret.hasRepairConnector ? glm::translate(glm::vec3(turret.psShape->connectors[0].xzy())) * glm::translate(glm::vec3(0.f, -20.f, 0.f)) : glm::mat4(1.f);
+			layout.turrets.push_back(turret);
+			break;
+		}
+	case DROID_PERSON:
+		// no extra mounts for people
+		break;
+	default:
+		ASSERT(!"invalid droid type", "Whoa! Weirdy type of droid found in drawComponentObject!!!");
+		break;
+	}
+	return layout;
+}
+
+static DroidLayout const &getDroidLayout(DROID const *psDroid)
+{
+	DroidLayoutKey key;
+	memset(&key, 0, sizeof(key));  // Padding is compared and hashed too
+	key.droidType = psDroid->droidType;
+	key.numWeaps = psDroid->numWeaps;
+	memcpy(key.asBits, psDroid->asBits, sizeof(key.asBits));
+	for (unsigned i = 0; i < psDroid->numWeaps && i < MAX_WEAPONS; ++i)
+	{
+		key.asWeaps[i] = psDroid->asWeaps[i].nStat;
+	}
+
+	auto it = droidLayouts.find(key);
+	if (it == droidLayouts.end())
+	{
+		it = droidLayouts.emplace(key, buildDroidLayout(psDroid)).first;
+	}
+	return it->second;
+}
+
+void clearDroidLayouts()
+{
+	droidLayouts.clear();
 }
 
 void drawMuzzleFlash(WEAPON sWeap, iIMDShape *weaponImd, iIMDShape *flashImd, PIELIGHT buildingBrightness, int pieFlag, int iPieData, const glm::mat4 &viewMatrix, UBYTE colour)
@@ -382,13 +593,9 @@ void drawMuzzleFlash(WEAPON sWeap, iIMDShape *weaponImd, iIMDShape *flashImd, PI
 // removed mountRotation,they get such stuff from psObj directly now
 static bool displayCompObj(DROID *psDroid, bool bButton, const glm::mat4 &viewMatrix)
 {
-	iIMDShape *psMoveAnim, *psStillAnim;
-	SDWORD				iConnector;
-	PROPULSION_STATS	*psPropStats;
 	SDWORD				pieFlag, iPieData;
 	PIELIGHT			brightness;
 	UDWORD				colour;
-	size_t	i = 0;
 	bool				didDrawSomething = false;
 
 	glm::mat4 modelMatrix(1.f);
@@ -402,9 +609,7 @@ static bool displayCompObj(DROID *psDroid, bool bButton, const glm::mat4 &viewMa
 		colour = getPlayerColour(psDroid->player);
 	}
 
-	/* get propulsion stats */
-	psPropStats = asPropulsionStats + psDroid->asBits[COMP_PROPULSION];
-	ASSERT_OR_RETURN(didDrawSomething, psPropStats != nullptr, "invalid propulsion stats pointer");
+	DroidLayout const &layout = getDroidLayout(psDroid);
 
 	//set pieflag for button object or ingame object
 	if (bButton)
@@ -428,23 +633,27 @@ static bool displayCompObj(DROID *psDroid, bool bButton, const glm::mat4 &viewMa
 	}
 
 	/* set default components transparent */
-	if (psDroid->asBits[COMP_PROPULSION] == 0)
-	{
-		pieFlag  |= pie_TRANSLUCENT;
-		iPieData  = DEFAULT_COMPONENT_TRANSLUCENCY;
-	}
-	else
-	{
-		iPieData = 0;
-	}
+	auto setTranslucent = [&](bool translucent) {
+		if (translucent)
+		{
+			pieFlag  |= pie_TRANSLUCENT;
+			iPieData  = DEFAULT_COMPONENT_TRANSLUCENCY;
+		}
+		else
+		{
+			pieFlag  &= ~pie_TRANSLUCENT;
+			iPieData = 0;
+		}
+	};
+	setTranslucent(layout.propTranslucent);
 
-	if (!bButton && psPropStats->propulsionType == PROPULSION_TYPE_PROPELLOR)
+	if (!bButton && layout.floating)
 	{
 		// FIXME: change when adding submarines to the game
 		modelMatrix *= glm::translate(glm::vec3(0.f, -world_coord(1) / 2.3f, 0.f));
 	}
 
-	iIMDShape *psShapeProp = (leftFirst ? getLeftPropulsionIMD(psDroid) : getRightPropulsionIMD(psDroid));
+	iIMDShape *psShapeProp = (leftFirst ? layout.psLeftProp : layout.psRightProp);
 	if (psShapeProp)
 	{
 		if (pie_Draw3DShape(psShapeProp, 0, colour, brightness, pieFlag, iPieData, viewMatrix * modelMatrix))
@@ -453,24 +662,14 @@ static bool displayCompObj(DROID *psDroid, bool bButton, const glm::mat4 &viewMa
 		}
 	}
 
-	/* set default components transparent */
-	if (psDroid->asBits[COMP_BODY] == 0)
-	{
-		pieFlag  |= pie_TRANSLUCENT;
-		iPieData  = DEFAULT_COMPONENT_TRANSLUCENCY;
-	}
-	else
-	{
-		pieFlag  &= ~pie_TRANSLUCENT;
-		iPieData = 0;
-	}
+	setTranslucent(layout.bodyTranslucent);
 
 	/* Get the body graphic now*/
-	iIMDShape *psShapeBody = BODY_IMD(psDroid, psDroid->player);
+	iIMDShape *psShapeBody = layout.psBody;
 	if (psShapeBody)
 	{
 		iIMDShape *strImd = psShapeBody;
-		if (psDroid->droidType == DROID_PERSON)
+		if (layout.person)
 		{
 			modelMatrix *= glm::scale(glm::vec3(.75f)); // FIXME - hideous....!!!!
 		}
@@ -490,8 +689,8 @@ static bool displayCompObj(DROID *psDroid, bool bButton, const glm::mat4 &viewMa
 	}
 
 	/* Render animation effects based on movement or lack thereof, if any */
-	psMoveAnim = asBodyStats[psDroid->asBits[COMP_BODY]].ppMoveIMDList[psDroid->asBits[COMP_PROPULSION]];
-	psStillAnim = asBodyStats[psDroid->asBits[COMP_BODY]].ppStillIMDList[psDroid->asBits[COMP_PROPULSION]];
+	iIMDShape *psMoveAnim = layout.psMoveAnim;
+	iIMDShape *psStillAnim = layout.psStillAnim;
 	glm::mat4 viewModelMatrix = viewMatrix * modelMatrix;
 	if (!bButton && psMoveAnim && psDroid->sMove.Status != MOVEINACTIVE)
 	{
@@ -515,261 +714,117 @@ static bool displayCompObj(DROID *psDroid, bool bButton, const glm::mat4 &viewMa
 		calcScreenCoords(psDroid, viewModelMatrix);
 	}
 
-	/* set default components transparent */
-	if (psDroid->asWeaps[0].nStat        == 0 &&
-	    psDroid->asBits[COMP_SENSOR]     == 0 &&
-	    psDroid->asBits[COMP_ECM]        == 0 &&
-	    psDroid->asBits[COMP_BRAIN]      == 0 &&
-	    psDroid->asBits[COMP_REPAIRUNIT] == 0 &&
-	    psDroid->asBits[COMP_CONSTRUCT]  == 0)
-	{
-		pieFlag  |= pie_TRANSLUCENT;
-		iPieData  = DEFAULT_COMPONENT_TRANSLUCENCY;
-	}
-	else
-	{
-		pieFlag  &= ~pie_TRANSLUCENT;
-		iPieData = 0;
-	}
+	setTranslucent(layout.turretTranslucent);
 
-	if (psShapeBody && psShapeBody->nconnectors)
+	for (DroidLayoutTurret const &turret : layout.turrets)
 	{
-		/* vtol weapons attach to connector 2 (underneath);
-		 * all others to connector 1 */
-		/* VTOL's now skip the first 5 connectors(0 to 4),
-		VTOL's use 5,6,7,8 etc now */
-		if (psPropStats->propulsionType == PROPULSION_TYPE_LIFT && psDroid->droidType == DROID_WEAPON)
+		if (layout.weaponTurrets)
 		{
-			iConnector = VTOL_CONNECTOR_START;
-		}
-		else
-		{
-			iConnector = 0;
-		}
-
-		switch (psDroid->droidType)
-		{
-		case DROID_DEFAULT:
-		case DROID_TRANSPORTER:
-		case DROID_SUPERTRANSPORTER:
-		case DROID_CYBORG:
-		case DROID_CYBORG_SUPER:
-		case DROID_WEAPON:
-		case DROID_COMMAND:		// command droids have a weapon to store all the graphics
-			/*	Get the mounting graphic - we've already moved to the right position
-			Allegedly - all droids will have a mount graphic so this shouldn't
-			fall on it's arse......*/
-			/* Double check that the weapon droid actually has any */
-			for (i = 0; i < psDroid->numWeaps; i++)
-			{
-				if ((psDroid->asWeaps[i].nStat > 0 || psDroid->droidType == DROID_DEFAULT)
-				    && psShapeBody->connectors)
-				{
-					Rotation rot = getInterpolatedWeaponRotation(psDroid, i, graphicsTime);
-
-					glm::mat4 localModelMatrix = modelMatrix;
-
-					//to skip number of VTOL_CONNECTOR_START ground unit connectors
-					if (iConnector < VTOL_CONNECTOR_START)
-					{
-						localModelMatrix *= glm::translate(glm::vec3(psShapeBody->connectors[i].xzy()));
-					}
-					else
-					{
-						localModelMatrix *= glm::translate(glm::vec3(psShapeBody->connectors[iConnector + i].xzy()));
-					}
-					localModelMatrix *= glm::rotate(UNDEG(-rot.direction), glm::vec3(0.f, 1.f, 0.f));
-
-					/* vtol weapons inverted */
-					if (iConnector >= VTOL_CONNECTOR_START)
-					{
-						//this might affect gun rotation
-						localModelMatrix *= glm::rotate(UNDEG(65536 / 2), glm::vec3(0.f, 0.f, 1.f));
-					}
+			Rotation rot = getInterpolatedWeaponRotation(psDroid, turret.weaponSlot, graphicsTime);
 
-					/* Get the mount graphic */
-					iIMDShape *psShape = WEAPON_MOUNT_IMD(psDroid, i);
+			glm::mat4 localModelMatrix = modelMatrix * turret.connector;
+			localModelMatrix *= glm::rotate(UNDEG(-rot.direction), glm::vec3(0.f, 1.f, 0.f));
 
-					int recoilValue = getRecoil(psDroid->asWeaps[i]);
-					localModelMatrix *= glm::translate(glm::vec3(0.f, 0.f, recoilValue / 3.f));
-
-					/* Draw it */
-					if (psShape)
-					{
-						if (pie_Draw3DShape(psShape, 0, colour, brightness, pieFlag, iPieData, viewMatrix * localModelMatrix))
-						{
-							didDrawSomething = true;
-						}
-					}
-					localModelMatrix *= glm::translate(glm::vec3(0, 0, recoilValue));
-
-					/* translate for weapon mount point */
-					if (psShape && psShape->nconnectors)
-					{
-						localModelMatrix *= glm::translate(glm::vec3(psShape->connectors->xzy()));
-					}
-
-					/* vtol weapons inverted */
-					if (iConnector >= VTOL_CONNECTOR_START)
-					{
-						//pitch the barrel down
-						localModelMatrix *= glm::rotate(UNDEG(-rot.pitch), glm::vec3(1.f, 0.f, 0.f));
-					}
-					else
-					{
-						//pitch the barrel up
-						localModelMatrix *= glm::rotate(UNDEG(rot.pitch), glm::vec3(1.f, 0.f, 0.f));
-					}
+			/* vtol weapons inverted */
+			if (layout.vtolTurrets)
+			{
+				//this might affect gun rotation
+				localModelMatrix *= glm::rotate(UNDEG(65536 / 2), glm::vec3(0.f, 0.f, 1.f));
+			}
 
-					/* Get the weapon (gun?) graphic */
-					psShape = WEAPON_IMD(psDroid, i);
+			int recoilValue = getRecoil(psDroid->asWeaps[turret.weaponSlot]);
+			localModelMatrix *= glm::translate(glm::vec3(0.f, 0.f, recoilValue / 3.f));
 
-					// We have a weapon so we draw it and a muzzle flash from weapon connector
-					if (psShape)
-					{
-						glm::mat4 localViewModelMatrix = viewMatrix * localModelMatrix;
-						if (pie_Draw3DShape(psShape, 0, colour, brightness, pieFlag, iPieData, localViewModelMatrix))
-						{
-							didDrawSomething = true;
-						}
-						drawMuzzleFlash(psDroid->asWeaps[i], psShape, MUZZLE_FLASH_PIE(psDroid, i), brightness, pieFlag, iPieData, localViewModelMatrix);
-					}
+			/* Draw it */
+			if (turret.psMount)
+			{
+				if (pie_Draw3DShape(turret.psMount, 0, colour, brightness, pieFlag, iPieData, viewMatrix * localModelMatrix))
+				{
+					didDrawSomething = true;
 				}
 			}
-			break;
+			localModelMatrix *= glm::translate(glm::vec3(0, 0, recoilValue));
+			localModelMatrix *= turret.mountConnector;
 
-		case DROID_SENSOR:
-		case DROID_CONSTRUCT:
-		case DROID_CYBORG_CONSTRUCT:
-		case DROID_ECM:
-		case DROID_REPAIR:
-		case DROID_CYBORG_REPAIR:
+			/* vtol weapons inverted */
+			if (layout.vtolTurrets)
 			{
-				Rotation rot = getInterpolatedWeaponRotation(psDroid, 0, graphicsTime);
-				iIMDShape *psShape = nullptr;
-				iIMDShape *psMountShape = nullptr;
+				//pitch the barrel down
+				localModelMatrix *= glm::rotate(UNDEG(-rot.pitch), glm::vec3(1.f, 0.f, 0.f));
+			}
+			else
+			{
+				//pitch the barrel up
+				localModelMatrix *= glm::rotate(UNDEG(rot.pitch), glm::vec3(1.f, 0.f, 0.f));
+			}
 
-				switch (psDroid->droidType)
+			// We have a weapon so we draw it and a muzzle flash from weapon connector
+			if (turret.psShape)
+			{
+				glm::mat4 localViewModelMatrix = viewMatrix * localModelMatrix;
+				if (pie_Draw3DShape(turret.psShape, 0, colour, brightness, pieFlag, iPieData, localViewModelMatrix))
 				{
-				default:
-					ASSERT(false, "Bad component type");
-					break;
-				case DROID_SENSOR:
-					psMountShape = SENSOR_MOUNT_IMD(psDroid, psDroid->player);
-					/* Get the sensor graphic, assuming it's there */
-					psShape = SENSOR_IMD(psDroid, psDroid->player);
-					break;
-				case DROID_CONSTRUCT:
-				case DROID_CYBORG_CONSTRUCT:
-					psMountShape = CONSTRUCT_MOUNT_IMD(psDroid, psDroid->player);
-					/* Get the construct graphic assuming it's there */
-					psShape = CONSTRUCT_IMD(psDroid, psDroid->player);
-					break;
-				case DROID_ECM:
-					psMountShape = ECM_MOUNT_IMD(psDroid, psDroid->player);
-					/* Get the ECM graphic assuming it's there.... */
-					psShape = ECM_IMD(psDroid, psDroid->player);
-					break;
-				case DROID_REPAIR:
-				case DROID_CYBORG_REPAIR:
-					psMountShape = REPAIR_MOUNT_IMD(psDroid, psDroid->player);
-					/* Get the Repair graphic assuming it's there.... */
-					psShape = REPAIR_IMD(psDroid, psDroid->player);
-					break;
+					didDrawSomething = true;
 				}
-				/*	Get the mounting graphic - we've already moved to the right position
-				Allegedly - all droids will have a mount graphic so this shouldn't
-				fall on it's arse......*/
-				//sensor and cyborg and ecm uses connectors[0]
-
-				glm::mat4 localModelMatrix = modelMatrix;
-				/* vtol weapons inverted */
-				if (iConnector >= VTOL_CONNECTOR_START)
+				drawMuzzleFlash(psDroid->asWeaps[turret.weaponSlot], turret.psShape, turret.psMuzzleFlash, brightness, pieFlag, iPieData, localViewModelMatrix);
+			}
+		}
+		else
+		{
+			Rotation rot = getInterpolatedWeaponRotation(psDroid, 0, graphicsTime);
+
+			glm::mat4 localModelMatrix = modelMatrix * turret.connector;
+			localModelMatrix *= glm::rotate(UNDEG(-rot.direction), glm::vec3(0.f, 1.f, 0.f));
+			/* Draw it */
+			if (turret.psMount)
+			{
+				if (pie_Draw3DShape(turret.psMount, 0, colour, brightness, pieFlag, iPieData, viewMatrix * localModelMatrix))
 				{
-					//this might affect gun rotation
-					localModelMatrix *= glm::rotate(UNDEG(65536 / 2), glm::vec3(0.f, 0.f, 1.f));
+					didDrawSomething = true;
 				}
+			}
 
-				localModelMatrix *= glm::translate(glm::vec3(psShapeBody->connectors[0].xzy()));
+			localModelMatrix *= turret.mountConnector;
 
-				localModelMatrix *= glm::rotate(UNDEG(-rot.direction), glm::vec3(0.f, 1.f, 0.f));
-				/* Draw it */
-				if (psMountShape)
+			/* Draw it */
+			if (turret.psShape)
+			{
+				if (pie_Draw3DShape(turret.psShape, 0, colour, brightness, pieFlag, iPieData, viewMatrix * localModelMatrix))
 				{
-					if (pie_Draw3DShape(psMountShape, 0, colour, brightness, pieFlag, iPieData, viewMatrix * localModelMatrix))
-					{
-						didDrawSomething = true;
-					}
+					didDrawSomething = true;
 				}
 
-				/* translate for construct mount point if cyborg */
-				if (cyborgDroid(psDroid) && psMountShape && psMountShape->nconnectors)
+				// In repair droid case only:
+				if (turret.hasRepairConnector && psDroid->action == DACTION_DROIDREPAIR)
 				{
-					localModelMatrix *= glm::translate(glm::vec3(psMountShape->connectors[0].xzy()));
-				}
+					Spacetime st = interpolateObjectSpacetime(psDroid, graphicsTime);
+					localModelMatrix *= turret.repairConnector;
 
-				/* Draw it */
-				if (psShape)
-				{
-					if (pie_Draw3DShape(psShape, 0, colour, brightness, pieFlag, iPieData, viewMatrix * localModelMatrix))
-					{
-						didDrawSomething = true;
-					}
-
-					// In repair droid case only:
-					if ((psDroid->droidType == DROID_REPAIR || psDroid->droidType == DROID_CYBORG_REPAIR) &&
-					    psShape->nconnectors && psDroid->action == DACTION_DROIDREPAIR)
-					{
-						Spacetime st = interpolateObjectSpacetime(psDroid, graphicsTime);
-						localModelMatrix *= glm::translate(glm::vec3(psShape->connectors[0].xzy()));
-						localModelMatrix *= glm::translate(glm::vec3(0.f, -20.f, 0.f));
-
-						psShape = getImdFromIndex(MI_FLAME);
+					iIMDShape *psFlame = getImdFromIndex(MI_FLAME);
 
-						/* Rotate for droid */
-						localModelMatrix *= glm::rotate(UNDEG(st.rot.direction), glm::vec3(0.f, 1.f, 0.f));
-						localModelMatrix *= glm::rotate(UNDEG(-st.rot.pitch), glm::vec3(1.f, 0.f, 0.f));
-						localModelMatrix *= glm::rotate(UNDEG(-st.rot.roll), glm::vec3(0.f, 0.f, 1.f));
-						//rotate Y
-						localModelMatrix *= glm::rotate(UNDEG(rot.direction), glm::vec3(0.f, 1.f, 0.f));
+					/* Rotate for droid */
+					localModelMatrix *= glm::rotate(UNDEG(st.rot.direction), glm::vec3(0.f, 1.f, 0.f));
+					localModelMatrix *= glm::rotate(UNDEG(-st.rot.pitch), glm::vec3(1.f, 0.f, 0.f));
+					localModelMatrix *= glm::rotate(UNDEG(-st.rot.roll), glm::vec3(0.f, 0.f, 1.f));
+					//rotate Y
+					localModelMatrix *= glm::rotate(UNDEG(rot.direction), glm::vec3(0.f, 1.f, 0.f));
 
-						localModelMatrix *= glm::rotate(UNDEG(-playerPos.r.y), glm::vec3(0.f, 1.f, 0.f));
-						localModelMatrix *= glm::rotate(UNDEG(-playerPos.r.x), glm::vec3(1.f, 0.f, 0.f));
+					localModelMatrix *= glm::rotate(UNDEG(-playerPos.r.y), glm::vec3(0.f, 1.f, 0.f));
+					localModelMatrix *= glm::rotate(UNDEG(-playerPos.r.x), glm::vec3(1.f, 0.f, 0.f));
 
-						if (pie_Draw3DShape(psShape, getModularScaledGraphicsTime(psShape->animInterval, psShape->numFrames), 0, brightness, pie_ADDITIVE, 140, viewMatrix * localModelMatrix))
-						{
-							didDrawSomething = true;
-						}
-
-//						localModelMatrix *= glm::rotate(UNDEG(playerPos.r.x), glm::vec3(1.f, 0.f, 0.f)); // Not used?
-//						localModelMatrix *= glm::rotate(UNDEG(playerPos.r.y), glm::vec3(0.f, 1.f, 0.f)); // Not used?
+					if (pie_Draw3DShape(psFlame, getModularScaledGraphicsTime(psFlame->animInterval, psFlame->numFrames), 0, brightness, pie_ADDITIVE, 140, viewMatrix * localModelMatrix))
+					{
+						didDrawSomething = true;
 					}
 				}
-				break;
 			}
-		case DROID_PERSON:
-			// no extra mounts for people
-			break;
-		default:
-			ASSERT(!"invalid droid type", "Whoa! Weirdy type of droid found in drawComponentObject!!!");
-			break;
 		}
 	}
 
-	/* set default components transparent */
-	if (psDroid->asBits[COMP_PROPULSION] == 0)
-	{
-		pieFlag  |= pie_TRANSLUCENT;
-		iPieData  = DEFAULT_COMPONENT_TRANSLUCENCY;
-	}
-	else
-	{
-		pieFlag  &= ~pie_TRANSLUCENT;
-		iPieData = 0;
-	}
+	setTranslucent(layout.propTranslucent);
 
 	// now render the other propulsion side
-	psShapeProp = (leftFirst ? getRightPropulsionIMD(psDroid) : getLeftPropulsionIMD(psDroid));
+	psShapeProp = (leftFirst ? layout.psRightProp : layout.psLeftProp);
 	if (psShapeProp)
 	{
 		if (pie_Draw3DShape(psShapeProp, 0, colour, brightness, pieFlag, iPieData, viewModelMatrix)) // Safe to use viewModelMatrix because modelView has not been changed since it was calculated
@@ -883,6 +938,7 @@ void displayComponentObject(DROID *psDroid, const glm::mat4 &viewMatrix)
 		{
 			// did draw something to the screen - update the framenumber
 			psDroid->sDisplay.frameNumber = frameGetFrameNumber();
+			pickIndexAddDroid(psDroid);
 		}
 	}
 	else
@@ -891,6 +947,7 @@ void displayComponentObject(DROID *psDroid, const glm::mat4 &viewMatrix)
 		if (pie_Draw3DShape(getImdFromIndex(MI_BLIP), frame, 0, WZCOL_WHITE, pie_ADDITIVE, psDroid->visible[selectedPlayer] / 2, viewMatrix * modelMatrix))
 		{
 			psDroid->sDisplay.frameNumber = frameGetFrameNumber();
+			pickIndexAddDroid(psDroid);
 		}
 	}
 }
@@ -72,6 +72,9 @@ void displayComponentObject(DROID *psDroid, const glm::mat4 &viewMatrix);
 
 void compPersonToBits(DROID *psDroid);
 
+/// Forgets the component layouts worked out for drawing droids, must be called when the component stats are freed
+void clearDroidLayouts();
+
 SDWORD rescaleButtonObject(SDWORD radius, SDWORD baseScale, SDWORD baseRadius);
 void destroyFXDroid(DROID *psDroid, unsigned impactTime);
 
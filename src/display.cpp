@@ -1266,6 +1266,36 @@ bool DrawnInLastFrame(int32_t frame)
 	return frame >= (int32_t)StartOfLastFrame;
 }
 
+/// Finds the droid whose screen box contains the mouse, nearest to the mouse if the boxes of several droids do.
+/// Only droids drawn in the last frame (or also in the current frame, if !onlyLastFrame) are found.
+static DROID *droidUnderMouse(bool onlyLastFrame)
+{
+	static std::vector<DROID *> candidates;
+	DROID *psBest = nullptr;
+	int bestDistSq = INT_MAX;
+
+	pickIndexDroidsAt(mouseX(), mouseY(), candidates);
+	for (DROID *psDroid : candidates)
+	{
+		const int dispX = psDroid->sDisplay.screenX;
+		const int dispY = psDroid->sDisplay.screenY;
+		const int dispR = psDroid->sDisplay.screenR;
+		const bool drawn = onlyLastFrame ? psDroid->sDisplay.frameNumber + 1 == currentFrame : DrawnInLastFrame(psDroid->sDisplay.frameNumber);
+		/* Only check droids that're on screen */
+		if (psDroid->died == 0 && drawn && psDroid->visible[selectedPlayer]
+		    && mouseInBox(dispX - dispR, dispY - dispR, dispX + dispR, dispY + dispR))
+		{
+			const int distSq = (mouseX() - dispX) * (mouseX() - dispX) + (mouseY() - dispY) * (mouseY() - dispY);
+			if (distSq < bestDistSq)
+			{
+				psBest = psDroid;
+				bestDistSq = distSq;
+			}
+		}
+	}
+	return psBest;
+}
+
 
 /*
 	Returns what the mouse was clicked on. Only called if there was a mouse pressed message
@@ -1275,36 +1305,18 @@ bool DrawnInLastFrame(int32_t frame)
 BASE_OBJECT *mouseTarget()
 {
 	BASE_OBJECT *psReturn = nullptr;
-	int dispX, dispY, dispR;
 
 	if (mouseTileX < 0 || mouseTileY < 0 || mouseTileX > mapWidth - 1 || mouseTileY > mapHeight - 1)
 	{
 		return (nullptr);
 	}
 
-	/* First have a look through the droid lists */
-	for (int i = 0; i < MAX_PLAYERS; i++)
+	/* First have a look at the droids drawn since the start of the last frame */
+	if (DROID *psDroid = droidUnderMouse(false))
 	{
-		/* Note the !psObject check isn't really necessary as the goto will jump out */
-		for (DROID *psDroid = apsDroidLists[i]; psDroid && !psReturn; psDroid = psDroid->psNext)
-		{
-			dispX = psDroid->sDisplay.screenX;
-			dispY = psDroid->sDisplay.screenY;
-			dispR = psDroid->sDisplay.screenR;
-
-			// Has the droid been drawn since the start of the last frame
-			if (psDroid->visible[selectedPlayer] && DrawnInLastFrame(psDroid->sDisplay.frameNumber))
-			{
-				if (mouseInBox(dispX - dispR, dispY - dispR, dispX + dispR, dispY + dispR))
-				{
-					/* We HAVE clicked on droid! */
-					psReturn = (BASE_OBJECT *) psDroid;
-					/* There's no point in checking other object types */
-					return psReturn;
-				}
-			}
-		}
-	} // end of checking for droids
+		/* We HAVE clicked on droid! There's no point in checking other object types */
+		return psDroid;
+	}
 
 	/*	Not a droid, so maybe a structure or feature?
 		If still NULL after this then nothing */
@@ -2266,11 +2278,9 @@ return code, but also a pointer to the BASE_OBJECT) ... well if your going to be
 */
 static MOUSE_TARGET	itemUnderMouse(BASE_OBJECT **ppObjectUnderMouse)
 {
-	UDWORD		i;
 	MOUSE_TARGET retVal;
 	BASE_OBJECT	 *psNotDroid;
 	DROID		*psDroid;
-	UDWORD		dispX, dispY, dispR;
 	STRUCTURE	*psStructure;
 
 	*ppObjectUnderMouse = nullptr;
@@ -2284,88 +2294,74 @@ static MOUSE_TARGET	itemUnderMouse(BASE_OBJECT **ppObjectUnderMouse)
 	/* We haven't found anything yet */
 	retVal = MT_NOTARGET;
 
-	/* First have a look through the droid lists */
-	for (i = 0; i < MAX_PLAYERS; i++)
+	/* First have a look at the droids drawn on screen */
+	psDroid = droidUnderMouse(true);
+	if (psDroid != nullptr)
 	{
-		/* Note the !psObject check isn't really necessary as the goto will jump out */
-		for (psDroid = apsDroidLists[i]; psDroid && retVal == MT_NOTARGET;
-		     psDroid = psDroid->psNext)
+		/* We HAVE clicked on droid! */
+		if (aiCheckAlliances(psDroid->player, selectedPlayer))
 		{
-			dispX = psDroid->sDisplay.screenX;
-			dispY = psDroid->sDisplay.screenY;
-			dispR = psDroid->sDisplay.screenR;
-			/* Only check droids that're on screen */
-			if (psDroid->sDisplay.frameNumber + 1 == currentFrame && psDroid->visible[selectedPlayer])
+			*ppObjectUnderMouse = (BASE_OBJECT *)psDroid;
+			// need to check for command droids here as well
+			if (psDroid->droidType == DROID_SENSOR)
 			{
-				if (mouseInBox(dispX - dispR, dispY - dispR, dispX + dispR, dispY + dispR))
+				if (selectedPlayer != psDroid->player)
 				{
-					/* We HAVE clicked on droid! */
-					if (aiCheckAlliances(psDroid->player, selectedPlayer))
-					{
-						*ppObjectUnderMouse = (BASE_OBJECT *)psDroid;
-						// need to check for command droids here as well
-						if (psDroid->droidType == DROID_SENSOR)
-						{
-							if (selectedPlayer != psDroid->player)
-							{
-								retVal = MT_CONSTRUCT; // Can't assign to allied units
-							}
-							else
-							{
-								retVal = MT_SENSOR;
-							}
-						}
-						else if (isTransporter(psDroid) &&
-						         selectedPlayer == psDroid->player)
-						{
-							//check the transporter is not full
-							if (calcRemainingCapacity(psDroid))
-							{
-								retVal = MT_TRANDROID;
-							}
-							else
-							{
-								retVal = MT_BLOCKING;
-							}
-						}
-						else if (psDroid->droidType == DROID_CONSTRUCT ||
-						         psDroid->droidType == DROID_CYBORG_CONSTRUCT)
-						{
-							return MT_CONSTRUCT;
-						}
-						else if (psDroid->droidType == DROID_COMMAND)
-						{
-							if (selectedPlayer != psDroid->player)
-							{
-								retVal = MT_CONSTRUCT; // Can't assign to allied units
-							}
-							else
-							{
-								retVal = MT_COMMAND;
-							}
-						}
-						else
-						{
-							if (droidIsDamaged(psDroid))
-							{
-								retVal = MT_OWNDROIDDAM;
-							}
-							else
-							{
-								retVal = MT_OWNDROID;
-							}
-						}
-					}
-					else
-					{
-						*ppObjectUnderMouse = (BASE_OBJECT *)psDroid;
-						retVal = MT_ENEMYDROID;
-					}
-					/* There's no point in checking other object types */
-					return (retVal);
+					retVal = MT_CONSTRUCT; // Can't assign to allied units
+				}
+				else
+				{
+					retVal = MT_SENSOR;
+				}
+			}
+			else if (isTransporter(psDroid) &&
+			         selectedPlayer == psDroid->player)
+			{
+				//check the transporter is not full
+				if (calcRemainingCapacity(psDroid))
+				{
+					retVal = MT_TRANDROID;
+				}
+				else
+				{
+					retVal = MT_BLOCKING;
 				}
 			}
+			else if (psDroid->droidType == DROID_CONSTRUCT ||
+			         psDroid->droidType == DROID_CYBORG_CONSTRUCT)
+			{
+				return MT_CONSTRUCT;
+			}
+			else if (psDroid->droidType == DROID_COMMAND)
+			{
+				if (selectedPlayer != psDroid->player)
+				{
+					retVal = MT_CONSTRUCT; // Can't assign to allied units
+				}
+				else
+				{
+					retVal = MT_COMMAND;
+				}
+			}
+			else
+			{
+				if (droidIsDamaged(psDroid))
+				{
+					retVal = MT_OWNDROIDDAM;
+				}
+				else
+				{
+					retVal = MT_OWNDROID;
+				}
+			}
+		}
+		else
+		{
+			*ppObjectUnderMouse = (BASE_OBJECT *)psDroid;
+			retVal = MT_ENEMYDROID;
 		}
+		/* There's no point in checking other object types */
+		return (retVal);
 	} // end of checking for droids
 
 	/*	Not a droid, so maybe a structure or feature?
@@ -51,6 +51,8 @@
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/matrix_interpolation.hpp>
 
+#include <algorithm>
+
 #include "loop.h"
 #include "atmos.h"
 #include "map.h"
@@ -101,6 +103,7 @@ static void	renderSurroundings(const glm::mat4 &viewMatrix);
 static void	locateMouse();
 static bool	renderWallSection(STRUCTURE *psStructure, const glm::mat4 &viewMatrix);
 static void	drawDragBox();
+static void	selectDroidsInDragBox();
 static void	calcFlagPosScreenCoords(SDWORD *pX, SDWORD *pY, SDWORD *pR, const glm::mat4 &modelViewMatrix);
 static void	drawTiles(iView *player);
 static void	display3DProjectiles(const glm::mat4 &viewMatrix);
@@ -142,6 +145,7 @@ static WzText txtShowSamples_Act;
 static WzText txtShowOrders;
 // show Droid visible/draw counts text
 static WzText droidText;
+static WzText txtShowPerf[PERF_COUNT + 1];
 
 
 /********************  Variables  ********************/
@@ -243,6 +247,10 @@ bool showSAMPLES = false;
  *  default OFF, turn ON via console command 'showorders'
  */
 bool showORDERS = false;
+/**  Show the CPU and GPU times of the recent frames
+ *  default OFF, turn ON via console command 'showperf'
+ */
+bool showPERF = false;
 /**  Show the drawn/undrawn counts for droids
   * default OFF, turn ON by flipping it here
   */
@@ -803,6 +811,12 @@ void draw3DScene()
 	/* Now, draw the terrain */
 	drawTiles(&playerPos);
 
+	/* Select the droids in the drag box, now that we know where they were drawn */
+	if (dragBox3D.status == DRAG_RELEASED)
+	{
+		selectDroidsInDragBox();
+	}
+
 	wzPerfBegin(PERF_MISC, "3D scene - misc and text");
 
 	/* Show the drag Box if necessary */
@@ -898,6 +912,23 @@ void draw3DScene()
 		height = txtShowOrders.height();
 		txtShowOrders.render(0, pie_GetVideoBufferHeight() - height, WZCOL_TEXT_BRIGHT);
 	}
+	if (showPERF)
+	{
+		PERF_STATS stats;
+		wzPerfGetStats(stats);
+		txtShowPerf[0].setText(astringf("Frame: %.1f ms median, %.1f ms 99th percentile, over %u frames", stats.frameP50 / 1000.f, stats.frameP99 / 1000.f, (unsigned)stats.frames), font_regular);
+		for (int pp = 0; pp < PERF_COUNT; ++pp)
+		{
+			std::string gpu = stats.gpuFrames > 0 ? astringf("%.2f / %.2f ms", stats.gpuP50[pp] / 1000.f, stats.gpuP99[pp] / 1000.f) : std::string("n/a");
+			txtShowPerf[pp + 1].setText(astringf("%s: CPU %.2f / %.2f ms, GPU %s", wzPerfPointName((PERF_POINT)pp), stats.cpuP50[pp] / 1000.f, stats.cpuP99[pp] / 1000.f, gpu.c_str()), font_regular);
+		}
+		int y = 40;
+		for (auto &text : txtShowPerf)
+		{
+			y += text.lineSize();
+			text.render(10, y, WZCOL_TEXT_BRIGHT);
+		}
+	}
 	if (showDROIDcounts)
 	{
 		int visibleDroids = 0;
@@ -1174,8 +1205,10 @@ static void drawTiles(iView *player)
 
 	/* This is done here as effects can light the terrain - pause mode problems though */
 	wzPerfBegin(PERF_EFFECTS, "3D scene - effects");
+	clearLights();
 	processEffects(viewMatrix);
 	atmosUpdateSystem();
+	updateDirtyLighting();
 	avUpdateTiles();
 	wzPerfEnd(PERF_EFFECTS);
 
@@ -1297,6 +1330,10 @@ void shutdown3DView()
 	txtShowOrders = WzText();
 	// show Droid visible/draw counts text
 	droidText = WzText();
+	for (auto &text : txtShowPerf)
+	{
+		text = WzText();
+	}
 }
 
 /// set the view position from save game
@@ -3381,10 +3418,112 @@ void calcScreenCoords(DROID *psDroid, const glm::mat4 &viewMatrix)
 		radius = 1; // 1 just in case some other code assumes radius != 0
 	}
 
-	/* Deselect all the droids if we've released the drag box */
-	if (dragBox3D.status == DRAG_RELEASED)
+	/* Store away the screen coordinates so we can select the droids without doing a transform */
+	psDroid->sDisplay.screenX = center.x;
+	psDroid->sDisplay.screenY = center.y;
+	psDroid->sDisplay.screenR = radius;
+}
+
+#define PICK_INDEX_BIN_SIZE 64  ///< Size of the screen areas droids are sorted into, in pixels
+
+/// Droids drawn in a frame, sorted into PICK_INDEX_BIN_SIZE² areas of the screen by their screen boxes,
+/// so finding the droid under the mouse doesn't need to look at every droid of every player.
+struct PickIndex
+{
+	UDWORD frame = 0;
+	int binsX = 0, binsY = 0;
+	std::vector<std::vector<DROID *>> bins;
+};
+static PickIndex pickIndex[2];  // Indexed by frame number parity, so the last frame is kept while drawing the next
+
+void pickIndexAddDroid(DROID *psDroid)
+{
+	PickIndex &index = pickIndex[psDroid->sDisplay.frameNumber & 1];
+	if (index.frame != psDroid->sDisplay.frameNumber)
+	{
+		// First droid drawn in this frame, forget the frame before the last one.
+		index.frame = psDroid->sDisplay.frameNumber;
+		index.binsX = (pie_GetVideoBufferWidth() + PICK_INDEX_BIN_SIZE - 1) / PICK_INDEX_BIN_SIZE;
+		index.binsY = (pie_GetVideoBufferHeight() + PICK_INDEX_BIN_SIZE - 1) / PICK_INDEX_BIN_SIZE;
+		index.bins.resize(index.binsX * index.binsY);
+		for (auto &bin : index.bins)
+		{
+			bin.clear();
+		}
+	}
+
+	const int x = psDroid->sDisplay.screenX, y = psDroid->sDisplay.screenY, r = psDroid->sDisplay.screenR;
+	const int x0 = std::max((x - r) / PICK_INDEX_BIN_SIZE, 0), x1 = std::min((x + r) / PICK_INDEX_BIN_SIZE, index.binsX - 1);
+	const int y0 = std::max((y - r) / PICK_INDEX_BIN_SIZE, 0), y1 = std::min((y + r) / PICK_INDEX_BIN_SIZE, index.binsY - 1);
+	for (int binY = y0; binY <= y1; ++binY)
+	{
+		for (int binX = x0; binX <= x1; ++binX)
+		{
+			index.bins[binY * index.binsX + binX].push_back(psDroid);
+		}
+	}
+}
+
+void pickIndexRemoveDroid(DROID const *psDroid)
+{
+	for (auto &index : pickIndex)
+	{
+		for (auto &bin : index.bins)
+		{
+			bin.erase(std::remove(bin.begin(), bin.end(), psDroid), bin.end());
+		}
+	}
+}
+
+void pickIndexDroidsAt(int x, int y, std::vector<DROID *> &candidates)
+{
+	candidates.clear();
+	if (x < 0 || y < 0)
+	{
+		return;
+	}
+	for (auto const &index : pickIndex)
+	{
+		const int binX = x / PICK_INDEX_BIN_SIZE, binY = y / PICK_INDEX_BIN_SIZE;
+		if (binX < index.binsX && binY < index.binsY)
+		{
+			auto const &bin = index.bins[binY * index.binsX + binX];
+			candidates.insert(candidates.end(), bin.begin(), bin.end());
+		}
+	}
+}
+
+void pickIndexDroidsIn(int x0, int y0, int x1, int y1, std::vector<DROID *> &candidates)
+{
+	candidates.clear();
+	for (auto const &index : pickIndex)
 	{
-		if (inQuad(&center, &dragQuad) && psDroid->player == selectedPlayer)
+		const int binX0 = std::max(x0 / PICK_INDEX_BIN_SIZE, 0), binX1 = std::min(x1 / PICK_INDEX_BIN_SIZE, index.binsX - 1);
+		const int binY0 = std::max(y0 / PICK_INDEX_BIN_SIZE, 0), binY1 = std::min(y1 / PICK_INDEX_BIN_SIZE, index.binsY - 1);
+		for (int binY = binY0; binY <= binY1; ++binY)
+		{
+			for (int binX = binX0; binX <= binX1; ++binX)
+			{
+				auto const &bin = index.bins[binY * index.binsX + binX];
+				candidates.insert(candidates.end(), bin.begin(), bin.end());
+			}
+		}
+	}
+	// Droids that overlap several bins are in each of them.
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+/// Selects the droids of the selected player drawn inside the released drag box in this frame.
+static void selectDroidsInDragBox()
+{
+	static std::vector<DROID *> candidates;
+	pickIndexDroidsIn(std::min(dragBox3D.x1, dragBox3D.x2), std::min(dragBox3D.y1, dragBox3D.y2),
+	                  std::max(dragBox3D.x1, dragBox3D.x2), std::max(dragBox3D.y1, dragBox3D.y2), candidates);
+	for (DROID *psDroid : candidates)
+	{
+		const Vector2i center(psDroid->sDisplay.screenX, psDroid->sDisplay.screenY);
+		if (psDroid->sDisplay.frameNumber == currentGameFrame && psDroid->player == selectedPlayer && inQuad(&center, &dragQuad))
 		{
 			//don't allow Transporter Droids to be selected here
 			//unless we're in multiPlayer mode!!!!
@@ -3394,11 +3533,6 @@ void calcScreenCoords(DROID *psDroid, const glm::mat4 &viewMatrix)
 			}
 		}
 	}
-
-	/* Store away the screen coordinates so we can select the droids without doing a transform */
-	psDroid->sDisplay.screenX = center.x;
-	psDroid->sDisplay.screenY = center.y;
-	psDroid->sDisplay.screenR = radius;
 }
 
 /**
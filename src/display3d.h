@@ -28,6 +28,8 @@
 #include "objectdef.h"
 #include "message.h"
 
+#include <vector>
+
 #define HEIGHT_TRACK_INCREMENTS (50)
 
 /*!
@@ -59,6 +61,7 @@ extern bool showFPS;
 extern bool showUNITCOUNT;
 extern bool showSAMPLES;
 extern bool showORDERS;
+extern bool showPERF;
 
 extern int BlueprintTrackAnimationSpeed;
 
@@ -84,6 +87,17 @@ void renderProjectile(PROJECTILE *psCurr, const glm::mat4 &viewMatrix);
 void renderDeliveryPoint(FLAG_POSITION *psPosition, bool blueprint, const glm::mat4 &viewMatrix);
 
 void calcScreenCoords(DROID *psDroid, const glm::mat4 &viewMatrix);
+
+/// Remembers where on screen the droid was drawn, call after setting its sDisplay.frameNumber.
+void pickIndexAddDroid(DROID *psDroid);
+/// Forgets the droid, which is about to be deleted.
+void pickIndexRemoveDroid(DROID const *psDroid);
+/// Finds the droids drawn in the current or last frame whose screen boxes may contain the point.
+/// The caller must check the frame numbers and screen boxes of the candidates.
+void pickIndexDroidsAt(int x, int y, std::vector<DROID *> &candidates);
+/// Finds the droids drawn in the current or last frame whose screen boxes may overlap the rectangle, each only once.
+/// The caller must check the frame numbers and screen positions of the candidates.
+void pickIndexDroidsIn(int x0, int y0, int x1, int y1, std::vector<DROID *> &candidates);
 ENERGY_BAR toggleEnergyBars();
 void drawDroidSelection(DROID *psDroid, bool drawBox);
 
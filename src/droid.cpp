@@ -98,7 +98,7 @@ void cancelBuild(DROID *psDroid)
 	if (psDroid->order.type == DORDER_NONE || psDroid->order.type == DORDER_PATROL || psDroid->order.type == DORDER_HOLD || psDroid->order.type == DORDER_SCOUT || psDroid->order.type == DORDER_GUARD)
 	{
 		objTrace(psDroid->id, "Droid build action cancelled");
-		psDroid->order.psObj = nullptr;
+		setDroidTarget(psDroid, nullptr);
 		psDroid->action = DACTION_NONE;
 		setDroidActionTarget(psDroid, nullptr, 0);
 		return;  // Don't cancel orders.
@@ -112,7 +112,7 @@ void cancelBuild(DROID *psDroid)
 	{
 		objTrace(psDroid->id, "Droid build order cancelled");
 		psDroid->action = DACTION_NONE;
-		psDroid->order = DroidOrder(DORDER_NONE);
+		setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 		setDroidActionTarget(psDroid, nullptr, 0);
 
 		// The droid has no more build orders, so halt in place rather than clumping around the build objective
@@ -321,6 +321,7 @@ DROID::DROID(uint32_t id, unsigned player)
 	iAudioID = NO_SOUND;
 	group = UBYTE_MAX;
 	psBaseStruct = nullptr;
+	std::fill_n(psActionTarget, MAX_WEAPONS, nullptr);
 	sDisplay.frameNumber = 0;	// it was never drawn before
 	for (unsigned vPlayer = 0; vPlayer < MAX_PLAYERS; ++vPlayer)
 	{
@@ -346,10 +347,18 @@ DROID::~DROID()
 	// Make sure to get rid of some final references in the sound code to this object first
 	// In BASE_OBJECT::~BASE_OBJECT() is too late for this, since some callbacks require us to still be a DROID.
 	audio_RemoveObj(this);
+	pickIndexRemoveDroid(this);
 
 	DROID *psDroid = this;
 	DROID	*psCurr, *pNextGroupDroid = nullptr;
 
+	setDroidTarget(psDroid, nullptr);
+	setDroidBase(psDroid, nullptr);
+	for (unsigned i = 0; i < MAX_WEAPONS; ++i)
+	{
+		setDroidActionTarget(psDroid, nullptr, i);
+	}
+
 	if (isTransporter(psDroid))
 	{
 		if (psDroid->psGroup)
@@ -1631,7 +1640,7 @@ void droidSetBits(const DROID_TEMPLATE *pTemplate, DROID *psDroid)
 	//create the droids weapons
 	for (int inc = 0; inc < MAX_WEAPONS; inc++)
 	{
-		psDroid->psActionTarget[inc] = nullptr;
+		setDroidActionTarget(psDroid, nullptr, inc);
 		psDroid->asWeaps[inc].lastFired = 0;
 		psDroid->asWeaps[inc].shotsFired = 0;
 		// no weapon (could be a construction droid for example)
@@ -2292,18 +2301,16 @@ PICKTILE pickHalfATile(UDWORD *x, UDWORD *y, UBYTE numIterations)
 	return pickATileGen(x, y, numIterations, canFitDroid) ? FREE_TILE : NO_FREE_TILE;
 }
 
-/* Looks through the players list of droids to see if any of them are
-building the specified structure - returns true if finds one*/
-bool checkDroidsBuilding(STRUCTURE *psStructure)
+/// Looks through the droids referring to the structure, to see if any droid of the owner is in the given order state on it.
+static bool checkDroidsOrderStateObj(STRUCTURE *psStructure, DROID_ORDER order)
 {
-	DROID				*psDroid;
-
-	for (psDroid = apsDroidLists[psStructure->player]; psDroid != nullptr; psDroid =
-	         psDroid->psNext)
+	for (BASE_OBJECT *psReferrer : psStructure->psReferrers)
 	{
-		//check DORDER_BUILD, HELP_BUILD is handled the same
-		BASE_OBJECT *const psStruct = orderStateObj(psDroid, DORDER_BUILD);
-		if ((STRUCTURE *)psStruct == psStructure)
+		if (psReferrer->type != OBJ_DROID || psReferrer->player != psStructure->player || psReferrer->died != 0)
+		{
+			continue;
+		}
+		if (orderStateObj((DROID *)psReferrer, order) == psStructure)
 		{
 			return true;
 		}
@@ -2311,23 +2318,20 @@ bool checkDroidsBuilding(STRUCTURE *psStructure)
 	return false;
 }
 
-/* Looks through the players list of droids to see if any of them are
-demolishing the specified structure - returns true if finds one*/
-bool checkDroidsDemolishing(STRUCTURE *psStructure)
+/* Looks through the droids of the player that refer to the specified structure, to see if any
+of them are building it - returns true if finds one*/
+bool checkDroidsBuilding(STRUCTURE *psStructure)
 {
-	DROID				*psDroid;
+	//check DORDER_BUILD, HELP_BUILD is handled the same
+	return checkDroidsOrderStateObj(psStructure, DORDER_BUILD);
+}
 
-	for (psDroid = apsDroidLists[psStructure->player]; psDroid != nullptr; psDroid =
-	         psDroid->psNext)
-	{
-		//check DORDER_DEMOLISH
-		BASE_OBJECT *const psStruct = orderStateObj(psDroid, DORDER_DEMOLISH);
-		if ((STRUCTURE *)psStruct == psStructure)
-		{
-			return true;
-		}
-	}
-	return false;
+/* Looks through the droids of the player that refer to the specified structure, to see if any
+of them are demolishing it - returns true if finds one*/
+bool checkDroidsDemolishing(STRUCTURE *psStructure)
+{
+	//check DORDER_DEMOLISH
+	return checkDroidsOrderStateObj(psStructure, DORDER_DEMOLISH);
 }
 
 
@@ -3070,16 +3074,13 @@ DROID *giftSingleDroid(DROID *psD, UDWORD to, bool electronic)
 		}
 	}
 
-	for (unsigned int i = 0; i < MAX_PLAYERS; ++i)
+	// check through the structures of the player, and our allies, that are targetting it
+	std::vector<BASE_OBJECT *> referrers = psD->psReferrers;  // Copy, since clearing the targets changes the list.
+	for (BASE_OBJECT *psReferrer : referrers)
 	{
-		if (!aiCheckAlliances(i, to))
-		{
-			continue;
-		}
-
-		// check through the players list, and our allies, of structures to see if any are targetting it
-		for (STRUCTURE *psStruct = apsStructLists[i]; psStruct != nullptr; psStruct = psStruct->psNext)
+		if (psReferrer->type == OBJ_STRUCTURE && aiCheckAlliances(psReferrer->player, to))
 		{
+			STRUCTURE *psStruct = (STRUCTURE *)psReferrer;
 			if (psStruct->psTarget[0] == psD)
 			{
 				setStructureTarget(psStruct, nullptr, 0, ORIGIN_UNKNOWN);
@@ -201,10 +201,10 @@ bool pickATileGenThreat(UDWORD *x, UDWORD *y, UBYTE numIterations, SDWORD threat
 //initialises the droid movement model
 void initDroidMovement(DROID *psDroid);
 
-/// Looks through the players list of droids to see if any of them are building the specified structure - returns true if finds one
+/// Looks through the droids of the player that refer to the specified structure, to see if any of them are building it - returns true if finds one
 bool checkDroidsBuilding(STRUCTURE *psStructure);
 
-/// Looks through the players list of droids to see if any of them are demolishing the specified structure - returns true if finds one
+/// Looks through the droids of the player that refer to the specified structure, to see if any of them are demolishing it - returns true if finds one
 bool checkDroidsDemolishing(STRUCTURE *psStructure);
 
 /// Returns the next module which can be built after lastOrderedModule, or returns 0 if not possible.
@@ -362,11 +362,19 @@ static inline Rotation getInterpolatedWeaponRotation(const DROID *psDroid, int w
 	return interpolateRot(psDroid->asWeaps[weaponSlot].prevRot, psDroid->asWeaps[weaponSlot].rot, psDroid->prevSpacetime.time, psDroid->time, time);
 }
 
-/** helper functions for future refcount patch **/
+/** helper functions that keep track of references between objects, see objChangeReference() **/
+
+/// Replaces the droid's order, psObj included.
+static inline void setDroidOrder(DROID *psDroid, DroidOrder const &order)
+{
+	objChangeReference(psDroid, psDroid->order.psObj, order.psObj);
+	psDroid->order = order;
+}
 
 #define setDroidTarget(_psDroid, _psNewTarget) _setDroidTarget(_psDroid, _psNewTarget, __LINE__, __FUNCTION__)
 static inline void _setDroidTarget(DROID *psDroid, BASE_OBJECT *psNewTarget, int line, const char *func)
 {
+	objChangeReference(psDroid, psDroid->order.psObj, psNewTarget);
 	psDroid->order.psObj = psNewTarget;
 	ASSERT(psNewTarget == nullptr || !psNewTarget->died, "setDroidTarget: Set dead target");
 	ASSERT(psNewTarget == nullptr || !psNewTarget->died || (psNewTarget->died == NOT_CURRENT_LIST && psDroid->died == NOT_CURRENT_LIST),
@@ -384,6 +392,7 @@ static inline void _setDroidTarget(DROID *psDroid, BASE_OBJECT *psNewTarget, int
 #define setDroidActionTarget(_psDroid, _psNewTarget, _idx) _setDroidActionTarget(_psDroid, _psNewTarget, _idx, __LINE__, __FUNCTION__)
 static inline void _setDroidActionTarget(DROID *psDroid, BASE_OBJECT *psNewTarget, UWORD idx, int line, const char *func)
 {
+	objChangeReference(psDroid, psDroid->psActionTarget[idx], psNewTarget);
 	psDroid->psActionTarget[idx] = psNewTarget;
 	ASSERT(psNewTarget == nullptr || !psNewTarget->died || (psNewTarget->died == NOT_CURRENT_LIST && psDroid->died == NOT_CURRENT_LIST),
 	       "setDroidActionTarget: Set dead target");
@@ -400,6 +409,7 @@ static inline void _setDroidActionTarget(DROID *psDroid, BASE_OBJECT *psNewTarge
 #define setDroidBase(_psDroid, _psNewTarget) _setDroidBase(_psDroid, _psNewTarget, __LINE__, __FUNCTION__)
 static inline void _setDroidBase(DROID *psDroid, STRUCTURE *psNewBase, int line, const char *func)
 {
+	objChangeReference(psDroid, psDroid->psBaseStruct, psNewBase);
 	psDroid->psBaseStruct = psNewBase;
 	ASSERT(psNewBase == nullptr || !psNewBase->died, "setDroidBase: Set dead target");
 #ifdef DEBUG
@@ -414,6 +424,7 @@ static inline void _setDroidBase(DROID *psDroid, STRUCTURE *psNewBase, int line,
 
 static inline void setSaveDroidTarget(DROID *psSaveDroid, BASE_OBJECT *psNewTarget)
 {
+	objChangeReference(psSaveDroid, psSaveDroid->order.psObj, psNewTarget);
 	psSaveDroid->order.psObj = psNewTarget;
 #ifdef DEBUG
 	psSaveDroid->targetLine = 0;
@@ -423,6 +434,7 @@ static inline void setSaveDroidTarget(DROID *psSaveDroid, BASE_OBJECT *psNewTarg
 
 static inline void setSaveDroidActionTarget(DROID *psSaveDroid, BASE_OBJECT *psNewTarget, UWORD idx)
 {
+	objChangeReference(psSaveDroid, psSaveDroid->psActionTarget[idx], psNewTarget);
 	psSaveDroid->psActionTarget[idx] = psNewTarget;
 #ifdef DEBUG
 	psSaveDroid->actionTargetLine[idx] = 0;
@@ -432,6 +444,7 @@ static inline void setSaveDroidActionTarget(DROID *psSaveDroid, BASE_OBJECT *psN
 
 static inline void setSaveDroidBase(DROID *psSaveDroid, STRUCTURE *psNewBase)
 {
+	objChangeReference(psSaveDroid, psSaveDroid->psBaseStruct, psNewBase);
 	psSaveDroid->psBaseStruct = psNewBase;
 #ifdef DEBUG
 	psSaveDroid->baseLine = 0;
@@ -87,6 +87,7 @@
 #include "lib/ivis_opengl/screen.h"
 #include "keymap.h"
 #include <ctime>
+#include <unordered_map>
 #include "multimenu.h"
 #include "console.h"
 #include "wzscriptdebug.h"
@@ -1673,6 +1674,80 @@ static char *getSaveStructNameV19(SAVE_STRUCTURE_V17 *psSaveStructure)
 	return (psSaveStructure->name);
 }
 
+/* The object files of a savegame are parsed on worker threads while loadGame() is busy with
+ * the map and templates. Droid and structure files are read twice (objects, then pointers),
+ * so their parsed documents are kept until the pointer pass has consumed them. */
+struct PrefetchedSaveFile
+{
+	WzString fileName;
+	nlohmann::json document;
+	WZ_THREAD *thread = nullptr;
+};
+static std::map<WzString, std::unique_ptr<PrefetchedSaveFile>> prefetchedSaveFiles;
+
+static int prefetchSaveFileThreadFunc(void *data)
+{
+	PrefetchedSaveFile *psPrefetch = (PrefetchedSaveFile *)data;
+	psPrefetch->document = WzConfig::parseDocument(psPrefetch->fileName);
+	return 0;
+}
+
+static void clearPrefetchedSaveFiles()
+{
+	for (auto &it : prefetchedSaveFiles)
+	{
+		if (it.second->thread != nullptr)
+		{
+			wzThreadJoin(it.second->thread);
+		}
+	}
+	prefetchedSaveFiles.clear();
+}
+
+static void prefetchSaveFiles(const char *pSaveDir)
+{
+	static const char *const objectFiles[] = {"droid.json", "mdroid.json", "limbo.json", "struct.json", "mstruct.json", "feature.json", "mfeature.json"};
+
+	clearPrefetchedSaveFiles();
+	for (const char *objectFile : objectFiles)
+	{
+		WzString fileName = WzString::fromUtf8(pSaveDir) + objectFile;
+		if (!PHYSFS_exists(fileName.toUtf8().c_str()))
+		{
+			continue;
+		}
+		std::unique_ptr<PrefetchedSaveFile> psPrefetch(new PrefetchedSaveFile);
+		psPrefetch->fileName = fileName;
+		psPrefetch->thread = wzThreadCreate(prefetchSaveFileThreadFunc, psPrefetch.get());
+		wzThreadStart(psPrefetch->thread);
+		prefetchedSaveFiles[fileName] = std::move(psPrefetch);
+	}
+}
+
+/// Returns the prefetched document for fileName, or a null value if it wasn't prefetched.
+/// If release is true, the document is handed over instead of copied, since it won't be needed again.
+static nlohmann::json takePrefetchedSaveFile(const WzString &fileName, bool release)
+{
+	auto it = prefetchedSaveFiles.find(fileName);
+	if (it == prefetchedSaveFiles.end())
+	{
+		return nlohmann::json();
+	}
+	PrefetchedSaveFile &prefetch = *it->second;
+	if (prefetch.thread != nullptr)
+	{
+		wzThreadJoin(prefetch.thread);
+		prefetch.thread = nullptr;
+	}
+	if (!release)
+	{
+		return prefetch.document;
+	}
+	nlohmann::json document = std::move(prefetch.document);
+	prefetchedSaveFiles.erase(it);
+	return document;
+}
+
 /*This just loads up the .gam file to determine which level data to set up - split up
 so can be called in levLoadData when starting a game from a load save game*/
 
@@ -2067,6 +2142,9 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 	aFileName[fileExten - 1] = '\0';
 	strcat(aFileName, "/");
 
+	// Start parsing the object files now, they are needed once the map is loaded
+	prefetchSaveFiles(aFileName);
+
 	//the terrain type WILL only change with Campaign changes (well at the moment!)
 	if (gameType != GTYPE_SCENARIO_EXPAND || UserSaveGame)
 	{
@@ -2133,6 +2211,7 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 		if (!mapLoad(aFileName, false))
 		{
 			debug(LOG_ERROR, "Failed with: %s", aFileName);
+			clearPrefetchedSaveFiles();
 			return false;
 		}
 
@@ -2263,6 +2342,7 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 		if (haveScript? !mapLoadFromScriptData(data, false) : !mapLoad(aFileName, false))
 		{
 			debug(LOG_ERROR, "Failed with: %s", aFileName);
+			clearPrefetchedSaveFiles();
 			return false;
 		}
 	}
@@ -2570,6 +2650,8 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 
 	if (!keepObjects)//only reset the pointers if they were set
 	{
+		// No objects are created or destroyed while resolving pointers, so look them up by id
+		objmemBuildIdIndex();
 		// Reset the object pointers in the droid target lists
 		for (auto it = droidMap.begin(); it != droidMap.end(); ++it)
 		{
@@ -2583,7 +2665,9 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 			STRUCTURE **pList = it->second;
 			loadSaveStructurePointers(key, pList);
 		}
+		objmemClearIdIndex();
 	}
+	clearPrefetchedSaveFiles();
 
 	// Load labels
 	aFileName[fileExten] = '\0';
@@ -2658,6 +2742,7 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 error:
 	debug(LOG_ERROR, "Game load failed for %s, FS:%s, params=%s,%s,%s", pGameToLoad, WZ_PHYSFS_getRealDir_String(pGameToLoad).c_str(),
 	      keepObjects ? "true" : "false", freeMem ? "true" : "false", UserSaveGame ? "true" : "false");
+	clearPrefetchedSaveFiles();
 
 	/* Clear all the objects off the map and free up the map memory */
 	freeAllDroids();
@@ -4398,9 +4483,26 @@ static bool skipForDifficulty(WzConfig &ini, int player)
 
 static bool loadSaveDroidPointers(const WzString &pFileName, DROID **ppsCurrentDroidLists)
 {
-	WzConfig ini(pFileName, WzConfig::ReadOnly);
+	WzConfig ini(pFileName, takePrefetchedSaveFile(pFileName, true), WzConfig::ReadOnly);
 	std::vector<WzString> list = ini.childGroups();
 
+	// Look the saved droids up by id, rather than walking the list for each of them
+	std::unordered_map<UDWORD, DROID *> droidsById;
+	for (int player = 0; player < MAX_PLAYERS; ++player)
+	{
+		for (DROID *psDroid = ppsCurrentDroidLists[player]; psDroid != nullptr; psDroid = psDroid->psNext)
+		{
+			droidsById.emplace(psDroid->id, psDroid);
+			if (isTransporter(psDroid) && psDroid->psGroup != nullptr)  // Check for droids in the transporter.
+			{
+				for (DROID *psTrDroid = psDroid->psGroup->psList; psTrDroid != nullptr; psTrDroid = psTrDroid->psGrpNext)
+				{
+					droidsById.emplace(psTrDroid->id, psTrDroid);
+				}
+			}
+		}
+	}
+
 	for (size_t i = 0; i < list.size(); ++i)
 	{
 		ini.beginGroup(list[i]);
@@ -4419,21 +4521,8 @@ static bool loadSaveDroidPointers(const WzString &pFileName, DROID **ppsCurrentD
 			continue; // another hack for campaign missions, cannot have targets
 		}
 
-		for (psDroid = ppsCurrentDroidLists[player]; psDroid && psDroid->id != id; psDroid = psDroid->psNext)
-		{
-			if (isTransporter(psDroid) && psDroid->psGroup != nullptr)  // Check for droids in the transporter.
-			{
-				for (DROID *psTrDroid = psDroid->psGroup->psList; psTrDroid != nullptr; psTrDroid = psTrDroid->psGrpNext)
-				{
-					if (psTrDroid->id == id)
-					{
-						psDroid = psTrDroid;
-						goto foundDroid;
-					}
-				}
-			}
-		}
-foundDroid:
+		auto droidIt = droidsById.find(id);
+		psDroid = droidIt != droidsById.end() && droidIt->second->player == player ? droidIt->second : nullptr;
 		if (!psDroid)
 		{
 			for (psDroid = mission.apsDroidLists[player]; psDroid && psDroid->id != id; psDroid = psDroid->psNext) {}
@@ -4445,7 +4534,9 @@ foundDroid:
 		}
 		ASSERT_OR_RETURN(false, psDroid, "Droid %d not found", id);
 
-		getIniDroidOrder(ini, "order", psDroid->order);
+		DroidOrder order;
+		getIniDroidOrder(ini, "order", order);
+		setDroidOrder(psDroid, order);
 		psDroid->listSize = clip(ini.value("orderList/size", 0).toInt(), 0, 10000);
 		psDroid->asOrderList.resize(psDroid->listSize);  // Must resize before setting any orders, and must set in-place, since pointers are updated later.
 		for (int droidIdx = 0; droidIdx < psDroid->listSize; ++droidIdx)
@@ -4652,7 +4743,7 @@ static bool loadSaveDroid(const char *pFileName, DROID **ppsCurrentDroidLists)
 		return false;	// try to use fallback method
 	}
 	WzString fName = WzString::fromUtf8(pFileName);
-	WzConfig ini(fName, WzConfig::ReadOnly);
+	WzConfig ini(fName, takePrefetchedSaveFile(fName, false), WzConfig::ReadOnly);
 	std::vector<WzString> list = ini.childGroups();
 	// Sort list so transports are loaded first, since they must be loaded before the droids they contain.
 	std::vector<std::pair<int, WzString>> sortedList;
@@ -5291,7 +5382,8 @@ static bool loadSaveStructure2(const char *pFileName, STRUCTURE **ppList)
 		debug(LOG_SAVE, "No %s found -- use fallback method", pFileName);
 		return false;	// try to use fallback method
 	}
-	WzConfig ini(WzString::fromUtf8(pFileName), WzConfig::ReadOnly);
+	WzString fName = WzString::fromUtf8(pFileName);
+	WzConfig ini(fName, takePrefetchedSaveFile(fName, false), WzConfig::ReadOnly);
 
 	freeAllFlagPositions();		//clear any flags put in during level loads
 
@@ -5725,16 +5817,27 @@ bool writeStructFile(const char *pFileName)
 // -----------------------------------------------------------------------------------------
 bool loadSaveStructurePointers(const WzString& filename, STRUCTURE **ppList)
 {
-	WzConfig ini(filename, WzConfig::ReadOnly);
+	WzConfig ini(filename, takePrefetchedSaveFile(filename, true), WzConfig::ReadOnly);
 	std::vector<WzString> list = ini.childGroups();
 
+	// Look the saved structures up by id, rather than walking the list for each of them
+	std::unordered_map<UDWORD, STRUCTURE *> structuresById;
+	for (int player = 0; player < MAX_PLAYERS; ++player)
+	{
+		for (STRUCTURE *psStruct = ppList[player]; psStruct != nullptr; psStruct = psStruct->psNext)
+		{
+			structuresById.emplace(psStruct->id, psStruct);
+		}
+	}
+
 	for (size_t i = 0; i < list.size(); ++i)
 	{
 		ini.beginGroup(list[i]);
 		STRUCTURE *psStruct;
 		int player = getPlayer(ini);
 		int id = ini.value("id", -1).toInt();
-		for (psStruct = ppList[player]; psStruct && psStruct->id != id; psStruct = psStruct->psNext) { }
+		auto structIt = structuresById.find(id);
+		psStruct = structIt != structuresById.end() && structIt->second->player == player ? structIt->second : nullptr;
 		if (!psStruct)
 		{
 			ini.endGroup();
@@ -5954,7 +6057,8 @@ bool loadSaveFeature2(const char *pFileName)
 		debug(LOG_SAVE, "No %s found -- use fallback method", pFileName);
 		return false;
 	}
-	WzConfig ini(pFileName, WzConfig::ReadOnly);
+	WzString fName = WzString::fromUtf8(pFileName);
+	WzConfig ini(fName, takePrefetchedSaveFile(fName, true), WzConfig::ReadOnly);
 	std::vector<WzString> list = ini.childGroups();
 	debug(LOG_SAVE, "Loading new style features (%zu found)", list.size());
 
@@ -31,6 +31,7 @@
 #include "lib/framework/file.h"
 #include "lib/framework/physfs_ext.h"
 #include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
 #include "lib/ivis_opengl/piemode.h"
 #include "lib/ivis_opengl/piestate.h"
 #include "lib/ivis_opengl/screen.h"
@@ -92,6 +93,7 @@
 #include "qtscript.h"
 #include "template.h"
 #include "activity.h"
+#include "snapshot.h"
 
 #include <algorithm>
 #include <unordered_map>
@@ -325,7 +327,7 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 				// make sure videos override included files
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "sequences.wz");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 				curSearchPath = curSearchPath->higherPriority;
 			}
 			curSearchPath = searchPathRegistry;
@@ -339,7 +341,7 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 				debug(LOG_WZ, "Adding [%s] to search path", curSearchPath->path);
 #endif // DEBUG
 				// Add global and campaign mods
-				PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
 
 				addSubdirs(curSearchPath->path, "mods/music", PHYSFS_APPEND, nullptr, false);
 				addSubdirs(curSearchPath->path, "mods/global", PHYSFS_APPEND, use_override_mods ? &override_mods : &global_mods, true);
@@ -352,15 +354,15 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 				}
 
 				// Add plain dir
-				PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
 
 				// Add base files
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "base");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "base.wz");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 
 				curSearchPath = curSearchPath->higherPriority;
 			}
@@ -374,7 +376,7 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 				// make sure videos override included files
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "sequences.wz");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 				curSearchPath = curSearchPath->higherPriority;
 			}
 			// Add the selected map first, for mapmod support
@@ -382,7 +384,7 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 			{
 				WzString realPathAndDir = WzString::fromUtf8(PHYSFS_getRealDir(current_map)) + current_map;
 				realPathAndDir.replace("/", PHYSFS_getDirSeparator()); // Windows fix
-				PHYSFS_mount(realPathAndDir.toUtf8().c_str(), NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(realPathAndDir.toUtf8().c_str(), NULL, PHYSFS_APPEND);
 			}
 			curSearchPath = searchPathRegistry;
 			while (curSearchPath->lowerPriority)
@@ -395,7 +397,7 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 				debug(LOG_WZ, "Adding [%s] to search path", curSearchPath->path);
 #endif // DEBUG
 				// Add global and multiplay mods
-				PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
 				addSubdirs(curSearchPath->path, "mods/music", PHYSFS_APPEND, nullptr, false);
 
 				// Only load if we are host or singleplayer (Initial mod load relies on this, too)
@@ -420,21 +422,21 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 				// Add multiplay patches
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "mp");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "mp.wz");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 
 				// Add plain dir
-				PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(curSearchPath->path, NULL, PHYSFS_APPEND);
 
 				// Add base files
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "base");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 				sstrcpy(tmpstr, curSearchPath->path);
 				sstrcat(tmpstr, "base.wz");
-				PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
+				WZ_PHYSFS_mount(tmpstr, NULL, PHYSFS_APPEND);
 
 				curSearchPath = curSearchPath->higherPriority;
 			}
@@ -455,7 +457,7 @@ bool rebuildSearchPath(searchPathMode mode, bool force, const char *current_map)
 
 		// User's home dir must be first so we always see what we write
 		WZ_PHYSFS_unmount(PHYSFS_getWriteDir());
-		PHYSFS_mount(PHYSFS_getWriteDir(), NULL, PHYSFS_PREPEND);
+		WZ_PHYSFS_mount(PHYSFS_getWriteDir(), NULL, PHYSFS_PREPEND);
 
 #ifdef DEBUG
 		printSearchPath();
@@ -512,7 +514,7 @@ static MapFileList listMapFiles()
 	for (const auto &realFileName : ret)
 	{
 		std::string realFilePathAndName = PHYSFS_getWriteDir() + realFileName.platformDependent;
-		if (PHYSFS_mount(realFilePathAndName.c_str(), NULL, PHYSFS_APPEND))
+		if (WZ_PHYSFS_mount(realFilePathAndName.c_str(), NULL, PHYSFS_APPEND))
 		{
 			int unsafe = 0;
 			WZ_PHYSFS_enumerateFiles("multiplay/maps", [&unsafe, &realFilePathAndName](const char *file) -> bool {
@@ -548,7 +550,7 @@ static MapFileList listMapFiles()
 	// restore our search path(s) again
 	for (const auto &restorePaths : oldSearchPath)
 	{
-		PHYSFS_mount(restorePaths.c_str(), NULL, PHYSFS_APPEND);
+		WZ_PHYSFS_mount(restorePaths.c_str(), NULL, PHYSFS_APPEND);
 	}
 	debug(LOG_WZ, "Search paths restored");
 	printSearchPath();
@@ -615,7 +617,7 @@ static std::pair<bool, bool> CheckInMap(const char *archive, const char *mountpo
 	bool mapmod = false;
 	bool isRandom = false;
 
-	if (!PHYSFS_mount(archive, mountpoint, PHYSFS_APPEND))
+	if (!WZ_PHYSFS_mount(archive, mountpoint, PHYSFS_APPEND))
 	{
 		// We already checked to see if this was valid before, and now, something went seriously wrong.
 		debug(LOG_FATAL, "Could not mount %s, because: %s. Please delete the file, and run the game again. Game will now exit.", archive, WZ_PHYSFS_getLastError());
@@ -684,7 +686,7 @@ bool buildMapList()
 		}
 		std::string realFilePathAndName = pRealDirStr + realFileName.platformDependent;
 
-		PHYSFS_mount(realFilePathAndName.c_str(), NULL, PHYSFS_APPEND);
+		WZ_PHYSFS_mount(realFilePathAndName.c_str(), NULL, PHYSFS_APPEND);
 
 		WZ_PHYSFS_enumerateFiles("", [&](const char *file) -> bool {
 			size_t len = strlen(file);
@@ -741,11 +743,13 @@ bool systemInitialise(float horizScaleFactor, float vertScaleFactor)
 		return false;
 	}
 
-	if (!audio_Init(droidAudioTrackStopped, war_GetHRTFMode(), war_getSoundEnabled()))
+	// Nobody listens to games running as fast as possible
+	const bool soundEnabled = war_getSoundEnabled() && !gameTimeIsUncapped();
+	if (!audio_Init(droidAudioTrackStopped, war_GetHRTFMode(), soundEnabled))
 	{
 		debug(LOG_SOUND, "Continuing without audio");
 	}
-	if (war_getSoundEnabled() && war_GetMusicEnabled())
+	if (soundEnabled && war_GetMusicEnabled())
 	{
 		cdAudio_Open(UserMusicPath);
 	}
@@ -815,6 +819,7 @@ void systemShutdown()
 	mapShutdown();
 	debug(LOG_MAIN, "shutting down everything else");
 	pal_ShutDown();		// currently unused stub
+	snapshotShutdown();
 	frameShutDown();	// close screen / SDL / resources / cursors / trig
 	screenShutDown();
 	gfx_api::context::get().shutdown();
@@ -1370,6 +1375,8 @@ bool stageThreeShutDown()
 
 	shutdownTemplates();
 
+	clearWorldSnapshots();
+
 	// make sure any button tips are gone.
 	widgReset();
 
@@ -631,6 +631,12 @@ void kf_ToggleOrders()	// Displays orders & action of currently selected unit.
 	CONPRINTF("Unit Order/Action displayed is %s", showORDERS ? "Enabled" : "Disabled");
 }
 
+void kf_TogglePerfStats()	// Displays CPU and GPU times of the recent frames.
+{
+	showPERF = !showPERF;
+	CONPRINTF("Frame time statistics displayed is %s", showPERF ? "Enabled" : "Disabled");
+}
+
 /* Writes out the frame rate */
 void	kf_FrameRate()
 {
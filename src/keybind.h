@@ -42,6 +42,7 @@ void kf_ToggleFPS();			//FPS counter NOT same as kf_Framerate! -Q
 void kf_ToggleUnitCount();		// Display units built / lost / produced counter
 void kf_ToggleSamples();		// Displays # of sound samples in Queue/list.
 void kf_ToggleOrders();		//displays unit's Order/action state.
+void kf_TogglePerfStats();		// Displays CPU and GPU times of the recent frames.
 void kf_FrameRate();
 void kf_ShowNumObjects();
 void kf_ToggleRadar();
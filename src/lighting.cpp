@@ -32,6 +32,7 @@
 #include "lib/ivis_opengl/pienormalize.h"
 #include "lib/ivis_opengl/piepalette.h"
 #include "lib/framework/fixedpoint.h"
+#include "lib/framework/wzapp.h"
 
 #include "lib/gamelib/gtime.h"
 
@@ -40,6 +41,15 @@
 #include "display3d.h"
 #include "terrain.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#define LIGHTING_THREADS 4                ///< Maximum number of threads recalculating tile normals
+#define LIGHTING_TILES_PER_THREAD 4096    ///< Not worth starting a thread for fewer tiles than this
+#define LIGHTING_JOB_SIZE 256             ///< Number of tiles a thread takes at a time
+#define LIGHTING_AO_RANGE 8               ///< Tiles whose ambient occlusion depends on the height of a grid point, in each direction
+
 // These values determine the fog when fully zoomed in
 // Determine these when fully zoomed in
 #define FOG_DEPTH 1000
@@ -55,8 +65,26 @@
 static Vector3f theSun(0.f, 0.f, 0.f);
 static Vector3f theSun_ForTileIllumination(0.f, 0.f, 0.f);
 
+/*	The dynamic lights of the current frame, lights on the same tile are merged into one */
+static std::vector<LIGHT> frameLights;
+static std::unordered_map<int, size_t> frameLightTiles;
+
+/*	The parts of the tile lighting that only depend on the terrain, so that a new sun or new scroll limits
+	don't need them to be recalculated: the averaged surface normal in xyz and the ambient occlusion in w */
+static std::vector<glm::vec4> tileNormals;
+static std::vector<bool> tileNormalsDirty;
+static std::vector<int> dirtyTiles;           ///< Tiles whose heights changed since the last updateLighting()
+static const MAPTILE *tileNormalsMap = nullptr;  ///< The campaign swaps the map for the offworld one, so remember which map this is
+static int tileNormalsWidth = 0, tileNormalsHeight = 0;
+
+/// Whether tileNormals belong to the current map.
+static bool tileNormalsValid()
+{
+	return tileNormalsMap == psMapTiles && tileNormalsWidth == mapWidth && tileNormalsHeight == mapHeight;
+}
+
 /*	Module function Prototypes */
-static UDWORD calcDistToTile(UDWORD tileX, UDWORD tileY, Vector3i *pos);
+static glm::vec4 calcTileNormal(UDWORD tileX, UDWORD tileY);
 static void calcTileIllum(UDWORD tileX, UDWORD tileY);
 
 void setTheSun(Vector3f newSun)
@@ -67,7 +95,7 @@ void setTheSun(Vector3f newSun)
 	if(oldSun != theSun)
 	{
 		// The sun has changed - must relcalulate lighting
-		initLighting(0, 0, mapWidth, mapHeight);
+		updateLighting(0, 0, mapWidth, mapHeight);
 	}
 }
 
@@ -82,6 +110,75 @@ Vector3f getTheSun()
  */
 /*****************************************************************************/
 
+/// Recalculates the normals of the given tiles, on several threads if there are many of them.
+static void calcTileNormals(std::vector<int> const &tiles)
+{
+	struct Job
+	{
+		std::vector<int> const *tiles;
+		wz::mutex mutex;
+		size_t next;
+	} job;
+	job.tiles = &tiles;
+	job.next = 0;
+	auto worker = [](void *data) -> int {
+		Job &job = *static_cast<Job *>(data);
+		while (true)
+		{
+			size_t begin, end;
+			{
+				std::lock_guard<wz::mutex> lock(job.mutex);
+				if (job.next >= job.tiles->size())
+				{
+					return 0;
+				}
+				begin = job.next;
+				end = std::min(begin + LIGHTING_JOB_SIZE, job.tiles->size());
+				job.next = end;
+			}
+			// Only reads the map, and each tile is written by a single thread.
+			for (size_t i = begin; i < end; ++i)
+			{
+				const int tile = (*job.tiles)[i];
+				tileNormals[tile] = calcTileNormal(tile % mapWidth, tile / mapWidth);
+			}
+		}
+	};
+
+	// The calling thread does its share of the work too.
+	std::vector<WZ_THREAD *> threads;
+	unsigned numThreads = std::min<size_t>(LIGHTING_THREADS, std::max<size_t>(tiles.size() / LIGHTING_TILES_PER_THREAD, 1)) - 1;
+	for (unsigned n = 0; n < numThreads; ++n)
+	{
+		WZ_THREAD *thread = wzThreadCreate(worker, &job);
+		if (thread == nullptr)
+		{
+			break;
+		}
+		wzThreadStart(thread);
+		threads.push_back(thread);
+	}
+	worker(&job);
+	for (WZ_THREAD *thread : threads)
+	{
+		wzThreadJoin(thread);
+	}
+}
+
+/// Recalculates the normals of the tiles whose heights changed.
+static void calcDirtyTileNormals()
+{
+	if (dirtyTiles.empty())
+	{
+		return;
+	}
+	calcTileNormals(dirtyTiles);
+	for (int tile : dirtyTiles)
+	{
+		tileNormalsDirty[tile] = false;
+	}
+}
+
 //By passing in params - it means that if the scroll limits are changed mid-mission
 //we can re-do over the area that hasn't been seen
 void initLighting(UDWORD x1, UDWORD y1, UDWORD x2, UDWORD y2)
@@ -93,32 +190,110 @@ void initLighting(UDWORD x1, UDWORD y1, UDWORD x2, UDWORD y2)
 		return;
 	}
 
+	if (!tileNormalsValid())
+	{
+		// A different map, nothing is known about it yet.
+		tileNormalsMap = psMapTiles;
+		tileNormalsWidth = mapWidth;
+		tileNormalsHeight = mapHeight;
+		tileNormals.assign(mapWidth * mapHeight, glm::vec4(0.f));
+		tileNormalsDirty.assign(mapWidth * mapHeight, false);
+		dirtyTiles.clear();
+		x1 = y1 = 0;
+		x2 = mapWidth;
+		y2 = mapHeight;
+	}
+
+	// the edge tiles are always dark, so they don't need normals
+	std::vector<int> tiles;
+	for (unsigned j = std::max(y1, 1u); j < std::min<unsigned>(y2, mapHeight - 1); j++)
+	{
+		for (unsigned i = std::max(x1, 1u); i < std::min<unsigned>(x2, mapWidth - 1); i++)
+		{
+			tiles.push_back(i + j * mapWidth);
+		}
+	}
+	calcTileNormals(tiles);
+
+	// dirty tiles in the area are up to date now
+	dirtyTiles.erase(std::remove_if(dirtyTiles.begin(), dirtyTiles.end(), [&](int tile) {
+		const unsigned i = tile % mapWidth, j = tile / mapWidth;
+		if (i < x1 || i >= x2 || j < y1 || j >= y2)
+		{
+			return false;
+		}
+		tileNormalsDirty[tile] = false;
+		return true;
+	}), dirtyTiles.end());
+
 	for (unsigned i = x1; i < x2; i++)
 	{
 		for (unsigned j = y1; j < y2; j++)
 		{
-			MAPTILE	*psTile = mapTile(i, j);
+			calcTileIllum(i, j);
+		}
+	}
+}
 
-			// always make the edge tiles dark
-			if (i == 0 || j == 0 || i >= mapWidth - 1 || j >= mapHeight - 1)
-			{
-				psTile->illumination = 16;
-			}
-			else
-			{
-				calcTileIllum(i, j);
-			}
-			// Basically darkens down the tiles that are outside the scroll
-			// limits - thereby emphasising the cannot-go-there-ness of them
-			if ((SDWORD)i < scrollMinX + 4 || (SDWORD)i > scrollMaxX - 4
-			    || (SDWORD)j < scrollMinY + 4 || (SDWORD)j > scrollMaxY - 4)
+void updateLighting(UDWORD x1, UDWORD y1, UDWORD x2, UDWORD y2)
+{
+	if (!tileNormalsValid())
+	{
+		initLighting(0, 0, mapWidth, mapHeight);
+		return;
+	}
+	if (x1 > mapWidth || x2 > mapWidth || y1 > mapHeight || y2 > mapHeight)
+	{
+		ASSERT(false, "updateLighting: coords off edge of map");
+		return;
+	}
+
+	calcDirtyTileNormals();
+	for (int tile : dirtyTiles)
+	{
+		calcTileIllum(tile % mapWidth, tile / mapWidth);
+	}
+	dirtyTiles.clear();
+
+	for (unsigned i = x1; i < x2; i++)
+	{
+		for (unsigned j = y1; j < y2; j++)
+		{
+			calcTileIllum(i, j);
+		}
+	}
+}
+
+void markLightingDirty(int x, int y)
+{
+	if (!tileNormalsValid())
+	{
+		return;  // Will be calculated by initLighting() anyway
+	}
+
+	// The height of the grid point is in the normals of the tiles next to it, and in the ambient occlusion further away
+	for (int j = std::max(y - LIGHTING_AO_RANGE, 1); j <= std::min(y + LIGHTING_AO_RANGE, mapHeight - 2); ++j)
+	{
+		for (int i = std::max(x - LIGHTING_AO_RANGE, 1); i <= std::min(x + LIGHTING_AO_RANGE, mapWidth - 2); ++i)
+		{
+			const int tile = i + j * mapWidth;
+			if (!tileNormalsDirty[tile])
 			{
-				psTile->illumination /= 3;
+				tileNormalsDirty[tile] = true;
+				dirtyTiles.push_back(tile);
 			}
 		}
 	}
 }
 
+void updateDirtyLighting()
+{
+	if (!dirtyTiles.empty())
+	{
+		updateLighting(0, 0, 0, 0);
+	}
+}
+
 
 static void normalsOnTile(unsigned int tileX, unsigned int tileY, unsigned int quadrant, unsigned int *numNormals, Vector3f normals[])
 {
@@ -173,7 +348,7 @@ static void normalsOnTile(unsigned int tileX, unsigned int tileY, unsigned int q
 }
 
 
-static void calcTileIllum(UDWORD tileX, UDWORD tileY)
+static glm::vec4 calcTileNormal(UDWORD tileX, UDWORD tileY)
 {
 	unsigned int numNormals = 0; // How many normals have we got?
 	Vector3f normals[8]; // Maximum 8 possible normals
@@ -212,8 +387,6 @@ static void calcTileIllum(UDWORD tileX, UDWORD tileY)
 		finalVector += normals[i];
 	}
 
-	float dotProduct = glm::dot(normalise(finalVector), theSun_ForTileIllumination)/16;
-
 	// Primitive ambient occlusion calculation.
 	float ao = 0;
 	const int cx = world_coord(tileX), cy = world_coord(tileY), maxX = world_coord(mapWidth), maxY = world_coord(mapHeight);
@@ -236,18 +409,40 @@ static void calcTileIllum(UDWORD tileX, UDWORD tileY)
 	}
 	ao *= 1.f/Dirs;
 
-	mapTile(tileX, tileY)->illumination = static_cast<uint8_t>(clip<int>(abs(dotProduct*ao), 1, 254));
+	return glm::vec4(normalise(finalVector), ao);
 }
 
-static void colourTile(SDWORD xIndex, SDWORD yIndex, PIELIGHT light_colour, double fraction)
+static void calcTileIllum(UDWORD tileX, UDWORD tileY)
+{
+	MAPTILE	*psTile = mapTile(tileX, tileY);
+
+	// always make the edge tiles dark
+	if (tileX == 0 || tileY == 0 || tileX >= mapWidth - 1 || tileY >= mapHeight - 1)
+	{
+		psTile->illumination = 16;
+	}
+	else
+	{
+		const glm::vec4 &normal = tileNormals[tileX + tileY * mapWidth];
+		float dotProduct = glm::dot(Vector3f(normal), theSun_ForTileIllumination)/16;
+		psTile->illumination = static_cast<uint8_t>(clip<int>(abs(dotProduct*normal.w), 1, 254));
+	}
+	// Basically darkens down the tiles that are outside the scroll
+	// limits - thereby emphasising the cannot-go-there-ness of them
+	if ((SDWORD)tileX < scrollMinX + 4 || (SDWORD)tileX > scrollMaxX - 4
+	    || (SDWORD)tileY < scrollMinY + 4 || (SDWORD)tileY > scrollMaxY - 4)
+	{
+		psTile->illumination /= 3;
+	}
+}
+
+void clearLights()
 {
-	PIELIGHT colour = getTileColour(xIndex, yIndex);
-	colour.byte.r = MIN(255, colour.byte.r + light_colour.byte.r * fraction);
-	colour.byte.g = MIN(255, colour.byte.g + light_colour.byte.g * fraction);
-	colour.byte.b = MIN(255, colour.byte.b + light_colour.byte.b * fraction);
-	setTileColour(xIndex, yIndex, colour);
+	frameLights.clear();
+	frameLightTiles.clear();
 }
 
+/// The light is only recorded here, the terrain shaders apply it to the tiles in range when drawing
 void processLight(LIGHT *psLight)
 {
 	/* Firstly - there's no point processing lights that are off the grid */
@@ -256,54 +451,47 @@ void processLight(LIGHT *psLight)
 		return;
 	}
 
-	const int tileX = psLight->position.x / TILE_UNITS;
-	const int tileY = psLight->position.z / TILE_UNITS;
-	const int rangeSkip = sqrtf(psLight->range * psLight->range * 2) / TILE_UNITS + 1;
-
-	/* Rough guess? */
-	int startX = tileX - rangeSkip;
-	int endX = tileX + rangeSkip;
-	int startY = tileY - rangeSkip;
-	int endY = tileY + rangeSkip;
-
-	/* Clip to grid limits */
-	startX = MAX(startX, 0);
-	endX = MAX(endX, 0);
-	endX = MIN(endX, mapWidth - 1);
-	startX = MIN(startX, endX);
-	startY = MAX(startY, 0);
-	endY = MAX(endY, 0);
-	endY = MIN(endY, mapHeight - 1);
-	startY = MIN(startY, endY);
-
-	for (int i = startX; i <= endX; i++)
-	{
-		for (int j = startY; j <= endY; j++)
-		{
-			int distToCorner = calcDistToTile(i, j, &psLight->position);
+	const int tileX = map_coord(psLight->position.x);
+	const int tileY = map_coord(psLight->position.z);
 
-			/* If we're inside the range of the light */
-			if (distToCorner < (SDWORD)psLight->range)
-			{
-				/* Find how close we are to it */
-				double ratio = (100.0 - PERCENT(distToCorner, psLight->range)) / 100.0;
-				colourTile(i, j, psLight->colour, ratio);
-			}
-		}
+	/* Nor lights that can't reach any of the visible tiles */
+	const int rangeTiles = map_coord((int)psLight->range) + 1;
+	const int playerX = map_coord(playerPos.p.x);
+	const int playerY = map_coord(playerPos.p.z);
+	if (abs(tileX - playerX) > visibleTiles.x / 2 + rangeTiles || abs(tileY - playerY) > visibleTiles.y / 2 + rangeTiles)
+	{
+		return;
 	}
-}
-
 
-static UDWORD calcDistToTile(UDWORD tileX, UDWORD tileY, Vector3i *pos)
-{
-	int x1, y1, z1;
+	auto tile = frameLightTiles.emplace(tileX + tileY * mapWidth, frameLights.size());
+	if (tile.second)
+	{
+		frameLights.push_back(*psLight);
+		return;
+	}
 
-	/* The coordinates of the tile corner */
-	x1 = tileX * TILE_UNITS;
-	y1 = map_TileHeight(tileX, tileY);
-	z1 = tileY * TILE_UNITS;
+	/* Several lights on one tile (a burst of explosions, say) add up, like they used to on the tile colours */
+	LIGHT &light = frameLights[tile.first->second];
+	light.range = MAX(light.range, psLight->range);
+	light.colour.byte.r = MIN(255, light.colour.byte.r + psLight->colour.byte.r);
+	light.colour.byte.g = MIN(255, light.colour.byte.g + psLight->colour.byte.g);
+	light.colour.byte.b = MIN(255, light.colour.byte.b + psLight->colour.byte.b);
+}
 
-	return iHypot3(x1 - pos->x, y1 - pos->y, z1 - pos->z);
+std::vector<LIGHT> getStrongestLights(size_t maxLights)
+{
+	auto strength = [](LIGHT const &light) {
+		return light.range * (light.colour.byte.r + light.colour.byte.g + light.colour.byte.b);
+	};
+	std::vector<LIGHT> lights = frameLights;
+	if (lights.size() > maxLights)
+	{
+		std::nth_element(lights.begin(), lights.begin() + maxLights, lights.end(), [&](LIGHT const &a, LIGHT const &b) {
+			return strength(a) > strength(b);
+		});
+		lights.resize(maxLights);
+	}
+	return lights;
 }
 
 /// Sets the begin and end distance for the distance fog (mist)
@@ -23,6 +23,8 @@
 
 #include "lib/ivis_opengl/pietypes.h"
 
+#include <vector>
+
 struct LIGHT
 {
 	Vector3i position = Vector3i(0, 0, 0);
@@ -33,8 +35,21 @@ struct LIGHT
 void setTheSun(Vector3f newSun);
 Vector3f getTheSun();
 
+/// Forgets the dynamic lights of the previous frame
+void clearLights();
+/// Adds a dynamic light to the current frame
 void processLight(LIGHT *psLight);
+/// Returns up to maxLights of the dynamic lights of the current frame, preferring the largest and brightest ones
+std::vector<LIGHT> getStrongestLights(size_t maxLights);
+/// Calculates the lighting of the tiles in the area from scratch
 void initLighting(UDWORD x1, UDWORD y1, UDWORD x2, UDWORD y2);
+/// Recalculates the illumination of the tiles in the area, e.g. after the scroll limits changed. Only
+/// tiles whose heights changed since they were last lit need their normals to be recalculated.
+void updateLighting(UDWORD x1, UDWORD y1, UDWORD x2, UDWORD y2);
+/// The height of the grid point changed, the tiles around it must be relit
+void markLightingDirty(int x, int y);
+/// Relights the tiles around grid points whose heights changed, call once per frame
+void updateDirtyLighting();
 void doBuildingLights();
 void UpdateFogDistance(float distance);
 void calcDroidIllumination(DROID *psDroid);
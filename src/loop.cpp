@@ -84,6 +84,7 @@
 #include "notifications.h"
 #include "scores.h"
 #include "clparse.h"
+#include "snapshot.h"
 
 #include "warzoneconfig.h"
 
@@ -91,6 +92,7 @@
 #include "objmem.h"
 #endif
 
+#include <chrono>
 #include <numeric>
 
 
@@ -130,6 +132,46 @@ LOOP_MISSION_STATE		loopMissionState = LMS_NORMAL;
 // this is set by scrStartMission to say what type of new level is to be started
 LEVEL_TYPE nextMissionType = LEVEL_TYPE::LDS_NONE;
 
+/// Parts of the game state update, to see where the time goes when running uncapped.
+enum TICK_PHASE
+{
+	TICK_PHASE_NETWORK,
+	TICK_PHASE_SCRIPTS,
+	TICK_PHASE_VISIBILITY,
+	TICK_PHASE_PATHS,
+	TICK_PHASE_DROIDS,
+	TICK_PHASE_STRUCTURES,
+	TICK_PHASE_PROJECTILES,
+	TICK_PHASE_OTHER,
+	TICK_PHASE_COUNT
+};
+static const char *const tickPhaseNames[TICK_PHASE_COUNT] = {"network", "scripts", "visibility", "paths", "droids", "structures", "projectiles", "other"};
+
+static struct
+{
+	bool started = false;
+	uint32_t startRealTime = 0;
+	uint32_t startGameTime = 0;
+	unsigned ticks = 0;
+	uint64_t phaseTime[TICK_PHASE_COUNT] = {};  ///< In microseconds
+} tickStats;
+
+/// Adds the time since it was created or last called to a part of the game state update.
+class TickPhaseTimer
+{
+public:
+	TickPhaseTimer() : last(std::chrono::steady_clock::now()) {}
+	void lap(TICK_PHASE phase)
+	{
+		auto now = std::chrono::steady_clock::now();
+		tickStats.phaseTime[phase] += std::chrono::duration_cast<std::chrono::microseconds>(now - last).count();
+		last = now;
+	}
+
+private:
+	std::chrono::steady_clock::time_point last;
+};
+
 static GAMECODE renderLoop()
 {
 	if (bMultiPlayer && !NetPlay.isHostAlive && NetPlay.bComms && !NetPlay.isHost)
@@ -178,7 +220,7 @@ static GAMECODE renderLoop()
 				multiPlayerLoop();
 			}
 
-			for (unsigned i = 0; i < MAX_PLAYERS; i++)
+			for (unsigned i = 0; i < MAX_PLAYERS && !gameTimeIsUncapped(); i++)
 			{
 				for (DROID *psCurr = apsDroidLists[i]; psCurr; psCurr = psCurr->psNext)
 				{
@@ -508,6 +550,8 @@ void countUpdate(bool synch)
 
 static void gameStateUpdate()
 {
+	TickPhaseTimer timer;
+
 	syncDebug("map = \"%s\", pseudorandom 32-bit integer = 0x%08X, allocated = %d %d %d %d %d %d %d %d %d %d, position = %d %d %d %d %d %d %d %d %d %d", game.map, gameRandU32(),
 	          NetPlay.players[0].allocated, NetPlay.players[1].allocated, NetPlay.players[2].allocated, NetPlay.players[3].allocated, NetPlay.players[4].allocated, NetPlay.players[5].allocated, NetPlay.players[6].allocated, NetPlay.players[7].allocated, NetPlay.players[8].allocated, NetPlay.players[9].allocated,
 	          NetPlay.players[0].position, NetPlay.players[1].position, NetPlay.players[2].position, NetPlay.players[3].position, NetPlay.players[4].position, NetPlay.players[5].position, NetPlay.players[6].position, NetPlay.players[7].position, NetPlay.players[8].position, NetPlay.players[9].position
@@ -527,14 +571,17 @@ static void gameStateUpdate()
 
 	sendPlayerGameTime();
 	NETflush();  // Make sure the game time tick message is really sent over the network.
+	timer.lap(TICK_PHASE_NETWORK);
 
 	if (!paused && !scriptPaused())
 	{
 		updateScripts();
 	}
+	timer.lap(TICK_PHASE_SCRIPTS);
 
 	// Update abandoned structures
 	handleAbandonedStructures();
+	timer.lap(TICK_PHASE_STRUCTURES);
 
 	// Update the visibility change stuff
 	visUpdateLevel();
@@ -544,20 +591,25 @@ static void gameStateUpdate()
 
 	// Check which objects are visible.
 	processVisibility();
+	timer.lap(TICK_PHASE_VISIBILITY);
 
 	// Update the map.
 	mapUpdate();
+	timer.lap(TICK_PHASE_OTHER);
 
 	//update the findpath system
 	fpathUpdate();
+	timer.lap(TICK_PHASE_PATHS);
 
 	// update the command droids
 	cmdDroidUpdate();
+	timer.lap(TICK_PHASE_DROIDS);
 
 	for (unsigned i = 0; i < MAX_PLAYERS; i++)
 	{
 		//update the current power available for a player
 		updatePlayerPower(i);
+		timer.lap(TICK_PHASE_OTHER);
 
 		DROID *psNext;
 		for (DROID *psCurr = apsDroidLists[i]; psCurr != nullptr; psCurr = psNext)
@@ -574,6 +626,7 @@ static void gameStateUpdate()
 			psNext = psCurr->psNext;
 			missionDroidUpdate(psCurr);
 		}
+		timer.lap(TICK_PHASE_DROIDS);
 
 		// FIXME: These for-loops are code duplicationo
 		STRUCTURE *psNBuilding;
@@ -589,11 +642,14 @@ static void gameStateUpdate()
 			psNBuilding = psCBuilding->psNext;
 			structureUpdate(psCBuilding, true); // update for mission
 		}
+		timer.lap(TICK_PHASE_STRUCTURES);
 	}
 
 	missionTimerUpdate();
+	timer.lap(TICK_PHASE_OTHER);
 
 	proj_UpdateAll();
+	timer.lap(TICK_PHASE_PROJECTILES);
 
 	FEATURE *psNFeat;
 	for (FEATURE *psCFeat = apsFeatureLists[0]; psCFeat; psCFeat = psNFeat)
@@ -605,11 +661,57 @@ static void gameStateUpdate()
 	// Free dead droid memory.
 	objmemUpdate();
 
+	// Keep recent game states around for desynch diagnostics, if sync debugging is enabled.
+	recordWorldSnapshot();
+
 	// Must end update, since we may or may not have ticked, and some message queue processing code may vary depending on whether it's in an update.
 	gameTimeUpdateEnd();
 
 	// Must be at the end of gameStateUpdate, since countUpdate is also called randomly (unsynchronised) between gameStateUpdate calls, but should have no effect if we already called it, and recvMessage requires consistent counts on all clients.
 	countUpdate(true);
+	timer.lap(TICK_PHASE_OTHER);
+	++tickStats.ticks;
+}
+
+/// Outputs occasional stats on how fast the game runs to stdout, for games running uncapped.
+static void stdOutTickStats()
+{
+	if (!tickStats.started)
+	{
+		tickStats.started = true;
+		tickStats.startRealTime = realTime;
+		tickStats.startGameTime = gameTime;
+		return;
+	}
+	const uint32_t elapsedRealTime = realTime - tickStats.startRealTime;
+	if (elapsedRealTime < 5 * GAME_TICKS_PER_SEC || tickStats.ticks == 0)
+	{
+		return;
+	}
+
+	unsigned numDroids = 0, numStructures = 0, numFeatures = 0;
+	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	{
+		for (DROID *psDroid = apsDroidLists[player]; psDroid; psDroid = psDroid->psNext, ++numDroids) {}
+		for (STRUCTURE *psStruct = apsStructLists[player]; psStruct; psStruct = psStruct->psNext, ++numStructures) {}
+	}
+	for (FEATURE *psFeat = apsFeatureLists[0]; psFeat; psFeat = psFeat->psNext, ++numFeatures) {}
+
+	fprintf(stdout, "Ticks: %u in %.1f s (%.1f ticks/s, %.1fx real time), objects: %u droids, %u structures, %u features\n",
+	        tickStats.ticks, elapsedRealTime / 1000.0, tickStats.ticks * 1000.0 / elapsedRealTime,
+	        double(gameTime - tickStats.startGameTime) / elapsedRealTime, numDroids, numStructures, numFeatures);
+	fprintf(stdout, "Time per tick (ms):");
+	for (unsigned phase = 0; phase < TICK_PHASE_COUNT; ++phase)
+	{
+		fprintf(stdout, " %s %.2f", tickPhaseNames[phase], tickStats.phaseTime[phase] / 1000.0 / tickStats.ticks);
+		tickStats.phaseTime[phase] = 0;
+	}
+	fprintf(stdout, "\n");
+	fflush(stdout);
+
+	tickStats.startRealTime = realTime;
+	tickStats.startGameTime = gameTime;
+	tickStats.ticks = 0;
 }
 
 /* The main game loop */
@@ -673,6 +775,10 @@ GAMECODE gameLoop()
 		// Output occasional stats to stdout
 		stdOutGameSummary();
 	}
+	if (gameTimeIsUncapped())
+	{
+		stdOutTickStats();
+	}
 
 	return renderReturn;
 }
@@ -434,7 +434,7 @@ static std::string getPlatformPrefDir_Fallback(const char *org, const char *app)
 
 	// Create the folders within the basePath if they don't exist
 
-	if (!PHYSFS_setWriteDir(basePath.toUtf8().c_str())) // Workaround for PhysFS not creating the writedir as expected.
+	if (!WZ_PHYSFS_setWriteDir(basePath.toUtf8().c_str())) // Workaround for PhysFS not creating the writedir as expected.
 	{
 		debug(LOG_FATAL, "Error setting write directory to \"%s\": %s",
 			  basePath.toUtf8().c_str(), WZ_PHYSFS_getLastError());
@@ -455,7 +455,7 @@ static std::string getPlatformPrefDir_Fallback(const char *org, const char *app)
 		currentBasePath += PHYSFS_getDirSeparator();
 		currentBasePath += folder;
 
-		if (!PHYSFS_setWriteDir(currentBasePath.toUtf8().c_str())) // Workaround for PhysFS not creating the writedir as expected.
+		if (!WZ_PHYSFS_setWriteDir(currentBasePath.toUtf8().c_str())) // Workaround for PhysFS not creating the writedir as expected.
 		{
 			debug(LOG_FATAL, "Error setting write directory to \"%s\": %s",
 				  currentBasePath.toUtf8().c_str(), WZ_PHYSFS_getLastError());
@@ -487,7 +487,7 @@ static std::string getPlatformPrefDir(const char * org, const std::string &app)
 		std::string appendPath = app;
 
 		// Create the folders within the prefixPath if they don't exist
-		if (!PHYSFS_setWriteDir(prefixPath.c_str())) // Workaround for PhysFS not creating the writedir as expected.
+		if (!WZ_PHYSFS_setWriteDir(prefixPath.c_str())) // Workaround for PhysFS not creating the writedir as expected.
 		{
 			debug(LOG_FATAL, "Error setting write directory to \"%s\": %s",
 				  prefixPath.c_str(), WZ_PHYSFS_getLastError());
@@ -553,7 +553,7 @@ static void initialize_ConfigDir()
 		debug(LOG_WZ, "Using custom configuration directory: %s", configDir.c_str());
 	}
 
-	if (!PHYSFS_setWriteDir(configDir.c_str())) // Workaround for PhysFS not creating the writedir as expected.
+	if (!WZ_PHYSFS_setWriteDir(configDir.c_str())) // Workaround for PhysFS not creating the writedir as expected.
 	{
 		debug(LOG_FATAL, "Error setting write directory to \"%s\": %s",
 			  configDir.c_str(), WZ_PHYSFS_getLastError());
@@ -568,7 +568,7 @@ static void initialize_ConfigDir()
 
 
 	// Config dir first so we always see what we write
-	PHYSFS_mount(PHYSFS_getWriteDir(), NULL, PHYSFS_PREPEND);
+	WZ_PHYSFS_mount(PHYSFS_getWriteDir(), NULL, PHYSFS_PREPEND);
 
 	// Do not follow symlinks *inside* search paths / archives
 	PHYSFS_permitSymbolicLinks(0);
@@ -1449,13 +1449,30 @@ int realmain(int argc, char *argv[])
 	// Save new (commandline) settings
 	saveConfig();
 
+	// Only run games as fast as possible if nobody is watching
+	if (uncapped_enabled())
+	{
+		if (headlessGameMode())
+		{
+			gameTimeSetUncapped(true);
+		}
+		else
+		{
+			debug(LOG_ERROR, "--uncapped is only supported in headless mode, ignoring it");
+		}
+	}
+
 	// Print out some initial information if in headless mode
 	if (headlessGameMode())
 	{
 		fprintf(stdout, "--------------------------------------------------------------------------------------\n");
 		fprintf(stdout, " * Warzone 2100 - Headless Mode\n");
 		fprintf(stdout, " * %s\n", version_getFormattedVersionString(false));
-		if (to_swap_mode(war_GetVsync()) == gfx_api::context::swap_interval_mode::immediate)
+		if (gameTimeIsUncapped())
+		{
+			fprintf(stdout, " * NOTE: GAME SPEED IS UNCAPPED - SOUND IS DISABLED\n");
+		}
+		else if (to_swap_mode(war_GetVsync()) == gfx_api::context::swap_interval_mode::immediate)
 		{
 			fprintf(stdout, " * NOTE: VSYNC IS DISABLED - CPU USAGE MAY BE UNBOUNDED\n");
 		}
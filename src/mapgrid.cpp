@@ -35,6 +35,10 @@
 static PointTree *gridPointTree = nullptr;  // A quad-tree-like object.
 static PointTree::Filter *gridFiltersUnseen;
 static PointTree::Filter *gridFiltersDroidsByPlayer;
+static PointTree *gridRepairablePointTree = nullptr;  // Objects that were damaged or being built when the grid was reset.
+static GridList gridRepairableSinceReset;            // Objects that may have become damaged or started being built since.
+static uint32_t gridResetCount = 1;                  // Number of grid resets, objects that are repairable since the last one are marked with it.
+#define GRID_REPAIRABLE_MAX_SINCE_RESET 64           // Put the objects into gridRepairablePointTree once there are more than this.
 
 // initialise the grid system
 bool gridInitialise()
@@ -43,14 +47,31 @@ bool gridInitialise()
 	gridPointTree = new PointTree;
 	gridFiltersUnseen = new PointTree::Filter[MAX_PLAYERS];
 	gridFiltersDroidsByPlayer = new PointTree::Filter[MAX_PLAYERS];
+	gridRepairablePointTree = new PointTree;
 
 	return true;  // Yay, nothing failed!
 }
 
+static bool isRepairable(BASE_OBJECT *psObj)
+{
+	switch (psObj->type)
+	{
+	case OBJ_DROID:
+		return droidIsDamaged((DROID *)psObj);
+	case OBJ_STRUCTURE:
+		return ((STRUCTURE *)psObj)->status == SS_BEING_BUILT || structIsDamaged((STRUCTURE *)psObj);
+	default:
+		return false;
+	}
+}
+
 // reset the grid system
 void gridReset()
 {
 	gridPointTree->clear();
+	gridRepairablePointTree->clear();
+	gridRepairableSinceReset.clear();
+	++gridResetCount;
 
 	// Put all existing objects into the point tree.
 	for (unsigned player = 0; player < MAX_PLAYERS; player++)
@@ -63,6 +84,11 @@ void gridReset()
 				if (!psObj->died)
 				{
 					gridPointTree->insert(psObj, psObj->pos.x, psObj->pos.y);
+					if (isRepairable(psObj))
+					{
+						gridRepairablePointTree->insert(psObj, psObj->pos.x, psObj->pos.y);
+						psObj->gridRepairableMark = gridResetCount;
+					}
 					for (unsigned char &viewer : psObj->seenThisTick)
 					{
 						viewer = 0;
@@ -73,6 +99,7 @@ void gridReset()
 	}
 
 	gridPointTree->sort();
+	gridRepairablePointTree->sort();
 
 	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
 	{
@@ -90,6 +117,9 @@ void gridShutDown()
 	gridFiltersUnseen = nullptr;
 	delete[] gridFiltersDroidsByPlayer;
 	gridFiltersDroidsByPlayer = nullptr;
+	delete gridRepairablePointTree;
+	gridRepairablePointTree = nullptr;
+	gridRepairableSinceReset.clear();
 }
 
 static bool isInRadius(int32_t x, int32_t y, uint32_t radius)
@@ -201,6 +231,48 @@ GridList const &gridStartIterateUnseen(int32_t x, int32_t y, uint32_t radius, in
 	return gridStartIterateFiltered(x, y, radius, &gridFiltersUnseen[player], ConditionUnseen(player));
 }
 
+void gridMarkRepairable(BASE_OBJECT *psObj)
+{
+	if (gridRepairablePointTree == nullptr || psObj->died || psObj->gridRepairableMark == gridResetCount)
+	{
+		return;  // Not initialised, not in the grid, or already found by gridStartIterateRepairable().
+	}
+	psObj->gridRepairableMark = gridResetCount;
+	gridRepairableSinceReset.push_back(psObj);
+	if (gridRepairableSinceReset.size() > GRID_REPAIRABLE_MAX_SINCE_RESET)
+	{
+		// Too many to check one by one on every query.
+		for (BASE_OBJECT *obj : gridRepairableSinceReset)
+		{
+			gridRepairablePointTree->insert(obj, obj->pos.x, obj->pos.y);
+		}
+		gridRepairablePointTree->sort();
+		gridRepairableSinceReset.clear();
+	}
+}
+
+GridList const &gridStartIterateRepairable(int32_t x, int32_t y, uint32_t radius)
+{
+	static GridList gridList;
+	gridList.clear();
+	for (void *point : gridRepairablePointTree->query(x, y, radius))
+	{
+		BASE_OBJECT *obj = static_cast<BASE_OBJECT *>(point);
+		if (isInRadius(obj->pos.x - x, obj->pos.y - y, radius))
+		{
+			gridList.push_back(obj);
+		}
+	}
+	for (BASE_OBJECT *obj : gridRepairableSinceReset)
+	{
+		if (isInRadius(obj->pos.x - x, obj->pos.y - y, radius))
+		{
+			gridList.push_back(obj);
+		}
+	}
+	return gridList;
+}
+
 BASE_OBJECT **gridIterateDup()
 {
 	size_t bytes = gridPointTree->lastQueryResults.size() * sizeof(void *);
@@ -46,6 +46,13 @@ GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t
 /// Find all objects within radius where object->type == OBJ_DROID && object->player == player.
 GridList const &gridStartIterateDroidsByPlayer(int32_t x, int32_t y, uint32_t radius, int player);
 
+/// Find all objects within radius which were damaged or being built when the grid was reset, or which were
+/// passed to gridMarkRepairable() since. The objects found need not be damaged or being built any more.
+GridList const &gridStartIterateRepairable(int32_t x, int32_t y, uint32_t radius);
+
+/// Call when an object may have become damaged, or started being built, so gridStartIterateRepairable() finds it before the next reset.
+void gridMarkRepairable(BASE_OBJECT *psObj);
+
 // Used for visibility.
 /// Find all objects within radius where object->seenThisTick[player] != 255.
 GridList const &gridStartIterateUnseen(int32_t x, int32_t y, uint32_t radius, int player);
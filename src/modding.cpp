@@ -132,7 +132,7 @@ void addSubdirs(const char *basedir, const char *subdir, const bool appendToPath
 				snprintf(buf, sizeof(buf), "mod: %s", i);
 				addDumpInfo(buf);
 			}
-			PHYSFS_mount(tmpstr, NULL, appendToPath); // platform-dependent notation
+			WZ_PHYSFS_mount(tmpstr, NULL, appendToPath); // platform-dependent notation
 		}
 		return true; // continue
 	});
@@ -221,11 +221,15 @@ std::vector<Sha256> const &getModHashList()
 {
 	if (mod_hash_list.empty())
 	{
+		std::vector<std::string> filenames;
 		for (auto const &mod : loaded_mods)
 		{
-			Sha256 hash = findHashOfFile(mod.filename.c_str());
-			debug(LOG_WZ, "Mod[%s]: %s\n", hash.toString().c_str(), mod.filename.c_str());
-			mod_hash_list.push_back(hash);
+			filenames.push_back(mod.filename);
+		}
+		mod_hash_list = findHashOfFiles(filenames);
+		for (size_t i = 0; i < filenames.size(); ++i)
+		{
+			debug(LOG_WZ, "Mod[%s]: %s\n", mod_hash_list[i].toString().c_str(), filenames[i].c_str());
 		}
 	}
 	return mod_hash_list;
@@ -233,12 +237,17 @@ std::vector<Sha256> const &getModHashList()
 
 std::string getModFilename(Sha256 const &hash)
 {
+	std::vector<std::string> filenames;
 	for (auto const &mod : loaded_mods)
 	{
-		Sha256 foundHash = findHashOfFile(mod.filename.c_str());
-		if (foundHash == hash)
+		filenames.push_back(mod.filename);
+	}
+	std::vector<Sha256> hashes = findHashOfFiles(filenames);
+	for (size_t i = 0; i < filenames.size(); ++i)
+	{
+		if (hashes[i] == hash)
 		{
-			return mod.filename;
+			return filenames[i];
 		}
 	}
 	return {};
@@ -4053,6 +4053,10 @@ void WzMultiplayerOptionsTitleUI::frontendMultiMessages(bool running)
 				break;
 			}
 
+		case NET_FILE_ACK:
+			NETrecvFileAck(queue);
+			break;
+
 		case NET_FILE_CANCELLED:
 			{
 				ASSERT_HOST_ONLY(break);
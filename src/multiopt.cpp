@@ -234,7 +234,7 @@ void recvOptions(NETQUEUE queue)
 		}
 		else if (findHashOfFile(filename) != hash)
 		{
-			debug(LOG_INFO, "Overwriting old incomplete or corrupt file %s", filename);
+			debug(LOG_INFO, "Continuing or replacing old incomplete or corrupt file %s", filename);
 		}
 		else
 		{
@@ -242,20 +242,12 @@ void recvOptions(NETQUEUE queue)
 			return false;  // Have the file already.
 		}
 
-		PHYSFS_file *pFileHandle = PHYSFS_openWrite(filename);
-		if (pFileHandle == nullptr)
+		// Request the map/mod from the host
+		if (!NETrequestFile(hash, filename))
 		{
-			debug(LOG_ERROR, "Failed to open %s for writing: %s", filename, WZ_PHYSFS_getLastError());
 			return false;
 		}
 
-		NetPlay.wzFiles.emplace_back(pFileHandle, filename, hash);
-
-		// Request the map/mod from the host
-		NETbeginEncode(NETnetQueue(NET_HOST_ONLY), NET_FILE_REQUESTED);
-		NETbin(hash.bytes, hash.Bytes);
-		NETend();
-
 		haveData = false;
 		return true;  // Starting download now.
 	};
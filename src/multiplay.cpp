@@ -1341,8 +1341,10 @@ bool recvMapFileRequested(NETQUEUE queue)
 
 	Sha256 hash;
 	hash.setZero();
+	uint32_t resumePos = 0;
 	NETbeginDecode(queue, NET_FILE_REQUESTED);
 	NETbin(hash.bytes, hash.Bytes);
+	NETuint32_t(&resumePos);  // size of what the player already has from an interrupted download
 	NETend();
 
 	auto &files = NetPlay.players[player].wzFiles;
@@ -1395,9 +1397,14 @@ bool recvMapFileRequested(NETQUEUE queue)
 	uint32_t fileSize_u32 = (uint32_t)fileSize_64;
 	ASSERT_OR_RETURN(false, fileSize_u32 <= MAX_NET_TRANSFERRABLE_FILE_SIZE, "Filesize is too large; (size: %" PRIu32")", fileSize_u32);
 
+	if (resumePos >= fileSize_u32 || !PHYSFS_seek(pFileHandle, resumePos))
+	{
+		resumePos = 0;  // Start over, the player will notice that the first chunk is at the start of the file.
+	}
+
 	// Schedule file to be sent.
-	debug(LOG_INFO, "File is valid, sending [directory: %s] %s to client %u", WZ_PHYSFS_getRealDir_String(filename.c_str()).c_str(), filename.c_str(), player);
-	files.emplace_back(pFileHandle, filename, hash, fileSize_u32);
+	debug(LOG_INFO, "File is valid, sending [directory: %s] %s to client %u from %" PRIu32" bytes", WZ_PHYSFS_getRealDir_String(filename.c_str()).c_str(), filename.c_str(), player, resumePos);
+	files.emplace_back(pFileHandle, filename, hash, fileSize_u32, resumePos);
 
 	return true;
 }
@@ -1409,38 +1416,37 @@ void sendMap()
 	// (at 60fps, total frame budget is ~16ms - allocate 4ms max for each call to sendMap)
 	const uint64_t maxMicroSecondsPerSendMapCall = (4 * 1000);
 
-	// calculate the time budget per file
-	uint64_t totalFilesToSend = 0;
-	for (int i = 0; i < MAX_PLAYERS; ++i)
-	{
-		totalFilesToSend += NetPlay.players[i].wzFiles.size();
-	}
-	const uint64_t maxMicroSecondsPerFile = maxMicroSecondsPerSendMapCall / std::max((uint64_t)1, totalFilesToSend);
-
 	using microDuration = std::chrono::duration<uint64_t, std::micro>;
-	auto file_startTime = std::chrono::high_resolution_clock::now();
-	microDuration file_currentDuration;
+	auto startTime = std::chrono::high_resolution_clock::now();
 
-	for (int i = 0; i < MAX_PLAYERS; ++i)
+	// Send one chunk of each file in turn, so that all downloading players get an equal share of the budget,
+	// and players with a slow connection (whose window of unacknowledged chunks is full) don't hold up the others.
+	bool sentChunk = true;
+	while (sentChunk && std::chrono::duration_cast<microDuration>(std::chrono::high_resolution_clock::now() - startTime).count() < maxMicroSecondsPerSendMapCall)
 	{
-		auto &files = NetPlay.players[i].wzFiles;
-		for (auto &file : files)
+		sentChunk = false;
+		for (int i = 0; i < MAX_PLAYERS; ++i)
 		{
-			int done = 0;
-			file_startTime = std::chrono::high_resolution_clock::now();
-			do
-			{
-				done = NETsendFile(file, i);
-				file_currentDuration = std::chrono::duration_cast<microDuration>(std::chrono::high_resolution_clock::now() - file_startTime);
-			}
-			while (done < 100 && (file_currentDuration.count() < maxMicroSecondsPerFile));
-			if (done == 100)
+			for (auto &file : NetPlay.players[i].wzFiles)
 			{
-				netPlayersUpdated = true;  // Remove download icon from player.
-				addConsoleMessage(_("FILE SENT!"), DEFAULT_JUSTIFY, SYSTEM_MESSAGE);
-				debug(LOG_INFO, "=== File has been sent to player %d ===", i);
+				if (!NETcanSendFile(file))
+				{
+					continue;
+				}
+				sentChunk = true;
+				if (NETsendFile(file, i) == 100)
+				{
+					netPlayersUpdated = true;  // Remove download icon from player.
+					addConsoleMessage(_("FILE SENT!"), DEFAULT_JUSTIFY, SYSTEM_MESSAGE);
+					debug(LOG_INFO, "=== File has been sent to player %d ===", i);
+				}
 			}
 		}
+	}
+
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+	{
+		auto &files = NetPlay.players[i].wzFiles;
 		files.erase(std::remove_if(files.begin(), files.end(), [](WZFile const &file) { return file.handle == nullptr; }), files.end());
 	}
 }
@@ -24,6 +24,7 @@
  *
  */
 #include <string.h>
+#include <unordered_map>
 
 #include "lib/framework/frame.h"
 #include "objects.h"
@@ -65,6 +66,10 @@ FLAG_POSITION	*apsFlagPosLists[MAX_PLAYERS];
 /* The list of destroyed objects */
 BASE_OBJECT		*psDestroyedObj = nullptr;
 
+/* Id lookup table, only filled between objmemBuildIdIndex() and objmemClearIdIndex() */
+static std::unordered_map<UDWORD, BASE_OBJECT *> objIdIndex;
+static bool objIdIndexValid = false;
+
 /* Forward function declarations */
 #ifdef DEBUG
 static void objListIntegCheck();
@@ -94,26 +99,24 @@ void objmemShutdown()
 #endif
 static bool checkReferences(BASE_OBJECT *psVictim)
 {
-	for (int plr = 0; plr < MAX_PLAYERS; ++plr)
+	for (BASE_OBJECT *psReferrer : psVictim->psReferrers)
 	{
-		for (STRUCTURE *psStruct = apsStructLists[plr]; psStruct != nullptr; psStruct = psStruct->psNext)
+		if (psReferrer == psVictim || psReferrer->died != 0)
 		{
-			if (psStruct == psVictim)
-			{
-				continue;  // Don't worry about self references.
-			}
+			continue;  // Don't worry about self references, or about objects that aren't in the current lists.
+		}
 
+		if (psReferrer->type == OBJ_STRUCTURE)
+		{
+			STRUCTURE *psStruct = (STRUCTURE *)psReferrer;
 			for (unsigned i = 0; i < psStruct->numWeaps; ++i)
 			{
 				ASSERT_OR_RETURN(false, psStruct->psTarget[i] != psVictim, BADREF(psStruct->targetFunc[i], psStruct->targetLine[i]));
 			}
 		}
-		for (DROID *psDroid = apsDroidLists[plr]; psDroid != nullptr; psDroid = psDroid->psNext)
+		else if (psReferrer->type == OBJ_DROID)
 		{
-			if (psDroid == psVictim)
-			{
-				continue;  // Don't worry about self references.
-			}
+			DROID *psDroid = (DROID *)psReferrer;
 
 			ASSERT_OR_RETURN(false, psDroid->order.psObj != psVictim, "Illegal reference to object %d", psVictim->id);
 
@@ -121,10 +124,7 @@ static bool checkReferences(BASE_OBJECT *psVictim)
 
 			for (unsigned i = 0; i < psDroid->numWeaps; ++i)
 			{
-				if (psDroid->psActionTarget[i] == psVictim)
-				{
-					ASSERT_OR_RETURN(false, psDroid->psActionTarget[i] != psVictim, BADREF(psDroid->actionTargetFunc[i], psDroid->actionTargetLine[i]));
-				}
+				ASSERT_OR_RETURN(false, psDroid->psActionTarget[i] != psVictim, BADREF(psDroid->actionTargetFunc[i], psDroid->actionTargetLine[i]));
 			}
 		}
 	}
@@ -741,11 +741,58 @@ void checkFactoryFlags()
 /**************************  OBJECT ACCESS FUNCTIONALITY ********************************/
 
 // Find a base object from it's id
+static void indexObjectList(BASE_OBJECT *psList)
+{
+	for (BASE_OBJECT *psObj = psList; psObj != nullptr; psObj = psObj->psNext)
+	{
+		objIdIndex.emplace(psObj->id, psObj);  // Keep the first match, like the list walks do
+		if (psObj->type == OBJ_DROID && isTransporter((DROID *)psObj) && ((DROID *)psObj)->psGroup != nullptr)
+		{
+			for (DROID *psTrans = ((DROID *)psObj)->psGroup->psList; psTrans != nullptr; psTrans = psTrans->psGrpNext)
+			{
+				objIdIndex.emplace(psTrans->id, psTrans);
+			}
+		}
+	}
+}
+
+void objmemBuildIdIndex()
+{
+	objIdIndex.clear();
+	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	{
+		indexObjectList(apsDroidLists[player]);
+		indexObjectList(apsStructLists[player]);
+		indexObjectList(mission.apsDroidLists[player]);
+		indexObjectList(mission.apsStructLists[player]);
+	}
+	indexObjectList(apsFeatureLists[0]);
+	indexObjectList(mission.apsFeatureLists[0]);
+	indexObjectList(apsLimboDroids[0]);
+	objIdIndexValid = true;
+}
+
+void objmemClearIdIndex()
+{
+	objIdIndex.clear();
+	objIdIndexValid = false;
+}
+
 BASE_OBJECT *getBaseObjFromData(unsigned id, unsigned player, OBJECT_TYPE type)
 {
 	BASE_OBJECT		*psObj;
 	DROID			*psTrans;
 
+	if (objIdIndexValid)
+	{
+		auto it = objIdIndex.find(id);
+		// Fall through to the list walk if the indexed object doesn't match, so that the result stays the same
+		if (it != objIdIndex.end() && it->second->type == type && (type == OBJ_FEATURE || it->second->player == player))
+		{
+			return it->second;
+		}
+	}
+
 	for (int i = 0; i < 3; ++i)
 	{
 		psObj = nullptr;
@@ -810,6 +857,15 @@ BASE_OBJECT *getBaseObjFromId(UDWORD id)
 	BASE_OBJECT		*psObj;
 	DROID			*psTrans;
 
+	if (objIdIndexValid)
+	{
+		auto it = objIdIndex.find(id);
+		if (it != objIdIndex.end())
+		{
+			return it->second;
+		}
+	}
+
 	for (i = 0; i < 7; ++i)
 	{
 		for (player = 0; player < MAX_PLAYERS; ++player)
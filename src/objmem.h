@@ -104,6 +104,12 @@ void freeAllFlagPositions();
 BASE_OBJECT *getBaseObjFromData(unsigned id, unsigned player, OBJECT_TYPE type);
 BASE_OBJECT *getBaseObjFromId(UDWORD id);
 
+/* Index every object (including transporter cargo) by id, so that getBaseObjFromData() and
+ * getBaseObjFromId() no longer walk all object lists. Only valid while no objects are created
+ * or destroyed, e.g. while restoring the object pointers of a savegame. */
+void objmemBuildIdIndex();
+void objmemClearIdIndex();
+
 UDWORD getRepairIdFromFlag(FLAG_POSITION *psFlag);
 
 void objCount(int *droids, int *structures, int *features);
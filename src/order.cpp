@@ -168,20 +168,24 @@ DROID *checkForRepairRange(DROID *psDroid)
 	unsigned bestDistanceSq = radius * radius;
 	DROID *best = nullptr;
 
-	for (BASE_OBJECT *object : gridStartIterate(psDroid->pos.x, psDroid->pos.y, radius))
+	for (BASE_OBJECT *object : gridStartIterateRepairable(psDroid->pos.x, psDroid->pos.y, radius))
 	{
+		DROID *droid = castDroid(object);
+		if (droid == nullptr ||  // Must be a droid.
+		    droid == psFailedTarget ||  // Must not have just failed to reach it.
+		    !aiCheckAlliances(psDroid->player, droid->player) ||  // Must be a friendly droid.
+		    !droidIsDamaged(droid))  // Must need repairing.
+		{
+			continue;
+		}
+
 		unsigned distanceSq = droidSqDist(psDroid, object);  // droidSqDist returns -1 if unreachable, (unsigned)-1 is a big number.
 		if (object == orderStateObj(psDroid, DORDER_GUARD))
 		{
 			distanceSq = 0;  // If guarding a unit — always do that first.
 		}
 
-		DROID *droid = castDroid(object);
-		if (droid != nullptr &&  // Must be a droid.
-		    droid != psFailedTarget &&   // Must not have just failed to reach it.
-		    distanceSq <= bestDistanceSq &&  // Must be as close as possible.
-		    aiCheckAlliances(psDroid->player, droid->player) &&  // Must be a friendly droid.
-		    droidIsDamaged(droid) &&  // Must need repairing.
+		if (distanceSq <= bestDistanceSq &&  // Must be as close as possible.
 		    visibleObject(psDroid, droid, false))  // Must be able to sense it.
 		{
 			bestDistanceSq = distanceSq;
@@ -209,16 +213,20 @@ static std::pair<STRUCTURE *, DROID_ACTION> checkForDamagedStruct(DROID *psDroid
 	unsigned bestDistanceSq = radius * radius;
 	std::pair<STRUCTURE *, DROID_ACTION> best = {nullptr, DACTION_NONE};
 
-	for (BASE_OBJECT *object : gridStartIterate(psDroid->pos.x, psDroid->pos.y, radius))
+	for (BASE_OBJECT *object : gridStartIterateRepairable(psDroid->pos.x, psDroid->pos.y, radius))
 	{
-		unsigned distanceSq = droidSqDist(psDroid, object);  // droidSqDist returns -1 if unreachable, (unsigned)-1 is a big number.
-
 		STRUCTURE *structure = castStructure(object);
 		if (structure == nullptr ||  // Must be a structure.
 		    structure == psFailedTarget ||  // Must not have just failed to reach it.
-		    distanceSq > bestDistanceSq ||  // Must be as close as possible.
-		    !visibleObject(psDroid, structure, false) ||  // Must be able to sense it.
 		    !aiCheckAlliances(psDroid->player, structure->player) ||  // Must be a friendly structure.
+		    !(structure->status == SS_BEING_BUILT || (structure->status == SS_BUILT && structIsDamaged(structure))))  // Must need building or repairing.
+		{
+			continue;
+		}
+
+		unsigned distanceSq = droidSqDist(psDroid, object);  // droidSqDist returns -1 if unreachable, (unsigned)-1 is a big number.
+		if (distanceSq > bestDistanceSq ||  // Must be as close as possible.
+		    !visibleObject(psDroid, structure, false) ||  // Must be able to sense it.
 		    checkDroidsDemolishing(structure))  // Must not be trying to get rid of it.
 		{
 			continue;
@@ -372,7 +380,7 @@ void orderUpdateDroid(DROID *psDroid)
 			missionMoveTransporterOffWorld(psDroid);
 
 			/* clear order */
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 		}
 		break;
 	case DORDER_TRANSPORTOUT:
@@ -400,7 +408,7 @@ void orderUpdateDroid(DROID *psDroid)
 					//the script can call startMission for this callback for offworld missions
 					triggerEvent(TRIGGER_TRANSPORTER_EXIT, psDroid);
 					/* clear order */
-					psDroid->order = DroidOrder(DORDER_NONE);
+					setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				}
 			}
 		}
@@ -410,7 +418,7 @@ void orderUpdateDroid(DROID *psDroid)
 		    (psDroid->sMove.Status == MOVEINACTIVE))
 		{
 			/* clear order */
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 
 //FFS! You only wan't to do this if the droid being tracked IS the transporter! Not all the time!
 // What about if your happily playing the game and tracking a droid, and re-enforcements come in!
@@ -447,13 +455,13 @@ void orderUpdateDroid(DROID *psDroid)
 		// Just wait for the action to finish then clear the order
 		if (psDroid->action == DACTION_NONE || psDroid->action == DACTION_ATTACK)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 		}
 		break;
 	case DORDER_RECOVER:
 		if (psDroid->order.psObj == nullptr)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 		}
 		else if (psDroid->action == DACTION_NONE)
 		{
@@ -555,7 +563,7 @@ void orderUpdateDroid(DROID *psDroid)
 				}
 				else
 				{
-					psDroid->order = DroidOrder(DORDER_NONE);
+					setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				}
 			}
 			else
@@ -666,7 +674,7 @@ void orderUpdateDroid(DROID *psDroid)
 	case DORDER_RESTORE:
 		if (psDroid->action == DACTION_NONE || psDroid->order.psObj == nullptr)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			actionDroid(psDroid, DACTION_NONE);
 			if (psDroid->player == selectedPlayer)
 			{
@@ -678,12 +686,12 @@ void orderUpdateDroid(DROID *psDroid)
 		if (psDroid->order.psObj == nullptr || psDroid->psActionTarget[0] == nullptr)
 		{
 			// arm pad destroyed find another
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			moveToRearm(psDroid);
 		}
 		else if (psDroid->action == DACTION_NONE)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 		}
 		break;
 	case DORDER_ATTACK:
@@ -696,13 +704,13 @@ void orderUpdateDroid(DROID *psDroid)
 			{
 				if (!orderDroidList(psDroid))
 				{
-					psDroid->order = DroidOrder(DORDER_NONE);
+					setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 					moveToRearm(psDroid);
 				}
 			}
 			else
 			{
-				psDroid->order = DroidOrder(DORDER_NONE);
+				setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				actionDroid(psDroid, DACTION_NONE);
 			}
 		}
@@ -738,7 +746,7 @@ void orderUpdateDroid(DROID *psDroid)
 				&& !actionInRange(psDroid, psDroid->order.psObj, 0))
 			{
 				// on hold orders give up
-				psDroid->order = DroidOrder(DORDER_NONE);
+				setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			}
 			else if (!isVtolDroid(psDroid) || allVtolsRearmed(psDroid))
 			{
@@ -750,13 +758,13 @@ void orderUpdateDroid(DROID *psDroid)
 		if (psDroid->action == DACTION_BUILD &&
 		    psDroid->order.psObj == nullptr)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			actionDroid(psDroid, DACTION_NONE);
 			objTrace(psDroid->id, "Clearing build order since build target is gone");
 		}
 		else if (psDroid->action == DACTION_NONE)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			objTrace(psDroid->id, "Clearing build order since build action is reset");
 		}
 		break;
@@ -767,7 +775,7 @@ void orderUpdateDroid(DROID *psDroid)
 
 			if (temp && temp->droidType == DROID_TRANSPORTER && !cyborgDroid(psDroid))
 			{
-				psDroid->order = DroidOrder(DORDER_NONE);
+				setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				actionDroid(psDroid, DACTION_NONE);
 				if (psDroid->player == selectedPlayer)
 				{
@@ -780,7 +788,7 @@ void orderUpdateDroid(DROID *psDroid)
 				// Wait for the action to finish then assign to Transporter (if not already flying)
 				if (psDroid->order.psObj == nullptr || transporterFlying((DROID *)psDroid->order.psObj))
 				{
-					psDroid->order = DroidOrder(DORDER_NONE);
+					setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 					actionDroid(psDroid, DACTION_NONE);
 				}
 				else if (abs((SDWORD)psDroid->pos.x - (SDWORD)psDroid->order.psObj->pos.x) < TILE_UNITS
@@ -795,7 +803,6 @@ void orderUpdateDroid(DROID *psDroid)
 					// order the droid to stop so moveUpdateDroid does not process this unit
 					orderDroid(psDroid, DORDER_STOP, ModeImmediate);
 					setDroidTarget(psDroid, nullptr);
-					psDroid->order.psObj = nullptr;
 					secondarySetState(psDroid, DSO_RETURN_TO_LOC, DSS_NONE);
 
 					/* We must add the droid to the transporter only *after*
@@ -825,7 +832,7 @@ void orderUpdateDroid(DROID *psDroid)
 				{
 					unloadTransporter(psDroid, psDroid->pos.x, psDroid->pos.y, false);
 					//reset the transporter's order
-					psDroid->order = DroidOrder(DORDER_NONE);
+					setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				}
 			}
 		}
@@ -834,7 +841,7 @@ void orderUpdateDroid(DROID *psDroid)
 		// Just wait for the action to finish then clear the order
 		if (psDroid->action == DACTION_NONE)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			secondarySetState(psDroid, DSO_RETURN_TO_LOC, DSS_NONE);
 		}
 		break;
@@ -843,7 +850,7 @@ void orderUpdateDroid(DROID *psDroid)
 		if (psDroid->order.psObj == nullptr)
 		{
 			// Our target got lost. Let's try again.
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			orderDroid(psDroid, DORDER_RTR, ModeImmediate);
 		}
 		else if (psDroid->action == DACTION_NONE)
@@ -882,7 +889,7 @@ void orderUpdateDroid(DROID *psDroid)
 			if (lb.count <= 1)
 			{
 				// finished all the structures - done
-				psDroid->order = DroidOrder(DORDER_NONE);
+				setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				break;
 			}
 
@@ -898,7 +905,7 @@ void orderUpdateDroid(DROID *psDroid)
 	case DORDER_FIRESUPPORT:
 		if (psDroid->order.psObj == nullptr)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			if (isVtolDroid(psDroid) && !vtolFull(psDroid))
 			{
 				moveToRearm(psDroid);
@@ -985,7 +992,7 @@ void orderUpdateDroid(DROID *psDroid)
 	case DORDER_RECYCLE:
 		if (psDroid->order.psObj == nullptr)
 		{
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			actionDroid(psDroid, DACTION_NONE);
 		}
 		else if (actionReachedBuildPos(psDroid, psDroid->order.psObj->pos.x, psDroid->order.psObj->pos.y, ((STRUCTURE *)psDroid->order.psObj)->rot.direction, ((STRUCTURE *)psDroid->order.psObj)->pStructureType))
@@ -1095,7 +1102,7 @@ void orderUpdateDroid(DROID *psDroid)
 	if (psDroid->order.type == DORDER_NONE && vtolRearming(psDroid)
 	    && (psDroid->psActionTarget[0] == nullptr || !psDroid->psActionTarget[0]->died))
 	{
-		psDroid->order = DroidOrder(DORDER_REARM, psDroid->psActionTarget[0]);
+		setDroidOrder(psDroid, DroidOrder(DORDER_REARM, psDroid->psActionTarget[0]));
 	}
 
 	if (psDroid->selected)
@@ -1298,12 +1305,12 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 	case DORDER_STOP:
 		// get the droid to stop doing whatever it is doing
 		actionDroid(psDroid, DACTION_NONE);
-		psDroid->order = DroidOrder(DORDER_NONE);
+		setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 		break;
 	case DORDER_HOLD:
 		// get the droid to stop doing whatever it is doing and temp hold
 		actionDroid(psDroid, DACTION_NONE);
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		break;
 	case DORDER_MOVE:
 	case DORDER_SCOUT:
@@ -1321,31 +1328,31 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 			break;
 		}
 		// move a droid to a location
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_MOVE, psOrder->pos.x, psOrder->pos.y);
 		break;
 	case DORDER_PATROL:
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		psDroid->order.pos2 = psDroid->pos.xy();
 		actionDroid(psDroid, DACTION_MOVE, psOrder->pos.x, psOrder->pos.y);
 		break;
 	case DORDER_RECOVER:
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_MOVE, psOrder->psObj->pos.x, psOrder->psObj->pos.y);
 		break;
 	case DORDER_TRANSPORTOUT:
 		// tell a (transporter) droid to leave home base for the offworld mission
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_TRANSPORTOUT, psOrder->pos.x, psOrder->pos.y);
 		break;
 	case DORDER_TRANSPORTRETURN:
 		// tell a (transporter) droid to return after unloading
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_TRANSPORTOUT, psOrder->pos.x, psOrder->pos.y);
 		break;
 	case DORDER_TRANSPORTIN:
 		// tell a (transporter) droid to fly onworld
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_TRANSPORTIN, psOrder->pos.x, psOrder->pos.y);
 		break;
 	case DORDER_ATTACK:
@@ -1370,7 +1377,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 			{
 				break;
 			}
-			psDroid->order = *psOrder;
+			setDroidOrder(psDroid, *psOrder);
 
 			if (isVtolDroid(psDroid)
 				|| actionInRange(psDroid, psOrder->psObj, 0)
@@ -1389,7 +1396,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		// build a new structure or line of structures
 		ASSERT_OR_RETURN(, isConstructionDroid(psDroid), "%s cannot construct things!", objInfo(psDroid));
 		ASSERT_OR_RETURN(, psOrder->psStats != nullptr, "invalid structure stats pointer");
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		ASSERT_OR_RETURN(, !psDroid->order.psStats || psDroid->order.psStats->type != REF_DEMOLISH, "Cannot build demolition");
 		actionDroid(psDroid, DACTION_BUILD, psOrder->pos.x, psOrder->pos.y);
 		objTrace(psDroid->id, "Starting new construction effort of %s", psOrder->psStats ? getStatsName(psOrder->psStats) : "NULL");
@@ -1400,7 +1407,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		{
 			break;
 		}
-		psDroid->order = DroidOrder(DORDER_BUILD, getModuleStat((STRUCTURE *)psOrder->psObj), psOrder->psObj->pos.xy(), 0);
+		setDroidOrder(psDroid, DroidOrder(DORDER_BUILD, getModuleStat((STRUCTURE *)psOrder->psObj), psOrder->psObj->pos.xy(), 0));
 		ASSERT_OR_RETURN(, psDroid->order.psStats != nullptr, "should have found a module stats");
 		ASSERT_OR_RETURN(, !psDroid->order.psStats || psDroid->order.psStats->type != REF_DEMOLISH, "Cannot build demolition");
 		actionDroid(psDroid, DACTION_BUILD, psOrder->psObj->pos.x, psOrder->psObj->pos.y);
@@ -1410,7 +1417,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		// help to build a structure that is starting to be built
 		ASSERT_OR_RETURN(, isConstructionDroid(psDroid), "Not a constructor droid");
 		ASSERT_OR_RETURN(, psOrder->psObj != nullptr, "Help to build a NULL pointer?");
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		psDroid->order.pos = psOrder->psObj->pos.xy();
 		psDroid->order.psStats = ((STRUCTURE *)psOrder->psObj)->pStructureType;
 		ASSERT_OR_RETURN(,!psDroid->order.psStats || psDroid->order.psStats->type != REF_DEMOLISH, "Cannot build demolition");
@@ -1422,7 +1429,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		{
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		psDroid->order.pos = psOrder->psObj->pos.xy();
 		actionDroid(psDroid, DACTION_DEMOLISH, psOrder->psObj);
 		break;
@@ -1431,7 +1438,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		{
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		psDroid->order.pos = psOrder->psObj->pos.xy();
 		actionDroid(psDroid, DACTION_REPAIR, psOrder->psObj);
 		break;
@@ -1440,26 +1447,26 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		{
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_DROIDREPAIR, psOrder->psObj);
 		break;
 	case DORDER_OBSERVE:
 		// keep an object within sensor view
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_OBSERVE, psOrder->psObj);
 		break;
 	case DORDER_FIRESUPPORT:
 		if (isTransporter(psDroid))
 		{
 			debug(LOG_ERROR, "Sorry, transports cannot be assigned to commanders.");
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			break;
 		}
 		if (psDroid->asWeaps[0].nStat == 0)
 		{
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		// let the order update deal with vtol droids
 		if (!isVtolDroid(psDroid))
 		{
@@ -1475,7 +1482,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		if (isTransporter(psDroid))
 		{
 			debug(LOG_ERROR, "Sorry, transports cannot be assigned to commanders.");
-			psDroid->order = DroidOrder(DORDER_NONE);
+			setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			break;
 		}
 		ASSERT_OR_RETURN(, psOrder->psObj != nullptr, "Can't command a NULL");
@@ -1492,7 +1499,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 			{
 				Vector2i pos = psStruct->pos.xy();
 
-				psDroid->order = *psOrder;
+				setDroidOrder(psDroid, *psOrder);
 				// Find a place to land for vtols. And Transporters in a multiPlay game.
 				if (isVtolDroid(psDroid) || (game.type == LEVEL_TYPE::SKIRMISH && isTransporter(psDroid)))
 				{
@@ -1511,14 +1518,14 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 
 			if (iDX && iDY)
 			{
-				psDroid->order = *psOrder;
+				setDroidOrder(psDroid, *psOrder);
 				actionDroid(psDroid, DACTION_MOVE, iDX, iDY);
 			}
 			else
 			{
 				// haven't got an LZ set up so don't do anything
 				actionDroid(psDroid, DACTION_NONE);
-				psDroid->order = DroidOrder(DORDER_NONE);
+				setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 			}
 		}
 		break;
@@ -1574,7 +1581,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		if (psRepairFac != nullptr)
 		{
 			/* move to front of structure */
-			psDroid->order = DroidOrder(psOrder->type, psRepairFac);
+			setDroidOrder(psDroid, DroidOrder(psOrder->type, psRepairFac));
 			psDroid->order.pos = psRepairFac->pos.xy();
 			/* If in multiPlayer, and the Transporter has been sent to be
 				* repaired, need to find a suitable location to drop down. */
@@ -1609,11 +1616,11 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 			    || embarkee == nullptr || !isTransporter(embarkee))  // nor can a transporter load another transporter
 			{
 				debug(LOG_ERROR, "Sorry, can only load things that aren't transporters into things that are.");
-				psDroid->order = DroidOrder(DORDER_NONE);
+				setDroidOrder(psDroid, DroidOrder(DORDER_NONE));
 				break;
 			}
 			// move the droid to the transporter location
-			psDroid->order = *psOrder;
+			setDroidOrder(psDroid, *psOrder);
 			psDroid->order.pos = psOrder->psObj->pos.xy();
 			actionDroid(psDroid, DACTION_MOVE, psOrder->psObj->pos.x, psOrder->psObj->pos.y);
 			break;
@@ -1625,7 +1632,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 			//this order can only be given to Transporter droids
 			if (isTransporter(psDroid))
 			{
-				psDroid->order = *psOrder;
+				setDroidOrder(psDroid, *psOrder);
 				//move the Transporter to the requested location
 				actionDroid(psDroid, DACTION_MOVE, psOrder->pos.x, psOrder->pos.y);
 				//close the Transporter interface - if up
@@ -1661,14 +1668,14 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		if (psFactory != nullptr)
 		{
 			/* move to front of structure */
-			psDroid->order = DroidOrder(psOrder->type, psFactory);
+			setDroidOrder(psDroid, DroidOrder(psOrder->type, psFactory));
 			psDroid->order.pos = psFactory->pos.xy();
 			setDroidTarget(psDroid,  psFactory);
 			actionDroid(psDroid, DACTION_MOVE, psFactory, psDroid->order.pos.x, psDroid->order.pos.y);
 		}
 		break;
 	case DORDER_GUARD:
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		if (psOrder->psObj != nullptr)
 		{
 			psDroid->order.pos = psOrder->psObj->pos.xy();
@@ -1685,7 +1692,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 			ASSERT(false, "orderDroidBase: invalid object type for Restore order");
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		psDroid->order.pos = psOrder->psObj->pos.xy();
 		actionDroid(psDroid, DACTION_RESTORE, psOrder->psObj);
 		break;
@@ -1695,7 +1702,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		{
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_MOVETOREARM, psOrder->psObj);
 		assignVTOLPad(psDroid, (STRUCTURE *)psOrder->psObj);
 		break;
@@ -1704,7 +1711,7 @@ void orderDroidBase(DROID *psDroid, DROID_ORDER_DATA *psOrder)
 		{
 			break;
 		}
-		psDroid->order = *psOrder;
+		setDroidOrder(psDroid, *psOrder);
 		actionDroid(psDroid, DACTION_MOVE, psOrder->pos.x, psOrder->pos.y);
 		break;
 	default:
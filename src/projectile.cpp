@@ -1108,7 +1108,7 @@ static void proj_ImpactFunc(PROJECTILE *psObj)
 					break;
 
 				case OBJ_STRUCTURE:
-					((STRUCTURE *) psObj->psSource)->psTarget[0] = nullptr;
+					setStructureTarget((STRUCTURE *)psObj->psSource, nullptr, 0, ((STRUCTURE *)psObj->psSource)->asWeaps[0].origin);
 					break;
 
 				// This is only here to prevent the compiler from producing
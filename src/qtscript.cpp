@@ -709,6 +709,16 @@ bool saveScriptStates(const char *filename)
 	return scripting_engine::instance().saveScriptStates(filename);
 }
 
+nlohmann::json getScriptGlobals()
+{
+	nlohmann::json result = nlohmann::json::object();
+	for (auto &it : scripting_engine::instance().debug_GetGlobalsSnapshot())
+	{
+		result[it.first->scriptName() + "/" + std::to_string(it.first->player())] = std::move(it.second);
+	}
+	return result;
+}
+
 bool scripting_engine::saveScriptStates(const char *filename)
 {
 	WzConfig ini(filename, WzConfig::ReadAndWrite);
@@ -111,6 +111,9 @@ wzapi::scripting_instance* loadPlayerScript(const WzString& path, int player, AI
 bool loadScriptStates(const char *filename);
 bool saveScriptStates(const char *filename);
 
+/// Globals of all script instances, keyed by "<script name>/<player>"
+nlohmann::json getScriptGlobals();
+
 /// Tell script system that an object has been removed.
 void scriptRemoveObject(const BASE_OBJECT *psObj);
 
@@ -536,6 +539,7 @@ public:
 
 protected:
 	friend void jsShowDebug();
+	friend nlohmann::json getScriptGlobals();
 
 	std::unordered_map<wzapi::scripting_instance *, nlohmann::json> debug_GetGlobalsSnapshot() const;
 	std::vector<scripting_engine::timerNodeSnapshot> debug_GetTimersSnapshot() const;
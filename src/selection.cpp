@@ -28,6 +28,7 @@
 #include "lib/framework/frame.h"
 #include "lib/framework/math_ext.h"
 #include "lib/framework/strres.h"
+#include "lib/ivis_opengl/pieclip.h"
 
 #include "objects.h"
 #include "basedef.h"
@@ -44,32 +45,52 @@
 #include "display.h"
 #include "qtscript.h"
 #include <algorithm>
+#include <array>
 #include <functional>
+#include <set>
 #include <vector>
 
-// stores combinations of unit components
-static std::vector<std::vector<uint32_t> > combinations;
+// the component stats of a unit, as compared when selecting all units of the same design
+typedef std::array<uint32_t, DROID_MAXCOMP + 2> Combination;
+
+// Finds the units of the player that may be selected. Units on screen are looked up
+// in the screen areas they were drawn in, instead of checking every unit of the player.
+static void selCandidates(unsigned player, bool onlyOnScreen, std::vector<DROID *> &candidates)
+{
+	if (!onlyOnScreen)
+	{
+		candidates.clear();
+		for (DROID *psDroid = apsDroidLists[player]; psDroid != nullptr; psDroid = psDroid->psNext)
+		{
+			candidates.push_back(psDroid);
+		}
+		return;
+	}
+
+	pickIndexDroidsIn(0, 0, pie_GetVideoBufferWidth() - 1, pie_GetVideoBufferHeight() - 1, candidates);
+	candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [player](DROID *psDroid) {
+		return psDroid->player != player || !objectOnScreen(psDroid, 0);
+	}), candidates.end());
+}
 
 template <typename T>
 static unsigned selSelectUnitsIf(unsigned player, T condition, bool onlyOnScreen)
 {
+	static std::vector<DROID *> candidates;
 	unsigned count = 0;
 
 	selDroidDeselect(player);
 
-	// Go through all.
-	for (DROID *psDroid = apsDroidLists[player]; psDroid != nullptr; psDroid = psDroid->psNext)
+	selCandidates(player, onlyOnScreen, candidates);
+	for (DROID *psDroid : candidates)
 	{
-		bool shouldSelect = (!onlyOnScreen || objectOnScreen(psDroid, 0)) &&
-		                    condition(psDroid);
-		count += shouldSelect;
-		if (shouldSelect && !psDroid->selected && !psDroid->flags.test(OBJECT_FLAG_UNSELECTABLE))
+		if (condition(psDroid))
 		{
-			SelectDroid(psDroid);
-		}
-		else if (!shouldSelect && psDroid->selected)
-		{
-			DeSelectDroid(psDroid);
+			count++;
+			if (!psDroid->flags.test(OBJECT_FLAG_UNSELECTABLE))
+			{
+				SelectDroid(psDroid);
+			}
 		}
 	}
 
@@ -160,101 +181,55 @@ unsigned int selNumSelected(unsigned int player)
 	return count;
 }
 
-// Helper function to check whether the component stats of a unit can be found
-// in the combinations vector and, optionally, to add them to it if not
-static bool componentsInCombinations(DROID *psDroid, bool add)
+// Helper function to get the component stats of a unit
+static Combination droidCombination(DROID *psDroid)
 {
-	std::vector<uint32_t> components;
-	uint32_t stat = 0;
-
-	// stats are sorted by their estimated usefulness to distinguish units:
-	// * the first weapon turret is the most common difference between them
-	//   followed by propulsions and bodies
-	// * the second weapon turret is least important because Hydras are rare
-	for (int c = 0; c < DROID_MAXCOMP + 2; c++)
-	{
-		switch(c)
-		{
-			case 0: stat = psDroid->asWeaps[1].nStat; break;
-			case 1: stat = psDroid->asBits[COMP_ECM]; break;
-			case 2: stat = psDroid->asBits[COMP_BRAIN]; break;
-			case 3: stat = psDroid->asBits[COMP_SENSOR]; break;
-			case 4: stat = psDroid->asBits[COMP_REPAIRUNIT]; break;
-			case 5: stat = psDroid->asBits[COMP_CONSTRUCT]; break;
-			case 6: stat = psDroid->asBits[COMP_BODY]; break;
-			case 7: stat = psDroid->asBits[COMP_PROPULSION]; break;
-			case 8: stat = psDroid->asWeaps[0].nStat; break;
-		}
-
-		// keep the list of components short by not adding stats with
-		// the value 0 to its end, since they are redundant
-		if (!(stat == 0 && components.empty()))
-		{
-			components.push_back(stat);
-		}
-	}
-	auto it = std::find(combinations.begin(), combinations.end(), components);
-	if (it != combinations.end())
-	{
-		return true;
-	}
-	else
-	{
-		// add the list of components to the list of combinations unless
-		// this would result in a duplicate entry
-		if (add)
-		{
-			combinations.push_back(components);
-		}
-		return false;
-	}
+	return Combination{{
+		psDroid->asWeaps[0].nStat,
+		psDroid->asWeaps[1].nStat,
+		psDroid->asBits[COMP_ECM],
+		psDroid->asBits[COMP_BRAIN],
+		psDroid->asBits[COMP_SENSOR],
+		psDroid->asBits[COMP_REPAIRUNIT],
+		psDroid->asBits[COMP_CONSTRUCT],
+		psDroid->asBits[COMP_BODY],
+		psDroid->asBits[COMP_PROPULSION],
+	}};
 }
 
 // Selects all units with the same propulsion, body and turret(s) as the one(s) selected
 static unsigned int selSelectAllSame(unsigned int player, bool bOnScreen)
 {
-	unsigned int i = 0, selected = 0;
-	std::vector<unsigned int> excluded;
-
-	combinations.clear();
+	static std::vector<DROID *> candidates;
+	std::set<Combination> combinations;
+	std::vector<DROID *> unselected;
+	unsigned int selected = 0;
 
 	// find out which units will need to be compared to which component combinations
-	for (DROID *psDroid = apsDroidLists[player]; psDroid; psDroid = psDroid->psNext)
+	selCandidates(player, bOnScreen, candidates);
+	for (DROID *psDroid : candidates)
 	{
-		if (bOnScreen && !objectOnScreen(psDroid, 0))
+		if (psDroid->selected)
 		{
-			excluded.push_back(i);
+			selected++;
+			combinations.insert(droidCombination(psDroid));
 		}
-		else if (psDroid->selected)
+		else
 		{
-			excluded.push_back(i);
-			selected++;
-
-			componentsInCombinations(psDroid, true);
+			unselected.push_back(psDroid);
 		}
-		i++;
 	}
 
 	// if all or no units are selected, no more units can be chosen
-	if (!excluded.empty() && i != selected)
+	if (!combinations.empty())
 	{
-		// reset unit counter
-		i = 0;
-		for (DROID *psDroid = apsDroidLists[player]; psDroid; psDroid = psDroid->psNext)
+		for (DROID *psDroid : unselected)
 		{
-			if (excluded.empty() || *excluded.begin() != i)
+			if (combinations.count(droidCombination(psDroid)) != 0)
 			{
-				if (componentsInCombinations(psDroid, false))
-				{
-					SelectDroid(psDroid);
-					selected++;
-				}
+				SelectDroid(psDroid);
+				selected++;
 			}
-			else
-			{
-				excluded.erase(excluded.begin());
-			}
-			i++;
 		}
 	}
 	return selected;
@@ -493,59 +468,47 @@ void selNextSpecifiedBuilding(STRUCTURE_TYPE structType, bool jump)
 }
 
 // ---------------------------------------------------------------------
-// see if a commander is the n'th command droid
-static bool droidIsCommanderNum(DROID *psDroid, SDWORD n)
+// select the n'th command droid, commanders are numbered in the order they were built
+void selCommander(int n)
 {
-	if (psDroid->droidType != DROID_COMMAND)
+	std::vector<DROID *> commanders;
+	for (DROID *psCurr = apsDroidLists[selectedPlayer]; psCurr; psCurr = psCurr->psNext)
 	{
-		return false;
+		if (psCurr->droidType == DROID_COMMAND)
+		{
+			commanders.push_back(psCurr);
+		}
+	}
+	if (n < 1 || (size_t)n > commanders.size())
+	{
+		return;
 	}
+	std::nth_element(commanders.begin(), commanders.begin() + (n - 1), commanders.end(), [](DROID *a, DROID *b) { return a->id < b->id; });
+	DROID *psCurr = commanders[n - 1];
 
-	int numLess = 0;
-	for (DROID *psCurr = apsDroidLists[psDroid->player]; psCurr; psCurr = psCurr->psNext)
+	if (!psCurr->selected && !psCurr->flags.test(OBJECT_FLAG_UNSELECTABLE))
 	{
-		if ((psCurr->droidType == DROID_COMMAND) && (psCurr->id < psDroid->id))
-		{
-			numLess++;
-		}
+		clearSelection();
+		psCurr->selected = true;
 	}
+	else if (!psCurr->flags.test(OBJECT_FLAG_UNSELECTABLE))
+	{
+		clearSelection();
+		psCurr->selected = true;
 
-	return (numLess == (n - 1));
-}
+		// this horrible bit of code is taken from activateGroupAndMove
+		// and sets the camera position to that of the commander
 
-// select the n'th command droid
-void selCommander(int n)
-{
-	for (DROID *psCurr = apsDroidLists[selectedPlayer]; psCurr; psCurr = psCurr->psNext)
-	{
-		if (droidIsCommanderNum(psCurr, n))
+		if (getWarCamStatus())
 		{
-			if (!psCurr->selected && !psCurr->flags.test(OBJECT_FLAG_UNSELECTABLE))
-			{
-				clearSelection();
-				psCurr->selected = true;
-			}
-			else if (!psCurr->flags.test(OBJECT_FLAG_UNSELECTABLE))
-			{
-				clearSelection();
-				psCurr->selected = true;
-
-				// this horrible bit of code is taken from activateGroupAndMove
-				// and sets the camera position to that of the commander
-
-				if (getWarCamStatus())
-				{
-					camToggleStatus(); // messy - fix this
-					processWarCam(); // odd, but necessary
-					camToggleStatus(); // messy - FIXME
-				}
-				else
-				{
-					/* Centre display on him if warcam isn't active */
-					setViewPos(map_coord(psCurr->pos.x), map_coord(psCurr->pos.y), true);
-				}
-			}
-			return;
+			camToggleStatus(); // messy - fix this
+			processWarCam(); // odd, but necessary
+			camToggleStatus(); // messy - FIXME
+		}
+		else
+		{
+			/* Centre display on him if warcam isn't active */
+			setViewPos(map_coord(psCurr->pos.x), map_coord(psCurr->pos.y), true);
 		}
 	}
 }
@@ -0,0 +1,525 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2020  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file snapshot.cpp
+ *  Immutable captures of the synchronised game state.
+ */
+
+#include "snapshot.h"
+
+#include "lib/framework/crc.h"
+#include "lib/framework/physfs_ext.h"
+#include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/netplay/netplay.h"
+
+#include "map.h"
+#include "mission.h"
+#include "objmem.h"
+#include "power.h"
+#include "qtscript.h"
+#include "research.h"
+
+#include <algorithm>
+#include <deque>
+
+#define SNAPSHOT_HISTORY_LENGTH 20  // Ticks of history kept for desynch diagnostics
+
+static std::deque<std::shared_ptr<const WorldSnapshot>> snapshotHistory;
+static uint32_t lastDesynchDumpTime = 0;
+
+struct SnapshotWriteRequest
+{
+	std::shared_ptr<const WorldSnapshot> snapshot;
+	std::string fileName;
+};
+
+/// Snapshots are written one at a time by a single writer thread, started with the first one.
+static wz::mutex snapshotWriterMutex;
+static std::deque<SnapshotWriteRequest> snapshotWriteQueue;
+static WZ_THREAD *snapshotWriterThread = nullptr;
+static WZ_SEMAPHORE *snapshotWriterSemaphore = nullptr;  ///< Posted for each queued snapshot, and when shutting down
+static bool snapshotWritersShutDown = false;
+
+bool SnapshotObject::operator ==(SnapshotObject const &b) const
+{
+	return id == b.id && type == b.type && player == b.player && pos == b.pos
+	       && rot.direction == b.rot.direction && rot.pitch == b.rot.pitch && rot.roll == b.rot.roll
+	       && body == b.body && experience == b.experience && secondaryOrder == b.secondaryOrder
+	       && order == b.order && action == b.action && orderTargetId == b.orderTargetId
+	       && actionTargetId == b.actionTargetId && buildPoints == b.buildPoints;
+}
+
+bool SnapshotTile::operator ==(SnapshotTile const &b) const
+{
+	return height == b.height && texture == b.texture && tileInfoBits == b.tileInfoBits
+	       && fireEndTime == b.fireEndTime && tileExploredBits == b.tileExploredBits;
+}
+
+static bool operator ==(PLAYER_RESEARCH const &a, PLAYER_RESEARCH const &b)
+{
+	return a.currentPoints == b.currentPoints && a.ResearchStatus == b.ResearchStatus && a.possible == b.possible;
+}
+
+static uint32_t objectId(BASE_OBJECT const *psObj)
+{
+	return psObj != nullptr ? psObj->id : 0;
+}
+
+static SnapshotObject snapshotObject(BASE_OBJECT const *psObj)
+{
+	SnapshotObject object;
+	object.id = psObj->id;
+	object.type = psObj->type;
+	object.player = psObj->player;
+	object.pos = psObj->pos;
+	object.rot = psObj->rot;
+	object.body = psObj->body;
+	object.experience = 0;
+	object.secondaryOrder = 0;
+	object.order = 0;
+	object.action = 0;
+	object.orderTargetId = 0;
+	object.actionTargetId = 0;
+	object.buildPoints = 0;
+	switch (psObj->type)
+	{
+	case OBJ_DROID:
+		{
+			DROID const *psDroid = (DROID const *)psObj;
+			object.experience = psDroid->experience;
+			object.secondaryOrder = psDroid->secondaryOrder;
+			object.order = psDroid->order.type;
+			object.action = psDroid->action;
+			object.orderTargetId = objectId(psDroid->order.psObj);
+			object.actionTargetId = objectId(psDroid->psActionTarget[0]);
+			break;
+		}
+	case OBJ_STRUCTURE:
+		{
+			STRUCTURE const *psStruct = (STRUCTURE const *)psObj;
+			object.order = psStruct->status;
+			object.orderTargetId = objectId(psStruct->psTarget[0]);
+			object.buildPoints = psStruct->currentBuildPts;
+			break;
+		}
+	default:
+		break;
+	}
+	return object;
+}
+
+static void collectObjects(std::vector<BASE_OBJECT const *> &objects, BASE_OBJECT const *psList)
+{
+	for (BASE_OBJECT const *psObj = psList; psObj != nullptr; psObj = psObj->psNext)
+	{
+		if (!isDead(psObj))
+		{
+			objects.push_back(psObj);
+		}
+	}
+}
+
+static void snapshotObjects(WorldSnapshot &snapshot, WorldSnapshot const *psPrevious)
+{
+	std::vector<BASE_OBJECT const *> objects;
+	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	{
+		collectObjects(objects, apsDroidLists[player]);
+		collectObjects(objects, apsStructLists[player]);
+		collectObjects(objects, mission.apsDroidLists[player]);
+		collectObjects(objects, mission.apsStructLists[player]);
+	}
+	collectObjects(objects, apsFeatureLists[0]);
+	collectObjects(objects, mission.apsFeatureLists[0]);
+	std::sort(objects.begin(), objects.end(), [](BASE_OBJECT const *a, BASE_OBJECT const *b) { return a->id < b->id; });
+
+	// Both lists are sorted by id, so unchanged objects are found by walking them side by side
+	size_t previousIndex = 0;
+	snapshot.objects.reserve(objects.size());
+	for (BASE_OBJECT const *psObj : objects)
+	{
+		SnapshotObject object = snapshotObject(psObj);
+		if (psPrevious != nullptr)
+		{
+			while (previousIndex < psPrevious->objects.size() && psPrevious->objects[previousIndex]->id < object.id)
+			{
+				++previousIndex;
+			}
+			if (previousIndex < psPrevious->objects.size() && *psPrevious->objects[previousIndex] == object)
+			{
+				snapshot.objects.push_back(psPrevious->objects[previousIndex]);
+				continue;
+			}
+		}
+		snapshot.objects.push_back(std::make_shared<const SnapshotObject>(object));
+	}
+}
+
+static SnapshotTile snapshotTile(MAPTILE const &tile)
+{
+	SnapshotTile result;
+	result.height = tile.height;
+	result.texture = tile.texture;
+	result.tileInfoBits = tile.tileInfoBits;
+	result.fireEndTime = tile.fireEndTime;
+	result.tileExploredBits = tile.tileExploredBits;
+	return result;
+}
+
+static void snapshotTiles(WorldSnapshot &snapshot, WorldSnapshot const *psPrevious)
+{
+	const int blockSize = WorldSnapshot::TILE_BLOCK_SIZE;
+	const int blocksX = (mapWidth + blockSize - 1) / blockSize;
+	const int blocksY = (mapHeight + blockSize - 1) / blockSize;
+	const bool samePreviousMap = psPrevious != nullptr && psPrevious->mapWidth == mapWidth && psPrevious->mapHeight == mapHeight;
+
+	snapshot.mapWidth = mapWidth;
+	snapshot.mapHeight = mapHeight;
+	snapshot.tileBlocks.reserve(blocksX * blocksY);
+	for (int blockY = 0; blockY < blocksY; ++blockY)
+	{
+		for (int blockX = 0; blockX < blocksX; ++blockX)
+		{
+			const int x0 = blockX * blockSize, x1 = std::min(x0 + blockSize, mapWidth);
+			const int y0 = blockY * blockSize, y1 = std::min(y0 + blockSize, mapHeight);
+			const size_t blockIndex = blockY * blocksX + blockX;
+
+			// Compare in place first, so unchanged blocks cost no allocation
+			if (samePreviousMap)
+			{
+				WorldSnapshot::TileBlock const &previousBlock = *psPrevious->tileBlocks[blockIndex];
+				bool unchanged = true;
+				for (int y = y0; y < y1 && unchanged; ++y)
+				{
+					for (int x = x0; x < x1 && unchanged; ++x)
+					{
+						unchanged = previousBlock[(y - y0) * (x1 - x0) + (x - x0)] == snapshotTile(psMapTiles[y * mapWidth + x]);
+					}
+				}
+				if (unchanged)
+				{
+					snapshot.tileBlocks.push_back(psPrevious->tileBlocks[blockIndex]);
+					continue;
+				}
+			}
+
+			std::shared_ptr<WorldSnapshot::TileBlock> block = std::make_shared<WorldSnapshot::TileBlock>();
+			block->reserve((x1 - x0) * (y1 - y0));
+			for (int y = y0; y < y1; ++y)
+			{
+				for (int x = x0; x < x1; ++x)
+				{
+					block->push_back(snapshotTile(psMapTiles[y * mapWidth + x]));
+				}
+			}
+			snapshot.tileBlocks.push_back(std::move(block));
+		}
+	}
+}
+
+static void snapshotPlayers(WorldSnapshot &snapshot, WorldSnapshot const *psPrevious)
+{
+	snapshot.power.resize(MAX_PLAYERS);
+	snapshot.research.resize(MAX_PLAYERS);
+	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	{
+		snapshot.power[player] = getPrecisePower(player);
+
+		std::vector<PLAYER_RESEARCH> const &resList = asPlayerResList[player];
+		if (psPrevious != nullptr && psPrevious->research.size() == MAX_PLAYERS && *psPrevious->research[player] == resList)
+		{
+			snapshot.research[player] = psPrevious->research[player];
+		}
+		else
+		{
+			snapshot.research[player] = std::make_shared<const WorldSnapshot::ResearchList>(resList);
+		}
+	}
+}
+
+std::shared_ptr<const WorldSnapshot> takeWorldSnapshot(WorldSnapshot const *psPrevious, bool includeScriptGlobals)
+{
+	std::shared_ptr<WorldSnapshot> snapshot = std::make_shared<WorldSnapshot>();
+	snapshot->gameTime = gameTime;
+	snapshotObjects(*snapshot, psPrevious);
+	if (psMapTiles != nullptr)
+	{
+		snapshotTiles(*snapshot, psPrevious);
+	}
+	snapshotPlayers(*snapshot, psPrevious);
+	if (includeScriptGlobals)
+	{
+		snapshot->scriptGlobals = std::make_shared<const nlohmann::json>(getScriptGlobals());
+	}
+	else if (psPrevious != nullptr)
+	{
+		snapshot->scriptGlobals = psPrevious->scriptGlobals;
+	}
+	return snapshot;
+}
+
+uint32_t WorldSnapshot::checksum() const
+{
+	uint32_t crc = crcSum(0, &gameTime, sizeof(gameTime));
+	for (auto const &object : objects)
+	{
+		int32_t values[] = {(int32_t)object->id, object->type, object->player, object->pos.x, object->pos.y, object->pos.z,
+		                    object->rot.direction, object->rot.pitch, object->rot.roll, (int32_t)object->body, (int32_t)object->experience,
+		                    (int32_t)object->secondaryOrder, object->order, object->action, (int32_t)object->orderTargetId,
+		                    (int32_t)object->actionTargetId, (int32_t)object->buildPoints};
+		crc = crcSum(crc, values, sizeof(values));
+	}
+	for (auto const &block : tileBlocks)
+	{
+		for (SnapshotTile const &tile : *block)
+		{
+			int32_t values[] = {tile.height, tile.texture, tile.tileInfoBits, tile.fireEndTime, (int32_t)tile.tileExploredBits};
+			crc = crcSum(crc, values, sizeof(values));
+		}
+	}
+	if (!power.empty())
+	{
+		crc = crcSum(crc, power.data(), power.size() * sizeof(power[0]));
+	}
+	for (auto const &resList : research)
+	{
+		for (PLAYER_RESEARCH const &res : *resList)
+		{
+			uint32_t values[] = {res.currentPoints, res.ResearchStatus, res.possible};
+			crc = crcSum(crc, values, sizeof(values));
+		}
+	}
+	return crc;
+}
+
+nlohmann::json WorldSnapshot::toJson() const
+{
+	nlohmann::json result = nlohmann::json::object();
+	result["gameTime"] = gameTime;
+	result["checksum"] = checksum();
+
+	nlohmann::json jsonObjects = nlohmann::json::array();
+	for (auto const &object : objects)
+	{
+		jsonObjects.push_back({
+			{"id", object->id}, {"type", object->type}, {"player", object->player},
+			{"position", {object->pos.x, object->pos.y, object->pos.z}},
+			{"rotation", {object->rot.direction, object->rot.pitch, object->rot.roll}},
+			{"body", object->body}, {"experience", object->experience}, {"secondaryOrder", object->secondaryOrder},
+			{"order", object->order}, {"action", object->action},
+			{"orderTarget", object->orderTargetId}, {"actionTarget", object->actionTargetId},
+			{"buildPoints", object->buildPoints}
+		});
+	}
+	result["objects"] = std::move(jsonObjects);
+
+	nlohmann::json heights = nlohmann::json::array();
+	nlohmann::json textures = nlohmann::json::array();
+	const int blockSize = TILE_BLOCK_SIZE;
+	const int blocksX = (mapWidth + blockSize - 1) / blockSize;
+	for (int y = 0; y < mapHeight; ++y)
+	{
+		for (int x = 0; x < mapWidth; ++x)
+		{
+			const int x0 = (x / blockSize) * blockSize, x1 = std::min(x0 + blockSize, mapWidth);
+			const int y0 = (y / blockSize) * blockSize;
+			SnapshotTile const &tile = (*tileBlocks[(y / blockSize) * blocksX + x / blockSize])[(y - y0) * (x1 - x0) + (x - x0)];
+			heights.push_back(tile.height);
+			textures.push_back(tile.texture);
+		}
+	}
+	result["map"] = {{"width", mapWidth}, {"height", mapHeight}, {"heights", std::move(heights)}, {"textures", std::move(textures)}};
+
+	nlohmann::json players = nlohmann::json::array();
+	for (size_t player = 0; player < power.size(); ++player)
+	{
+		nlohmann::json completed = nlohmann::json::array();
+		for (size_t i = 0; i < research[player]->size(); ++i)
+		{
+			if ((*research[player])[i].ResearchStatus & RESEARCHED)
+			{
+				completed.push_back(i);
+			}
+		}
+		players.push_back({{"power", power[player]}, {"researched", std::move(completed)}});
+	}
+	result["players"] = std::move(players);
+	if (scriptGlobals != nullptr)
+	{
+		result["scriptGlobals"] = *scriptGlobals;
+	}
+	return result;
+}
+
+std::vector<uint32_t> diffWorldSnapshots(WorldSnapshot const &a, WorldSnapshot const &b)
+{
+	std::vector<uint32_t> changed;
+	size_t i = 0, j = 0;
+	while (i < a.objects.size() || j < b.objects.size())
+	{
+		if (j == b.objects.size() || (i < a.objects.size() && a.objects[i]->id < b.objects[j]->id))
+		{
+			changed.push_back(a.objects[i++]->id);
+		}
+		else if (i == a.objects.size() || b.objects[j]->id < a.objects[i]->id)
+		{
+			changed.push_back(b.objects[j++]->id);
+		}
+		else
+		{
+			// Shared records can't differ, so only compare the ones that were copied
+			if (a.objects[i] != b.objects[j] && *a.objects[i] != *b.objects[j])
+			{
+				changed.push_back(a.objects[i]->id);
+			}
+			++i;
+			++j;
+		}
+	}
+	return changed;
+}
+
+static void writeWorldSnapshot(SnapshotWriteRequest const &request)
+{
+	std::string jsonString = request.snapshot->toJson().dump(1);
+	PHYSFS_file *fileHandle = PHYSFS_openWrite(request.fileName.c_str());
+	if (fileHandle == nullptr)
+	{
+		debug(LOG_ERROR, "Could not write %s: %s", request.fileName.c_str(), WZ_PHYSFS_getLastError());
+		return;
+	}
+	WZ_PHYSFS_writeBytes(fileHandle, jsonString.data(), static_cast<PHYSFS_uint32>(jsonString.size()));
+	PHYSFS_close(fileHandle);
+}
+
+/// Writes queued snapshots until shut down, and the queue is empty.
+static int writeWorldSnapshotThreadFunc(void *)
+{
+	while (true)
+	{
+		wzSemaphoreWait(snapshotWriterSemaphore);
+		SnapshotWriteRequest request;
+		{
+			std::lock_guard<wz::mutex> lock(snapshotWriterMutex);
+			if (snapshotWriteQueue.empty())
+			{
+				if (snapshotWritersShutDown)
+				{
+					return 0;
+				}
+				continue;
+			}
+			request = std::move(snapshotWriteQueue.front());
+			snapshotWriteQueue.pop_front();
+		}
+		writeWorldSnapshot(request);
+	}
+}
+
+void writeWorldSnapshotAsync(std::shared_ptr<const WorldSnapshot> const &snapshot, std::string const &fileName)
+{
+	ASSERT_OR_RETURN(, snapshot != nullptr, "No snapshot to write");
+	SnapshotWriteRequest request;
+	request.snapshot = snapshot;
+	request.fileName = fileName;
+
+	{
+		std::lock_guard<wz::mutex> lock(snapshotWriterMutex);
+		if (snapshotWritersShutDown)
+		{
+			return;
+		}
+		if (snapshotWriterThread == nullptr)
+		{
+			snapshotWriterSemaphore = wzSemaphoreCreate(0);
+			snapshotWriterThread = wzThreadCreate(writeWorldSnapshotThreadFunc, nullptr);
+			if (snapshotWriterThread != nullptr)
+			{
+				wzThreadStart(snapshotWriterThread);
+			}
+			else
+			{
+				wzSemaphoreDestroy(snapshotWriterSemaphore);
+				snapshotWriterSemaphore = nullptr;
+			}
+		}
+		if (snapshotWriterThread != nullptr)
+		{
+			snapshotWriteQueue.push_back(std::move(request));
+			wzSemaphorePost(snapshotWriterSemaphore);
+			return;
+		}
+	}
+	// No writer thread, so write it right away.
+	writeWorldSnapshot(request);
+}
+
+void snapshotShutdown()
+{
+	WZ_THREAD *writerThread;
+	{
+		std::lock_guard<wz::mutex> lock(snapshotWriterMutex);
+		snapshotWritersShutDown = true;
+		writerThread = snapshotWriterThread;
+		snapshotWriterThread = nullptr;
+	}
+	if (writerThread == nullptr)
+	{
+		return;
+	}
+	// Snapshots that are still queued need PhysFS, so let the writer finish them.
+	wzSemaphorePost(snapshotWriterSemaphore);
+	wzThreadJoin(writerThread);
+	wzSemaphoreDestroy(snapshotWriterSemaphore);
+	snapshotWriterSemaphore = nullptr;
+}
+
+void recordWorldSnapshot()
+{
+	if (!debugPartEnabled(LOG_SYNC))
+	{
+		return;
+	}
+
+	// Script globals are only captured for the dump, converting them every tick would be far too slow
+	WorldSnapshot const *psPrevious = snapshotHistory.empty() ? nullptr : snapshotHistory.back().get();
+	snapshotHistory.push_back(takeWorldSnapshot(psPrevious, false));
+	if (snapshotHistory.size() > SNAPSHOT_HISTORY_LENGTH)
+	{
+		snapshotHistory.pop_front();
+	}
+
+	// Only dump once per desynch, the status stays set for a while
+	if (NETcheckPlayerConnectionStatus(CONNECTIONSTATUS_DESYNC, NET_ALL_PLAYERS) && (lastDesynchDumpTime == 0 || lastDesynchDumpTime + GAME_TICKS_PER_SEC * 10 < gameTime))
+	{
+		lastDesynchDumpTime = gameTime;
+		snapshotHistory.back() = takeWorldSnapshot(snapshotHistory.back().get(), true);
+		for (auto const &snapshot : snapshotHistory)
+		{
+			writeWorldSnapshotAsync(snapshot, astringf("logs/snapshot%u_p%u.json", snapshot->gameTime, selectedPlayer));
+		}
+		debug(LOG_WARNING, "Desynch detected, wrote the last %zu game state snapshots to logs/snapshot*_p%u.json", snapshotHistory.size(), selectedPlayer);
+	}
+}
+
+void clearWorldSnapshots()
+{
+	snapshotHistory.clear();
+	lastDesynchDumpTime = 0;
+}
@@ -0,0 +1,112 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2020  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file snapshot.h
+ *  Immutable captures of the synchronised game state.
+ *
+ *  A snapshot is taken on the main thread between game ticks, without stopping the game clock.
+ *  Its parts are shared with the previous snapshot wherever they didn't change (copy-on-write),
+ *  so keeping a history of snapshots is cheap, and a snapshot may be written out from any thread.
+ */
+
+#ifndef __INCLUDED_SRC_SNAPSHOT_H__
+#define __INCLUDED_SRC_SNAPSHOT_H__
+
+#include "lib/framework/frame.h"
+#include "lib/framework/wzconfig.h"
+#include "objectdef.h"
+#include "researchdef.h"
+
+#include <memory>
+#include <vector>
+
+/// The synchronised state of a single droid, structure or feature.
+struct SnapshotObject
+{
+	uint32_t id;
+	OBJECT_TYPE type;
+	uint8_t player;
+	Position pos;
+	Rotation rot;
+	uint32_t body;
+	uint32_t experience;        ///< Droids only
+	uint32_t secondaryOrder;    ///< Droids only
+	int order;                  ///< DroidOrderType for droids, STRUCT_STATES for structures
+	int action;                 ///< DROID_ACTION for droids
+	uint32_t orderTargetId;     ///< Id of the order target, or of the structure's first weapon target
+	uint32_t actionTargetId;    ///< Id of the first action target
+	uint32_t buildPoints;       ///< Structures only
+
+	bool operator ==(SnapshotObject const &b) const;
+	bool operator !=(SnapshotObject const &b) const { return !(*this == b); }
+};
+
+/// The synchronised state of a map tile.
+struct SnapshotTile
+{
+	int32_t height;
+	uint16_t texture;
+	uint8_t tileInfoBits;
+	uint16_t fireEndTime;
+	PlayerMask tileExploredBits;
+
+	bool operator ==(SnapshotTile const &b) const;
+	bool operator !=(SnapshotTile const &b) const { return !(*this == b); }
+};
+
+struct WorldSnapshot
+{
+	/// Map tiles are stored in square blocks, so a snapshot only copies the blocks that changed.
+	static const int TILE_BLOCK_SIZE = 16;
+	typedef std::vector<SnapshotTile> TileBlock;
+	typedef std::vector<PLAYER_RESEARCH> ResearchList;
+
+	uint32_t gameTime = 0;
+	int mapWidth = 0;
+	int mapHeight = 0;
+	std::vector<std::shared_ptr<const SnapshotObject>> objects;      ///< Sorted by id
+	std::vector<std::shared_ptr<const TileBlock>> tileBlocks;       ///< Row-major blocks of TILE_BLOCK_SIZE² tiles
+	std::vector<int64_t> power;                                     ///< Precise power of each player
+	std::vector<std::shared_ptr<const ResearchList>> research;      ///< Research state of each player
+	std::shared_ptr<const nlohmann::json> scriptGlobals;            ///< Globals of all script instances
+
+	/// Checksum over all of the captured state, to quickly tell whether two snapshots differ.
+	uint32_t checksum() const;
+	nlohmann::json toJson() const;
+};
+
+/// Captures the current game state. Parts that are unchanged since psPrevious are shared with it.
+/// Script globals are slow to convert, without includeScriptGlobals those of psPrevious are kept.
+/// Must be called on the main thread, outside of a game state update.
+std::shared_ptr<const WorldSnapshot> takeWorldSnapshot(WorldSnapshot const *psPrevious = nullptr, bool includeScriptGlobals = true);
+
+/// Writes the snapshot as JSON to fileName (relative to the write directory) on the snapshot writer thread.
+void writeWorldSnapshotAsync(std::shared_ptr<const WorldSnapshot> const &snapshot, std::string const &fileName);
+/// Writes the snapshots that are still queued and stops the writer thread, must be called before PhysFS is shut down.
+void snapshotShutdown();
+
+/// Returns the ids of objects that were added, removed or changed between the two snapshots.
+std::vector<uint32_t> diffWorldSnapshots(WorldSnapshot const &a, WorldSnapshot const &b);
+
+/// Keeps a short history of per-tick snapshots while sync debugging is enabled, and writes it
+/// to the logs directory once a desynch is detected. Call once at the end of each game state update.
+void recordWorldSnapshot();
+/// Forgets the snapshot history, e.g. when a game ends.
+void clearWorldSnapshots();
+
+#endif // __INCLUDED_SRC_SNAPSHOT_H__
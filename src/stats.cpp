@@ -39,6 +39,7 @@
 #include "lib/sound/audio_id.h"
 #include "projectile.h"
 #include "text.h"
+#include "component.h"
 #include <unordered_map>
 
 #define WEAPON_TIME		100
@@ -168,6 +169,7 @@ void statsInitVars()
 /*Deallocate all the stats assigned from input data*/
 bool statsShutDown()
 {
+	clearDroidLayouts();
 	lookupStatPtr.clear();
 	lookupStructStatPtr.clear();
 	lookupCompStatPtr.clear();
@@ -837,7 +837,7 @@ void structureBuild(STRUCTURE *psStruct, DROID *psDroid, int buildPoints, int bu
 					objTrace(psIter->id, "Construction order %s complete (%d, %d -> %d, %d)", getDroidOrderName(psDroid->order.type),
 					         psIter->order.pos2.x, psIter->order.pos.y, psIter->order.pos2.x, psIter->order.pos2.y);
 					psIter->action = DACTION_NONE;
-					psIter->order = DroidOrder(DORDER_NONE);
+					setDroidOrder(psIter, DroidOrder(DORDER_NONE));
 					setDroidActionTarget(psIter, nullptr, 0);
 				}
 			}
@@ -851,6 +851,7 @@ void structureBuild(STRUCTURE *psStruct, DROID *psDroid, int buildPoints, int bu
 	{
 		STRUCT_STATES prevStatus = psStruct->status;
 		psStruct->status = SS_BEING_BUILT;
+		gridMarkRepairable(psStruct);
 		if (prevStatus == SS_BUILT)
 		{
 			// Starting to demolish.
@@ -1458,7 +1459,7 @@ STRUCTURE *buildStructureDir(STRUCTURE_STATS *pStructureType, UDWORD x, UDWORD y
 			psBuilding->asWeaps[i].rot.roll = 0;
 			psBuilding->asWeaps[i].prevRot = psBuilding->asWeaps[i].rot;
 			psBuilding->asWeaps[i].origin = ORIGIN_UNKNOWN;
-			psBuilding->psTarget[i] = nullptr;
+			setStructureTarget(psBuilding, nullptr, i, ORIGIN_UNKNOWN);
 		}
 
 		psBuilding->periodicalDamageStart = 0;
@@ -1721,6 +1722,7 @@ STRUCTURE *buildStructureDir(STRUCTURE_STATS *pStructureType, UDWORD x, UDWORD y
 			psBuilding->currentBuildPts = 0;
 			//start building again
 			psBuilding->status = SS_BEING_BUILT;
+			gridMarkRepairable(psBuilding);
 			psBuilding->buildRate = 1;  // Don't abandon the structure first tick, so set to nonzero.
 			if (psBuilding->player == selectedPlayer && !FromSave)
 			{
@@ -2936,7 +2938,7 @@ static void aiUpdateStructure(STRUCTURE *psStructure, bool isMission)
 					{
 						// Hey, droid, it's your turn! Stop what you're doing and get ready to get repaired!
 						psDroid->action = DACTION_WAITFORREPAIR;
-						psDroid->order.psObj = psStructure;
+						setDroidTarget(psDroid, psStructure);
 					}
 					objTrace(psStructure->id, "Chose to repair droid %d", (int)psDroid->id);
 					objTrace(psDroid->id, "Chosen to be repaired by repair structure %d", (int)psStructure->id);
@@ -3810,6 +3812,7 @@ STRUCTURE::STRUCTURE(uint32_t id, unsigned player)
 	pos = Vector3i(0, 0, 0);
 	rot = Vector3i(0, 0, 0);
 	capacity = 0;
+	std::fill_n(psTarget, MAX_WEAPONS, nullptr);
 }
 
 /* Release all resources associated with a structure */
@@ -3820,6 +3823,11 @@ STRUCTURE::~STRUCTURE()
 
 	STRUCTURE *psBuilding = this;
 
+	for (unsigned i = 0; i < MAX_WEAPONS; ++i)
+	{
+		setStructureTarget(psBuilding, nullptr, i, ORIGIN_UNKNOWN);
+	}
+
 	// free up the space used by the functionality array
 	free(psBuilding->pFunctionality);
 	psBuilding->pFunctionality = nullptr;
@@ -6637,12 +6645,17 @@ STRUCTURE *giftSingleStructure(STRUCTURE *psStructure, UBYTE attackPlayer, bool
 				orderClearTargetFromDroidList(psCurr, psStructure);
 			}
 
-			//check through the 'attackPlayer' players list of structures to see if any are targetting it
-			for (psStruct = apsStructLists[attackPlayer]; psStruct != nullptr; psStruct = psStruct->psNext)
+			//check through the 'attackPlayer' players structures that are targetting it
+			std::vector<BASE_OBJECT *> referrers = psStructure->psReferrers;  // Copy, since clearing the targets changes the list.
+			for (BASE_OBJECT *psReferrer : referrers)
 			{
-				if (psStruct->psTarget[0] == psStructure)
+				if (psReferrer->type == OBJ_STRUCTURE && psReferrer->player == attackPlayer)
 				{
-					setStructureTarget(psStruct, nullptr, 0, ORIGIN_UNKNOWN);
+					psStruct = (STRUCTURE *)psReferrer;
+					if (psStruct->psTarget[0] == psStructure)
+					{
+						setStructureTarget(psStruct, nullptr, 0, ORIGIN_UNKNOWN);
+					}
 				}
 			}
 
@@ -365,6 +365,7 @@ static inline void _setStructureTarget(STRUCTURE *psBuilding, BASE_OBJECT *psNew
 {
 	ASSERT_OR_RETURN(, idx < MAX_WEAPONS, "Bad index");
 	ASSERT_OR_RETURN(, psNewTarget == nullptr || !psNewTarget->died, "setStructureTarget set dead target");
+	objChangeReference(psBuilding, psBuilding->psTarget[idx], psNewTarget);
 	psBuilding->psTarget[idx] = psNewTarget;
 	psBuilding->asWeaps[idx].origin = targetOrigin;
 #ifdef DEBUG
@@ -54,6 +54,7 @@
 #include "display3d.h"
 #include "hci.h"
 #include "loop.h"
+#include "lighting.h"
 
 /**
  * A sector contains all information to draw a square piece of the map.
@@ -534,6 +535,7 @@ void markTileDirty(int i, int j)
 {
 	int x, y;
 
+	markLightingDirty(i, j);
 	if (!terrainInitialised)
 	{
 		return; // will be updated anyway
@@ -1125,7 +1127,29 @@ static void drawDepthOnly(const glm::mat4 &ModelViewProjection, const glm::vec4
 	gfx_api::context::get().unbind_index_buffer(*geometryIndexVBO);
 }
 
-static void drawTerrainLayers(const glm::mat4 &ModelViewProjection, const glm::vec4 &paramsXLight, const glm::vec4 &paramsYLight, const glm::mat4 &textureMatrix)
+/// Collects the dynamic lights of this frame for the terrain shaders, which add them to the lightmap
+static gfx_api::dynamic_lights getDynamicLights()
+{
+	gfx_api::dynamic_lights lights;
+	std::vector<LIGHT> frameLights = getStrongestLights(gfx_api::max_dynamic_lights);
+	for (size_t i = 0; i < gfx_api::max_dynamic_lights; ++i)
+	{
+		if (i < frameLights.size())
+		{
+			LIGHT const &light = frameLights[i];
+			lights.position_range[i] = glm::vec4(light.position.x, light.position.y, -light.position.z, light.range);
+			lights.colour[i] = glm::vec4(light.colour.byte.r / 255.f, light.colour.byte.g / 255.f, light.colour.byte.b / 255.f, 1.f);
+		}
+		else
+		{
+			lights.position_range[i] = glm::vec4(0.f);
+			lights.colour[i] = glm::vec4(0.f);
+		}
+	}
+	return lights;
+}
+
+static void drawTerrainLayers(const glm::mat4 &ModelViewProjection, const glm::vec4 &paramsXLight, const glm::vec4 &paramsYLight, const glm::mat4 &textureMatrix, const gfx_api::dynamic_lights &lights)
 {
 	const auto &renderState = getCurrentRenderState();
 	const glm::vec4 fogColor(
@@ -1149,7 +1173,7 @@ static void drawTerrainLayers(const glm::mat4 &ModelViewProjection, const glm::v
 	{
 		const glm::vec4 paramsX(0, 0, -1.0f / world_coord(psGroundTypes[layer].textureSize), 0 );
 		const glm::vec4 paramsY(1.0f / world_coord(psGroundTypes[layer].textureSize), 0, 0, 0 );
-		gfx_api::TerrainLayer::get().bind_constants({ ModelViewProjection, paramsX, paramsY, paramsXLight, paramsYLight, glm::mat4(1.f), textureMatrix,
+		gfx_api::TerrainLayer::get().bind_constants({ ModelViewProjection, paramsX, paramsY, paramsXLight, paramsYLight, glm::mat4(1.f), textureMatrix, lights,
 			fogColor, renderState.fogEnabled, renderState.fogBegin, renderState.fogEnd, 0, 1 });
 
 		// load the texture
@@ -1180,7 +1204,7 @@ static void drawTerrainLayers(const glm::mat4 &ModelViewProjection, const glm::v
 	gfx_api::context::get().unbind_index_buffer(*textureIndexVBO);
 }
 
-static void drawDecals(const glm::mat4 &ModelViewProjection, const glm::vec4 &paramsXLight, const glm::vec4 &paramsYLight, const glm::mat4 &textureMatrix)
+static void drawDecals(const glm::mat4 &ModelViewProjection, const glm::vec4 &paramsXLight, const glm::vec4 &paramsYLight, const glm::mat4 &textureMatrix, const gfx_api::dynamic_lights &lights)
 {
 	const auto &renderState = getCurrentRenderState();
 	const glm::vec4 fogColor(
@@ -1192,7 +1216,7 @@ static void drawDecals(const glm::mat4 &ModelViewProjection, const glm::vec4 &pa
 	gfx_api::TerrainDecals::get().bind();
 	gfx_api::TerrainDecals::get().bind_textures(&pie_Texture(terrainPage), lightmap_tex_num);
 	gfx_api::TerrainDecals::get().bind_vertex_buffers(decalVBO);
-	gfx_api::TerrainDecals::get().bind_constants({ ModelViewProjection, paramsXLight, paramsYLight, textureMatrix,
+	gfx_api::TerrainDecals::get().bind_constants({ ModelViewProjection, paramsXLight, paramsYLight, textureMatrix, lights,
 		fogColor, renderState.fogEnabled, renderState.fogBegin, renderState.fogEnd, 0, 1 });
 
 	int size = 0;
@@ -1252,6 +1276,7 @@ void drawTerrain(const glm::mat4 &mvp)
 
 	// shift the lightmap half a tile as lights are supposed to be placed at the center of a tile
 	const glm::mat4 lightMatrix = glm::translate(glm::vec3(1.f / (float)lightmapWidth / 2, 1.f / (float)lightmapHeight / 2, 0.f));
+	const gfx_api::dynamic_lights lights = getDynamicLights();
 
 	//////////////////////////////////////
 	// canvas to draw on
@@ -1259,11 +1284,11 @@ void drawTerrain(const glm::mat4 &mvp)
 
 	///////////////////////////////////
 	// terrain
-	drawTerrainLayers(mvp, paramsXLight, paramsYLight, lightMatrix);
+	drawTerrainLayers(mvp, paramsXLight, paramsYLight, lightMatrix, lights);
 
 	//////////////////////////////////
 	// decals
-	drawDecals(mvp, paramsXLight, paramsYLight, lightMatrix);
+	drawDecals(mvp, paramsXLight, paramsYLight, lightMatrix, lights);
 }
 
 /**
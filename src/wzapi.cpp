@@ -584,6 +584,7 @@ bool wzapi::setHealth(WZAPI_PARAMS(BASE_OBJECT* psObject, int health)) MULTIPLAY
 		SCRIPT_ASSERT(false, context, psFeat, "No such feature id %d belonging to player %d", id, player);
 		psFeat->body = health * psFeat->psStats->body / 100;
 	}
+	gridMarkRepairable(psObject);
 	return true;
 }
 
@@ -2899,10 +2900,10 @@ wzapi::no_return_value wzapi::setScrollLimits(WZAPI_PARAMS(int x1, int y1, int x
 	scrollMaxY = maxY;
 
 	// When the scroll limits change midgame - need to redo the lighting
-	initLighting(prevMinX < scrollMinX ? prevMinX : scrollMinX,
-	             prevMinY < scrollMinY ? prevMinY : scrollMinY,
-	             prevMaxX < scrollMaxX ? prevMaxX : scrollMaxX,
-	             prevMaxY < scrollMaxY ? prevMaxY : scrollMaxY);
+	updateLighting(prevMinX < scrollMinX ? prevMinX : scrollMinX,
+	               prevMinY < scrollMinY ? prevMinY : scrollMinY,
+	               prevMaxX < scrollMaxX ? prevMaxX : scrollMaxX,
+	               prevMaxY < scrollMaxY ? prevMaxY : scrollMaxY);
 
 	// need to reset radar to take into account of new size
 	resizeRadar();